@@ -1,4 +1,4 @@
-QT += core gui widgets svg
+QT += core gui widgets svg concurrent
 
 VERSION = 0.1
 
@@ -38,12 +38,27 @@ SOURCES += \
     src/sources/TreeVisGraphicsView.cpp \
     src/sources/FullTreeView.cpp \
     src/sources/PolicyVisualiserView.cpp \
-    src/sources/NumSortTreeWidgetItem.cpp \
+    src/sources/JointObservationModel.cpp \
     src/sources/JointObservationSelectionDialog.cpp \
     src/sources/PreviousPlanWizard.cpp \
     src/sources/TreeVisGraphicsScene.cpp \
     src/sources/SettingsDialog.cpp \
-    src/sources/GeneralUtils.cpp
+    src/sources/GeneralUtils.cpp \
+    src/sources/TreeLayout.cpp \
+    src/sources/FullTreeBuilder.cpp \
+    src/sources/PolicyGraph.cpp \
+    src/sources/TreeExporter.cpp \
+    src/sources/BatchExporter.cpp \
+    src/sources/SparseModelSupport.cpp \
+    src/sources/BeliefTracker.cpp \
+    src/sources/TreeOverviewWidget.cpp \
+    src/sources/PlannerTiming.cpp \
+    src/sources/SyntheticGenerator.cpp \
+    src/sources/FrameStatsOverlay.cpp \
+    src/sources/TraceRecorder.cpp \
+    src/sources/PlanWorker.cpp \
+    src/sources/PlanCostEstimator.cpp \
+    src/sources/Planner.cpp
 
 # Headers for TreeVis
 HEADERS += \
@@ -61,9 +76,44 @@ HEADERS += \
     src/headers/FullTreeView.h \
     src/headers/PolicyVisualiserView.h \
     src/headers/UIMainWindow.h \
-    src/headers/NumSortTreeWidgetItem.h \
+    src/headers/JointObservationModel.h \
     src/headers/JointObservationSelectionDialog.h \
     src/headers/PreviousPlanWizard.h \
     src/headers/TreeVisGraphicsScene.h \
     src/headers/SettingsDialog.h \
-    src/headers/GeneralUtils.h
\ No newline at end of file
+    src/headers/GeneralUtils.h \
+    src/headers/AgentPolicy.h \
+    src/headers/TreeLayout.h \
+    src/headers/FullTreeBuilder.h \
+    src/headers/PolicyGraph.h \
+    src/headers/TreeExporter.h \
+    src/headers/BatchExporter.h \
+    src/headers/SparseModelSupport.h \
+    src/headers/BeliefTracker.h \
+    src/headers/StyleRule.h \
+    src/headers/TreeOverviewWidget.h \
+    src/headers/PlannerTiming.h \
+    src/headers/SyntheticGenerator.h \
+    src/headers/FrameStatsOverlay.h \
+    src/headers/TraceRecorder.h \
+    src/headers/PlanWorker.h \
+    src/headers/PlanCostEstimator.h
+
+# Benchmarks, built with qmake CONFIG+=benchmark into a separate binary
+benchmark {
+    TARGET = MADP-TreeVis-benchmark
+    DEFINES += TREEVIS_BENCHMARK
+
+    MOC_DIR = ./build/benchmark/moc
+    OBJECTS_DIR = ./build/benchmark/obj
+
+    SOURCES += \
+        src/sources/RenderBenchmark.cpp \
+        src/sources/PolicyBenchmark.cpp \
+        src/sources/PlannerBenchmark.cpp
+
+    HEADERS += \
+        src/headers/RenderBenchmark.h \
+        src/headers/PolicyBenchmark.h \
+        src/headers/PlannerBenchmark.h
+}
\ No newline at end of file
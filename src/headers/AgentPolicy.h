@@ -0,0 +1,51 @@
+#ifndef AGENTPOLICY_H
+#define AGENTPOLICY_H
+
+// Qt
+#include <QString>
+
+#include <vector>
+#include <functional>
+
+/// To match MADP
+typedef unsigned int Index;
+
+///
+/// \brief The AgentPolicy struct holds everything needed to draw the
+/// individual policy of a single agent: the names of its actions
+/// and observations and a lookup from an observation history index
+/// to the action index the policy specifies. This allows the tree
+/// visualisations to be built without holding the planning unit.
+///
+struct AgentPolicy {
+	/// The zero indexed agent index the policy is for
+	Index agentIndex = 0;
+
+	/// The horizon of the policy
+	Index horizon = 0;
+
+	/// The name of each action of the agent, indexed by action index
+	std::vector<QString> actionNames;
+
+	/// The name of each observation of the agent, indexed by observation index
+	std::vector<QString> observationNames;
+
+	/// Gets the action index specified by the policy for an observation history index
+	std::function<Index(Index)> GetActionIndex;
+
+	/// \return The number of observations the agent has
+	size_t GetNrObservations() const {
+		return observationNames.size();
+	}
+
+	///
+	/// \brief Gets the name of the action taken at the observation history index
+	/// \param ohIndex The observation history index
+	/// \return The name of the action specified by the policy
+	///
+	const QString& GetActionName(const Index &ohIndex) const {
+		return actionNames[GetActionIndex(ohIndex)];
+	}
+};
+
+#endif // AGENTPOLICY_H
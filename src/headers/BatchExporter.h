@@ -0,0 +1,155 @@
+#ifndef BATCHEXPORTER_H
+#define BATCHEXPORTER_H
+
+// TreeVis
+#include "PlannerManager.h"
+
+// Qt
+#include <QString>
+#include <QStringList>
+
+// Smart pointers
+#include <memory>
+#include <atomic>
+
+///
+/// \brief The BatchExporter class exports the full tree of every agent
+/// and a sampled trajectory for many saved policies without showing
+/// a window, for generating reports from the command line. The problem
+/// is checked once before any policy is loaded. Policies are loaded in
+/// turn, as the MADP parser is not known to be thread safe, and only the
+/// images are drawn in parallel, a batch at a time so the number of
+/// problems held in memory is bounded by the number of threads.
+///
+/// Run with:
+/// MADP-TreeVis --export --problem <file.dpomdp> [--output <dir>]
+///              [--format svg|png] [--seed <n>] <policy files...>
+///
+class BatchExporter {
+
+	public:
+		/// The formats images can be exported to
+		enum imageFormat {
+			SVG,
+			PNG
+		};
+
+		///
+		/// \brief Constructor
+		/// \param problemFilePath The path of the problem the policies are for
+		/// \param outputDirectory The directory to write the images to
+		/// \param format The format of the images
+		///
+		BatchExporter(const QString &problemFilePath,
+					  const QString &outputDirectory,
+					  const imageFormat &format);
+		~BatchExporter();
+
+		///
+		/// \brief Loads and exports every policy. Each policy produces an
+		/// image named <policy>_agent<n> for each agent and
+		/// <policy>_trajectory for the sampled trajectory
+		/// \param policyFilePaths The paths of the policies to export
+		/// \return The number of policies that failed to load or export,
+		/// -1 if the problem could not be read
+		///
+		int Run(const QStringList &policyFilePaths);
+
+		///
+		/// \brief Checks if the application was started to export
+		/// \param argc Number of command line arguments
+		/// \param argv Command line arguments
+		/// \return True if --export was given
+		///
+		static bool IsRequested(int argc, char** argv);
+
+		///
+		/// \brief Parses the command line and runs the export, the
+		/// application must already be created
+		/// \param arguments The application arguments
+		/// \return The exit code for the application
+		///
+		static int RunFromCommandLine(const QStringList &arguments);
+
+	private:
+		/// A policy being exported
+		struct PolicyJob {
+			/// Path of the policy file
+			QString policyFilePath;
+			/// Manager the policy is read in to
+			std::unique_ptr<PlannerManager> manager;
+			/// If the policy was read in successfully
+			bool loaded = false;
+			/// If every image for the policy was written, cleared by the drawing threads
+			std::atomic<bool> exported{true};
+			/// Reason reading in the policy failed
+			QString errorMessage;
+			/// Sampled joint action at each stage
+			std::vector<Index> jointActions;
+			/// Sampled joint observation at each stage, the first unused
+			std::vector<Index> jointObservations;
+		};
+
+		///
+		/// \brief Reads in the problem once, so a missing or invalid problem
+		/// fails the export rather than every policy
+		/// \param message Set to why the problem could not be read
+		/// \return False if the problem could not be read
+		///
+		bool CheckProblem(QString &message) const;
+
+		///
+		/// \brief Reads in a policy, catching what the problem throws
+		/// \param job The policy, loaded and errorMessage are set
+		///
+		void LoadPolicy(PolicyJob &job) const;
+
+		///
+		/// \brief Samples a trajectory of the joint policy from a sampled
+		/// initial state. Sampling draws from the one rand() state, so is
+		/// done for each policy in turn to keep a seed's trajectories the same
+		/// \param job The loaded policy, given the trajectory
+		///
+		void SampleTrajectory(PolicyJob &job) const;
+
+		///
+		/// \brief Exports the full tree of an agent
+		/// \param job The loaded policy
+		/// \param agentIndex The agent to export the tree for
+		/// \return True if the image was written
+		///
+		bool ExportFullTree(const PolicyJob &job, const Index &agentIndex) const;
+
+		///
+		/// \brief Exports the sampled trajectory of a policy as the policy
+		/// visualiser shows it
+		/// \param job The loaded policy, with its trajectory sampled
+		/// \return True if the image was written
+		///
+		bool ExportTrajectory(const PolicyJob &job) const;
+
+		///
+		/// \brief Gets the path to write an image to
+		/// \param job The policy the image is for
+		/// \param suffix Added to the name of the policy file
+		/// \return The path in the output directory with the right extension
+		///
+		QString GetOutputPath(const PolicyJob &job, const QString &suffix) const;
+
+		/// The problem file the policies are for
+		QString problemFile;
+
+		/// Where the images are written
+		QString outputDir;
+
+		/// The format of the images
+		imageFormat imageType;
+
+		/// The space between nodes, as in the full tree view
+		const int paddingBetweenNodes = 20;
+
+		/// The space between agents in the trajectory, as in the policy visualiser
+		const int paddingBetweenAgents = 75;
+};
+
+#endif // BATCHEXPORTER_H
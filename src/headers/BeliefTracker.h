@@ -0,0 +1,74 @@
+#ifndef BELIEFTRACKER_H
+#define BELIEFTRACKER_H
+
+// TreeVis
+#include "SparseModelSupport.h"
+
+#include <vector>
+
+///
+/// \brief The BeliefTracker class maintains the joint belief over the
+/// states of a problem along a joint action observation history. The
+/// belief is held as a sparse vector of the states with non-zero
+/// probability, and each update only visits the successor states of
+/// those states, so the cost of a step follows the size of the belief
+/// rather than the number of states in the problem.
+///
+class BeliefTracker {
+
+	public:
+		///
+		/// \brief Constructor, the belief starts as the initial
+		/// state distribution of the problem
+		/// \param decpomdp The problem, must outlive this object
+		/// \param modelSupport The support of the models of the problem,
+		/// must outlive this object
+		///
+		BeliefTracker(const DecPOMDPDiscreteInterface* decpomdp,
+					  const SparseModelSupport* modelSupport);
+		~BeliefTracker();
+
+		/// Resets the belief to the initial state distribution
+		void Reset();
+
+		///
+		/// \brief Updates the belief after the joint action was taken
+		/// and the joint observation was recieved:
+		/// b'(s') = P(jo|s,ja,s') P(s'|s,ja) b(s) normalised over s'
+		/// \param jointActionIndex The joint action taken
+		/// \param jointObservationIndex The joint observation recieved
+		/// \return False if the joint observation is not possible
+		/// under the belief, the belief is then left empty
+		///
+		bool Update(const Index &jointActionIndex, const Index &jointObservationIndex);
+
+		/// \return The states with non-zero probability and their probability
+		const SparseModelSupport::SparseVector& GetBelief() const;
+
+		///
+		/// \brief Gets the most likely states of the belief
+		/// \param k The maximum number of states to get
+		/// \return Up to k states, most likely first
+		///
+		SparseModelSupport::SparseVector GetTopStates(const size_t &k) const;
+
+	private:
+		/// The problem the belief is over
+		const DecPOMDPDiscreteInterface* problem;
+
+		/// Support of the models of the problem
+		const SparseModelSupport* support;
+
+		/// The current belief
+		SparseModelSupport::SparseVector belief;
+
+		/// \brief Probability of each state during an update, indexed by
+		/// state. Kept between updates and only the touched entries are
+		/// cleared, so it is allocated once.
+		std::vector<double> accumulator;
+
+		/// The states given probability during the current update
+		std::vector<Index> touchedStates;
+};
+
+#endif // BELIEFTRACKER_H
@@ -26,6 +26,13 @@ class DICEPlanner : public Planner {
 		/// \param args The arguments to use to plan with.
 		///
 		void Plan(ArgumentHandlers::Arguments args);
+
+		///
+		/// \brief Gets the parameters the planning unit is created with
+		/// \param args The arguments planned with
+		/// \return The parameters
+		///
+		PlanningUnitMADPDiscreteParameters GetParameters(const ArgumentHandlers::Arguments &args) const;
 };
 
 #endif // DICEPSPLANNER_H
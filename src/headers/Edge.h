@@ -6,7 +6,8 @@
 
 // Qt
 #include <QGraphicsLineItem>
-#include <QGraphicsSimpleTextItem>
+#include <QFontMetricsF>
+#include <QPen>
 
 #include <iostream>
 
@@ -15,6 +16,26 @@ class Node;
 /// The thickness of the edge
 const static qreal edgeThickness = 3.0;
 
+/// \brief Below this zoom level of detail the text of edge labels
+/// and nodes is not drawn
+const static qreal labelLevelOfDetail = 0.4;
+
+///
+/// \brief Where an edge and its label are drawn relative to the node
+/// the edge is from. Edges with the same offset between their nodes and
+/// the same label share the same geometry, so it can be computed once.
+///
+struct EdgeGeometry {
+	/// The line, starting at (0, 0)
+	QLineF line;
+
+	/// Size of the label text in the current font
+	QSizeF labelSize;
+
+	/// Places the label on the centre of the line
+	QTransform labelTransform;
+};
+
 ///
 /// \brief The Edge class represents an undirected edge
 /// between two nodes in a scene. The edge will be drawn
@@ -36,6 +57,18 @@ class Edge : public QGraphicsLineItem {
 		/// Alternate constructor that takes a std::string
 		Edge(Node* from, Node* to, const std::string& labelText = "", const double& obvsProb = 0);
 
+		///
+		/// \brief Constructor for an edge with geometry already computed,
+		/// such as one shared by the edges on a level of a tree
+		/// \param from The node the edge is from
+		/// \param to The node the edge will go to
+		/// \param labelText The label of the edge
+		/// \param geometry The geometry from GetGeometry() for the nodes and label
+		/// \param obvsProb The observation probability of the edge
+		///
+		Edge(Node* from, Node* to, const QString &labelText,
+			 const EdgeGeometry &geometry, const double& obvsProb = 0);
+
 		///
 		~Edge();
 
@@ -45,6 +78,43 @@ class Edge : public QGraphicsLineItem {
 		///
 		void UpdatePosition();
 
+		///
+		/// \brief Moves the edge to the node it is from and sets geometry
+		/// computed beforehand, rather than working it out from the nodes
+		/// \param geometry The geometry from GetGeometry() for the nodes and label
+		///
+		void SetGeometry(const EdgeGeometry &geometry);
+
+		///
+		/// \brief Paints the line and label with the current colours of the
+		/// edge, so a colour change only needs a repaint rather than a new pen.
+		/// The label is left out when zoomed out too far to read it
+		/// \param painter Painter provided by Qt
+		/// \param option Used for the level of detail
+		/// \param widget Unused
+		///
+		void paint(QPainter* painter,
+				   const QStyleOptionGraphicsItem* option,
+				   QWidget* widget);
+
+		///
+		/// \brief Bounding rect implementation for QGraphicsItem
+		/// \return The bounding rect of the line and label
+		///
+		QRectF boundingRect() const;
+
+		///
+		/// \brief Shape implementation for QGraphicsItem
+		/// \return The path of the line and label, so the label can be clicked
+		///
+		QPainterPath shape() const;
+
+		///
+		/// \brief Updates the edge after the font has changed. Colours are
+		/// read when painting so only need a repaint.
+		///
+		void RefreshStyle();
+
 		///
 		/// \brief ChangeColourToMatchProbability
 		/// Colours the edge to the probability field based on
@@ -57,17 +127,41 @@ class Edge : public QGraphicsLineItem {
 		///
 		/// \brief SetEdgeColour
 		/// Changes the edges colour to the given one
-		/// \param newColour The colour to set the edge to
+		/// \param newColour The colour to set the edge to,
+		/// invalid to use the default
 		///
 		void SetEdgeColour(const QColor &newColour);
 
 		///
 		/// \brief SetTextColour
 		/// Changes the text colour to the given one
-		/// \param newColour The colour to set the text to
+		/// \param newColour The colour to set the text to,
+		/// invalid to use the default
 		///
 		void SetTextColour(const QColor &newColour);
 
+		/// \return The node the edge goes from
+		Node* GetFromNode() const;
+
+		/// \return The node the edge goes to
+		Node* GetToNode() const;
+
+		/// \return The text of the label, empty if there is no label
+		QString GetLabelText() const;
+
+		/// \return The size of the label text, empty if there is no label
+		QSizeF GetLabelSize() const;
+
+		/// \return The pen to draw the line with based on the colours of the edge
+		QPen GetPen() const;
+
+		///
+		/// \brief Sets whether the scene draws the line of the edge in a batch
+		/// with the other edges, the edge then only draws its label
+		/// \param drawnByScene True if the scene draws the line
+		///
+		void SetLineDrawnByScene(const bool &drawnByScene);
+
 		///
 		/// \brief Sets the default colour of the edge to the given colour
 		/// \param newColour The colour to set the default edge colour to
@@ -92,6 +186,29 @@ class Edge : public QGraphicsLineItem {
 		///
 		static QFont GetFont();
 
+		/// \return The default edge colour
+		static QColor GetDefaultColour();
+
+		/// \return The default text colour
+		static QColor GetDefaultTextColour();
+
+		///
+		/// \brief Gets where the label of an edge is drawn, centred on and
+		/// rotated along the line so it reads from left to right
+		/// \param line The line of the edge, starting at the node it is from
+		/// \param labelSize The size of the label text
+		/// \return Transform from the labels coordinates to the lines coordinates
+		///
+		static QTransform GetLabelTransform(const QLineF &line, const QSizeF &labelSize);
+
+		///
+		/// \brief Computes the geometry of an edge in the current font
+		/// \param line The line of the edge, starting at (0, 0)
+		/// \param labelText The label of the edge
+		/// \return The geometry to pass to SetGeometry()
+		///
+		static EdgeGeometry GetGeometry(const QLineF &line, const QString &labelText);
+
 		/// Type for qgraphicsitem_cast<>
 		enum {
 			Type = UserType + 2
@@ -106,6 +223,9 @@ class Edge : public QGraphicsLineItem {
 		}
 
 	private:
+		/// \return The rect of the label in the coordinates of the edge
+		QRectF LabelRect() const;
+
 		/// The node the edge goes from
 		Node* fromNode;
 
@@ -113,16 +233,28 @@ class Edge : public QGraphicsLineItem {
 		Node* toNode;
 
 		/// The text to be displayed in the middle of the edge
-		QGraphicsSimpleTextItem* label = nullptr;
+		QString labelText;
+
+		/// Size of the label text in the current font
+		QSizeF labelSize;
+
+		/// Places the label on the centre of the line
+		QTransform labelTransform;
 
 		/// The observation probability for this edge
 		double observationProbability;
 
-		/// The colour of the edge
-		QColor edgeColour = defaultEdgeColour;
+		/// The colour of the edge, invalid to use the default
+		QColor edgeColour;
 
-		/// The colour of the text associated with the edge
-		QColor textColour = defaultTextColour;
+		/// The colour of the text associated with the edge, invalid to use the default
+		QColor textColour;
+
+		/// If the edge is currently coloured by its observation probability
+		bool colouredToProbability = false;
+
+		/// If the scene draws the line along with the other edges
+		bool lineDrawnByScene = false;
 
 		/// Default edge colour, set in settings
 		static QColor defaultEdgeColour;
@@ -132,6 +264,9 @@ class Edge : public QGraphicsLineItem {
 
 		/// Font used by all edges, set in settings
 		static QFont font;
+
+		/// Font metrics for the font
+		static QFontMetricsF fontMetrics;
 };
 
 #endif // Edge_H
@@ -0,0 +1,123 @@
+#ifndef FRAMESTATSOVERLAY_H
+#define FRAMESTATSOVERLAY_H
+
+// Qt
+#include <QWidget>
+#include <QGraphicsView>
+#include <QJsonObject>
+#include <QTimer>
+
+#include <vector>
+
+///
+/// \brief The FrameStatsOverlay class shows how the view it is drawn over
+/// is performing: the time to paint each frame, the items in the visible
+/// area against the items in the scene, the zoom and the memory held.
+/// The paint times of the last frames are kept and drawn as a histogram,
+/// which can be exported from the context menu so reports of a slow view
+/// come with numbers.
+///
+class FrameStatsOverlay : public QWidget {
+	Q_OBJECT
+
+	public:
+		///
+		/// \brief Constructor, the overlay is hidden until shown
+		/// \param graphicsView The view measured, also the parent
+		///
+		FrameStatsOverlay(QGraphicsView* graphicsView);
+		~FrameStatsOverlay();
+
+		///
+		/// \brief Records the time the view took to paint a frame
+		/// \param paintMs Milliseconds spent painting
+		///
+		void AddFrame(const double &paintMs);
+
+		/// Forgets the frames recorded, such as when the scene changes
+		void ClearFrames();
+
+		/// \return The frames, statistics and histogram as JSON
+		QJsonObject ToJson() const;
+
+	protected:
+		/// Draws the statistics and the histogram
+		void paintEvent(QPaintEvent* event);
+
+		/// Offers to export the statistics
+		void contextMenuEvent(QContextMenuEvent* event);
+
+		/// Starts refreshing the statistics
+		void showEvent(QShowEvent* event);
+
+		/// Stops refreshing the statistics
+		void hideEvent(QHideEvent* event);
+
+	private slots:
+		/// \brief Counts the items in view and reads the memory again,
+		/// too slow to do on every frame of a large scene
+		void Refresh();
+
+		/// Asks for a file and writes the statistics to it as JSON
+		void Export();
+
+	private:
+		///
+		/// \brief Gets the paint time below which a fraction of the frames are
+		/// \param fraction The fraction, 0.5 for the median
+		/// \return The time in milliseconds, 0 without frames
+		///
+		double Percentile(const double &fraction) const;
+
+		/// \return The number of frames in each histogram bin
+		std::vector<int> HistogramCounts() const;
+
+		/// The view measured
+		QGraphicsView* view;
+
+		/// Paint times of the last frames, oldest overwritten first
+		std::vector<double> frameTimes;
+
+		/// Where the next frame time is written
+		size_t nextFrame = 0;
+
+		/// Frames recorded since cleared, including those overwritten
+		long long totalFrames = 0;
+
+		/// Items intersecting the visible area at the last refresh
+		int itemsInView = 0;
+
+		/// Items in the scene at the last refresh
+		int totalItems = 0;
+
+		/// Rough size of the items in the scene in bytes
+		size_t sceneMemory = 0;
+
+		/// Resident memory of the process in bytes
+		size_t residentMemory = 0;
+
+		/// Redraws the overlay with fresh statistics
+		QTimer* refreshTimer;
+
+		/// Number of frames kept
+		static const int framesKept = 600;
+
+		/// Time between refreshes in milliseconds
+		static const int refreshInterval = 250;
+
+		/// Upper bounds of the histogram bins in milliseconds, the last bin is everything above
+		static const std::vector<double> binBounds;
+
+		/// \brief Bytes Qt holds for each item beyond the item class itself,
+		/// the private item data and the entry in the scene index
+		static const int itemOverhead = 350;
+
+		/// Size of the overlay
+		static const int overlayWidth = 260;
+		static const int overlayHeight = 190;
+
+		/// Space between the overlay and the edge of the view
+		static const int overlayMargin = 10;
+};
+
+#endif // FRAMESTATSOVERLAY_H
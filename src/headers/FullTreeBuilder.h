@@ -0,0 +1,118 @@
+#ifndef FULLTREEBUILDER_H
+#define FULLTREEBUILDER_H
+
+// TreeVis
+#include "AgentPolicy.h"
+#include "TreeLayout.h"
+#include "TreeVisGraphicsScene.h"
+#include "Node.h"
+
+// Smart pointers
+#include <memory>
+
+///
+/// \brief The FullTreeBuilder class builds the full tree of an
+/// agents policy into a scene on demand. Only the levels
+/// requested are created, further levels are created when a node
+/// is expanded and removed when it is collapsed, so the number of
+/// items in the scene is proportional to what has been explored
+/// rather than the size of the whole policy.
+///
+class FullTreeBuilder {
+
+	public:
+		///
+		/// \brief Constructor computes the layout for the policy
+		/// \param agentPolicy The policy to build the tree for
+		/// \param treeScene The scene to add the nodes and edges to
+		/// \param nodePadding The space between nodes on the bottom level
+		///
+		FullTreeBuilder(const AgentPolicy &agentPolicy,
+						TreeVisGraphicsScene* treeScene,
+						const qreal &nodePadding);
+		~FullTreeBuilder();
+
+		///
+		/// \brief Creates the root node and the levels below it
+		/// \param levels The number of levels to create, including the root
+		///
+		void Build(const Index &levels);
+
+		///
+		/// \brief Creates the children of the node and the levels below them
+		/// \param node The node to expand
+		/// \param levels The number of levels below the node to create
+		///
+		void Expand(Node* node, const Index &levels);
+
+		///
+		/// \brief Removes all nodes and edges below the node
+		/// \param node The node to collapse
+		///
+		void Collapse(Node* node);
+
+		///
+		/// \brief Builds the nodes along the path from the root to an
+		/// observation history, expanding only the nodes on the path.
+		/// Build() must have been called first.
+		/// \param ohIndex The observation history index to build to
+		/// \return The node for the observation history index
+		///
+		Node* BuildPathTo(const Index &ohIndex);
+
+		///
+		/// \brief Recomputes the layout after the node or edge font has
+		/// changed and moves the nodes and edges already built to their
+		/// new positions
+		///
+		void RefreshLayout();
+
+		/// \return The layout used to position the nodes
+		const TreeLayout& GetLayout() const;
+
+		/// \return The policy the tree is built from
+		const AgentPolicy& GetPolicy() const;
+
+		///
+		/// \brief Sizes a layout so the widest action and longest
+		/// observation in the current fonts fit
+		/// \param agentPolicy The policy to lay out
+		/// \param nodePadding The space between nodes on the bottom level
+		/// \return The layout for the policy
+		///
+		static std::unique_ptr<TreeLayout> CreateLayout(const AgentPolicy &agentPolicy, const qreal &nodePadding);
+
+	private:
+		///
+		/// \brief Creates the node for the observation history index
+		/// at the position given by the layout and adds it to the scene
+		/// \param ohIndex The observation history index of the node
+		/// \return The created node
+		///
+		Node* AddNode(const Index &ohIndex);
+
+		///
+		/// \brief Computes the geometry of the edges for each level and
+		/// observation. Every edge from a level for the same observation
+		/// has the same offset between its nodes and the same label.
+		///
+		void ComputeEdgeGeometries();
+
+		/// The policy being drawn
+		AgentPolicy policy;
+
+		/// The scene to build into, owned by the caller
+		TreeVisGraphicsScene* scene;
+
+		/// The space between nodes on the bottom level
+		qreal padding;
+
+		/// Position of every node in the tree
+		std::unique_ptr<TreeLayout> layout;
+
+		/// \brief Geometry of the edges from a depth for an observation,
+		/// indexed by depth then observation index
+		std::vector<std::vector<EdgeGeometry>> edgeGeometries;
+};
+
+#endif // FULLTREEBUILDER_H
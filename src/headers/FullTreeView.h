@@ -6,6 +6,9 @@
 #include "PlannerManager.h"
 #include "TreeVisGraphicsView.h"
 #include "TreeVisGraphicsScene.h"
+#include "FullTreeBuilder.h"
+#include "PolicyGraph.h"
+#include "TreeOverviewWidget.h"
 #include "Node.h"
 
 // Qt
@@ -13,6 +16,10 @@
 #include <QLayout>
 #include <QPushButton>
 #include <QLabel>
+#include <QSpinBox>
+#include <QComboBox>
+#include <QLineEdit>
+#include <QCheckBox>
 
 ///
 /// \brief The FullTreeView class is the full interface for
@@ -32,6 +39,20 @@ class FullTreeView : public QWidget {
 		explicit FullTreeView(PlannerManager*, QWidget* parent = 0);
 		~FullTreeView();
 
+		/// The ways a policy can be shown, index of the view mode combo box
+		enum viewMode {
+			FullTreeMode,
+			PolicyGraphMode
+		};
+
+	public slots:
+		///
+		/// \brief Slot called when the settings have been changed, restyles
+		/// the scenes already generated rather than regenerating them
+		/// \param fontChanged True if the node or edge font changed
+		///
+		void SettingsChanged(const bool &fontChanged);
+
 	signals:
 		///
 		/// \brief Signals to (MainWindow::)<AppendToInformationText>
@@ -63,6 +84,13 @@ class FullTreeView : public QWidget {
 		///
 		void SaveGraphicsViewToFile();
 
+		///
+		/// \brief Slot called when the Export Full Tree action is clicked
+		/// on the main menu. Exports the whole tree of the chosen agent
+		/// straight from the policy, without generating it in the view
+		///
+		void ExportFullTreeToFile();
+
 		/// \brief Slot for increment policy button on interface
 		void IncrementButtonClicked();
 
@@ -72,6 +100,30 @@ class FullTreeView : public QWidget {
 		/// \brief Slot for generate button on interface
 		void GenerateButtonClicked();
 
+		///
+		/// \brief Slot called from the scene context menu to build
+		/// the levels below a node
+		/// \param node The node to expand
+		///
+		void ExpandNode(Node* node);
+
+		///
+		/// \brief Slot called from the scene context menu to remove
+		/// the levels below a node
+		/// \param node The node to collapse
+		///
+		void CollapseNode(Node* node);
+
+		///
+		/// \brief Slot for the find button and search box. Builds the path to
+		/// the observation history entered, then centres on and highlights it
+		///
+		void FindObservationHistory();
+
+		/// \brief Shows the overview of the full tree currently shown,
+		/// hidden for policy graphs or when turned off
+		void UpdateOverview();
+
 	private:
 		///
 		/// \brief Creates the UI for the full tree view
@@ -90,17 +142,29 @@ class FullTreeView : public QWidget {
 		void UpdateFullPolicyToShowLabel();
 
 		///
-		/// \brief Generates the full policy visualisation for the given agent index
+		/// \brief Generates the top levels of the full policy visualisation
+		/// for the given agent index, deeper levels are built on expansion
 		/// \param agentIndex The zero indexed agent index
 		///
 		void GenerateFTForAgent(const Index &agentIndex);
 
 		///
-		/// \brief Gets the longest width of the bounding rect of observation labels for the given agent.
-		/// \param agentIndex The agents index to get the longest observation for
-		/// \return The length of the longest observations bounding rect for the agent
+		/// \brief Generates the policy graph, the policy with identical
+		/// subtrees merged, for the given agent index
+		/// \param agentIndex The zero indexed agent index
+		///
+		void GeneratePGForAgent(const Index &agentIndex);
+
+		///
+		/// \brief Reads an observation history from the search box text,
+		/// either an observation history index or the observation names
+		/// from the root separated by commas or spaces
+		/// \param text The text entered
+		/// \param builder The builder of the tree being searched
+		/// \param ohIndex Set to the observation history index found
+		/// \return False if the text is not a history in the tree
 		///
-		int GetLongestObservationLengthForAgent(const Index &agentIndex);
+		bool ParseObservationHistory(const QString &text, const FullTreeBuilder &builder, Index &ohIndex);
 
 		///
 		/// \brief The agent index of the current policy being shown in the view.
@@ -108,6 +172,9 @@ class FullTreeView : public QWidget {
 		///
 		int currentFullPolicyShown = -1;
 
+		/// The view mode the current policy is being shown in
+		viewMode currentModeShown = FullTreeMode;
+
 		///
 		/// \brief The full policy to show based on the increment/decrement buttons.
 		/// This is displayed in the label between the buttons.
@@ -117,24 +184,51 @@ class FullTreeView : public QWidget {
 		/// One scene per agent for every view
 		std::vector<TreeVisGraphicsScene*> scenes;
 
-		/// Which scenes have already been populated with the view
-		std::vector<bool> fullPoliciesGenerated;
+		/// \brief Builder for each agents scene, nullptr until
+		/// the tree for the agent has been generated
+		std::vector<std::unique_ptr<FullTreeBuilder>> builders;
+
+		/// One scene per agent for the policy graph view mode
+		std::vector<TreeVisGraphicsScene*> graphScenes;
+
+		/// \brief Policy graph for each agent, nullptr until the
+		/// graph for the agent has been generated
+		std::vector<std::unique_ptr<PolicyGraph>> policyGraphs;
 
 		/// The graphics view to display the policies in
 		TreeVisGraphicsView* graphicsView;
 
+		/// Overview of the full tree shown, over the corner of the view
+		TreeOverviewWidget* overviewWidget;
+
 		/// Gives access to the policies and planning unit
 		PlannerManager* pManager;
 
 		/// The space between nodes on the bottom level
 		const int paddingBetweenNodes = 20;
 
+		/// The default number of levels built on generation and expansion
+		const int defaultLevelsToBuild = 4;
+
 		// UI Items
 		// Push Buttons
 		QPushButton* incrementButton;
 		QPushButton* decrementButton;
 		QPushButton* generateButton;
 
+		/// Number of levels to build on generation and expansion
+		QSpinBox* levelsSpinBox;
+
+		/// Chooses between the full tree and the policy graph
+		QComboBox* viewModeComboBox;
+
+		/// Observation history to find in the full tree
+		QLineEdit* searchLineEdit;
+		QPushButton* findButton;
+
+		/// Turns the overview on and off
+		QCheckBox* overviewCheckBox;
+
 		// Labels
 		QLabel* infoLabel;
 		QLabel* policyGenLabel;
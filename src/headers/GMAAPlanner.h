@@ -29,6 +29,13 @@ class GMAAPlanner : public Planner {
 		///
 		void Plan(ArgumentHandlers::Arguments args);
 
+		///
+		/// \brief Gets the parameters the planning unit is created with
+		/// \param args The arguments planned with
+		/// \return The parameters
+		///
+		PlanningUnitMADPDiscreteParameters GetParameters(const ArgumentHandlers::Arguments &args) const;
+
 	private:
 		///
 		/// \brief GetGMAAInstance Gets a GMAA Instance for the solver.
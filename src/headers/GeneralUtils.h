@@ -5,6 +5,8 @@
 #include <QColor>
 #include <QColorDialog>
 
+#include <vector>
+
 ///
 /// \brief Provide utilities relating to colours.
 ///
@@ -51,5 +53,69 @@ namespace ColourUtils {
 	QColor GetColourFromID(const int &id);
 }
 
+///
+/// \brief Provide utilities for measuring the memory used by the
+/// process. Only implemented on Linux, elsewhere they return 0.
+///
+namespace MemoryUtils {
+
+	/// \return The resident memory of the process in bytes
+	size_t GetResidentMemory();
+
+	/// \return The peak resident memory of the process in bytes
+	size_t GetPeakResidentMemory();
+
+	///
+	/// \brief Gets the memory that can be used without swapping
+	/// \return The available memory of the machine in bytes
+	///
+	size_t GetAvailableMemory();
+
+	///
+	/// \brief Limits the memory the process can take from now on, past
+	/// which allocations fail with std::bad_alloc
+	/// \param bytes The memory allowed on top of what is already mapped
+	/// \return False if the limit could not be set
+	///
+	bool LimitFurtherMemory(const size_t &bytes);
+
+	///
+	/// \brief Resets the peak resident memory to the current resident
+	/// memory, so the peak of a section of code can be measured
+	/// \return False if the peak could not be reset
+	///
+	bool ResetPeakResidentMemory();
+}
+
+///
+/// \brief Provide utilities for parsing command line options.
+///
+namespace CommandLineUtils {
+
+	///
+	/// \brief Parses a comma separated list of positive numbers, such as 2,3,5
+	/// \param text The list
+	/// \param values Set to the numbers
+	/// \return False if the list is empty or any entry is not a positive number
+	///
+	template<typename T>
+	bool ParseNumberList(const QString &text, std::vector<T> &values) {
+		values.clear();
+
+		for(const QString &entry : text.split(',', QString::SkipEmptyParts)) {
+			bool isNumber;
+			uint value = entry.trimmed().toUInt(&isNumber);
+
+			if(!isNumber || value == 0) {
+				return false;
+			}
+
+			values.push_back(value);
+		}
+
+		return !values.empty();
+	}
+}
+
 
 #endif // GENERALUTILS_H
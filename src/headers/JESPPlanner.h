@@ -25,6 +25,13 @@ class JESPPlanner : public Planner {
 		/// \param args The arguments to plan with
 		///
 		void Plan(ArgumentHandlers::Arguments args);
+
+		///
+		/// \brief Gets the parameters the planning unit is created with
+		/// \param args The arguments planned with
+		/// \return The parameters
+		///
+		PlanningUnitMADPDiscreteParameters GetParameters(const ArgumentHandlers::Arguments &args) const;
 };
 
 #endif // JESPPLANNER_H
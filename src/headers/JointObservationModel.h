@@ -0,0 +1,87 @@
+#ifndef JOINTOBSERVATIONMODEL_H
+#define JOINTOBSERVATIONMODEL_H
+
+// Qt
+#include <QAbstractTableModel>
+
+#include <vector>
+#include <functional>
+
+/// Redefined from MADP
+typedef unsigned int Index;
+
+///
+/// \brief The JointObservationModel class is a table of joint
+/// observations and their probabilities for use with a QTreeView
+/// in the format JOI | JO Name | Probability. Only the probabilities
+/// are held, the text of a row is created when the view asks for it so
+/// only the rows on screen are ever formatted. Sorting compares the
+/// numbers directly rather than the displayed text.
+///
+class JointObservationModel : public QAbstractTableModel {
+	Q_OBJECT
+
+	public:
+		/// A joint observation in the table
+		struct Entry {
+			/// The joint observation index
+			Index joIndex;
+			/// The probability of recieving the joint observation
+			double probability;
+		};
+
+		/// The columns of the table
+		enum column {
+			IndexColumn,
+			NameColumn,
+			ProbabilityColumn
+		};
+
+		/// Role to get the joint observation index of any cell in a row
+		static const int JointObservationIndexRole = Qt::UserRole;
+
+		///
+		/// \brief Constructor
+		/// \param jointObservations The joint observations to show
+		/// \param nameFunction Gets the name of a joint observation index,
+		/// only called for rows being shown or sorted by name
+		/// \param parent The parent of the model
+		///
+		JointObservationModel(const std::vector<Entry> &jointObservations,
+							  const std::function<QString(Index)> &nameFunction,
+							  QObject* parent = 0);
+		~JointObservationModel();
+
+		int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+		int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+		QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+		QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+		///
+		/// \brief Sorts the rows on the numbers of the column, or the
+		/// names for the name column. Selected rows are kept selected.
+		/// \param column The column to sort on
+		/// \param order The order to sort in
+		///
+		void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
+
+	private:
+		///
+		/// \brief Gets the name of the joint observation on a row,
+		/// creating it the first time it is needed
+		/// \param row The row to get the name for
+		/// \return The name of the joint observation
+		///
+		const QString& GetName(const int &row) const;
+
+		/// The rows of the table in their current order
+		std::vector<Entry> entries;
+
+		/// Names created so far, by row. Empty until needed
+		mutable std::vector<QString> names;
+
+		/// Gets the name of a joint observation index
+		std::function<QString(Index)> getName;
+};
+
+#endif // JOINTOBSERVATIONMODEL_H
@@ -4,13 +4,13 @@
 // Qt
 #include <QDialog>
 #include <QVBoxLayout>
-#include <QTreeWidget>
+#include <QTreeView>
 #include <QDialogButtonBox>
 
 ///
 /// \brief The JointObservationSelectionDialog class allows a
 /// dialog to be created that can be used to display the a
-/// Tree Widget of joint observationsobservations and provides a
+/// view of joint observations and provides a
 /// signal to connect to so that one can be selected.
 /// Primarily used in the policy visualiser tool.
 ///
@@ -19,12 +19,12 @@ class JointObservationSelectionDialog : public QDialog {
 
 	public:
 		///
-		/// \brief Constructor takes the given tree widget and displays it in the dialog.
-		/// \param treeWidget The populated tree widget to display in the dialog.
-		/// This is in the form JA Index | JA Name | Probability
+		/// \brief Constructor takes the given view and displays it in the dialog.
+		/// \param view The view of a JointObservationModel to display in the dialog.
+		/// This is in the form JO Index | JO Name | Probability
 		/// \param parent The parent of the dialog
 		///
-		explicit JointObservationSelectionDialog(QTreeWidget* treeWidget, QWidget *parent = 0);
+		explicit JointObservationSelectionDialog(QTreeView* view, QWidget *parent = 0);
 		~JointObservationSelectionDialog();
 
 	signals:
@@ -51,8 +51,8 @@ class JointObservationSelectionDialog : public QDialog {
 		QVBoxLayout* verticalLayout;
 		QDialogButtonBox* buttonBox;
 
-		/// The tree widget that is popular with the joint observations
-		QTreeWidget* treeWidget;
+		/// The view of the joint observations
+		QTreeView* treeView;
 
 };
 
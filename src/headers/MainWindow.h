@@ -9,6 +9,7 @@
 #include <QLineEdit>
 #include <QTextEdit>
 #include <QMessageBox>
+#include <QPushButton>
 #include <QFutureWatcher>
 
 namespace Ui {
@@ -58,6 +59,12 @@ class MainWindow : public QMainWindow {
 		///
 		void PlanFinished();
 
+		///
+		/// \brief Signal emitted when the settings have been saved
+		/// \param fontChanged True if the node and edge font changed
+		///
+		void SettingsChanged(bool fontChanged);
+
 	public slots:
 		///
 		/// \brief Appends the string to the information text area
@@ -99,6 +106,30 @@ class MainWindow : public QMainWindow {
 		/// Slot called when settings action on menu bar clicked
 		void ActionSetSettings();
 
+		///
+		/// \brief Slot called when the stop planning action on the menu bar
+		/// or the planning message box is clicked. The best policy found so
+		/// far becomes the plan.
+		///
+		void ActionStopPlanning();
+
+		///
+		/// \brief Slot called when the show best policy action on the menu
+		/// bar or the planning message box is clicked. The views show the
+		/// best policy found so far while planning carries on.
+		///
+		void ActionShowBestPolicy();
+
+		///
+		/// \brief Slot called when the record trace action on the menu
+		/// bar is toggled
+		/// \param checked True to start recording, false to stop
+		///
+		void ActionRecordTrace(bool checked);
+
+		/// Slot called when export trace action on menu bar clicked
+		void ActionExportTrace();
+
 		///
 		/// \brief PlanEnded Slot called when a live plan has ended
 		/// \param success True if the plan was successful, false if failed
@@ -106,6 +137,19 @@ class MainWindow : public QMainWindow {
 		///
 		void PlanEnded(bool success, QString errorMessage);
 
+		///
+		/// \brief Slot called for each line printed by a planner
+		/// running in a child process
+		/// \param text The line
+		///
+		void PlanProgress(QString text);
+
+		///
+		/// \brief Slot called when the plan running has found a better policy
+		/// \param value The value of the policy
+		///
+		void BestPolicyFound(double value);
+
 		///
 		/// \brief PlanEnded Slot called when a
 		/// previous policy finished being read in
@@ -122,6 +166,22 @@ class MainWindow : public QMainWindow {
 		/// Messagebox used to inform the user a plan is taking place
 		QMessageBox* informationMessageBox;
 
+		/// Button on the message box to show the best policy so far
+		QPushButton* showBestPolicyButton;
+
+		/// Button on the message box to stop planning
+		QPushButton* stopPlanningButton;
+
+		/// The views show the best policy of the plan running
+		bool bestPolicyShown = false;
+
+		///
+		/// \brief Enables the actions for while planning, or for once it has ended
+		/// \param planning True while planning
+		/// \param stoppable False for a planner that cannot be stopped early
+		///
+		void SetPlanningActions(const bool &planning, const bool &stoppable = true);
+
 		/// The Planner Manager used to plan and used by the viewers
 		std::unique_ptr<PlannerManager> pManager = 0;
 };
@@ -13,6 +13,10 @@
 /// To match MADP
 typedef unsigned int Index;
 
+/// \brief Below this zoom level of detail nodes are drawn as plain
+/// filled rects, too small to make out an outline
+const static qreal dotLevelOfDetail = 0.15;
+
 class Edge;
 
 ///
@@ -53,9 +57,10 @@ class Node : public QGraphicsItem {
 
 		///
 		/// \brief Paints the node on a QGraphicsScene,
-		/// implementation of QGraphicsItem paint
+		/// implementation of QGraphicsItem paint. When zoomed out the
+		/// text is left out and further out only the fill is drawn
 		/// \param painter Painter provided by Qt
-		/// \param option Unused
+		/// \param option Used for the level of detail
 		/// \param widget Unused
 		///
 		void paint(QPainter* painter,
@@ -65,7 +70,8 @@ class Node : public QGraphicsItem {
 		///
 		/// \brief Sets the filled colour of the node
 		/// to the given colour
-		/// \param newColour The colour to set the node to
+		/// \param newColour The colour to set the node to,
+		/// invalid to use the default
 		///
 		void SetFillColour(const QColor &newColour);
 
@@ -83,6 +89,12 @@ class Node : public QGraphicsItem {
 		///
 		void SetOutlineColour(const QColor &newColour);
 
+		///
+		/// \brief Updates the node after the default colours or the
+		/// font have changed. Colours set on the node itself are kept.
+		///
+		void RefreshStyle();
+
 		///
 		/// \brief Gets the height of the node
 		/// \return boundingRect().height()
@@ -102,6 +114,9 @@ class Node : public QGraphicsItem {
 		///
 		Index GetOHIndex() const;
 
+		/// \return The text in the centre of the node, the action name
+		const QString& GetText() const;
+
 		///
 		/// \brief Gets the agent index of the node.
 		/// If this is not set it will return -1
@@ -109,6 +124,85 @@ class Node : public QGraphicsItem {
 		///
 		Index GetAgentIndex() const;
 
+		///
+		/// \brief Sets the zero indexed time step (depth) of the node,
+		/// set by the scene when the node is added
+		/// \param step The time step of the node
+		///
+		void SetTimeStep(const Index &step);
+
+		///
+		/// \brief Gets the zero indexed time step of the node.
+		/// If this is not set it will return -1
+		/// \return The time step of the node
+		///
+		Index GetTimeStep() const;
+
+		///
+		/// \brief Sets whether the node has children in the policy
+		/// that can be expanded from the context menu
+		/// \param canExpand True if the node can be expanded
+		///
+		void SetExpandable(const bool &canExpand);
+
+		/// \return True if the node has children that can be expanded
+		bool IsExpandable() const;
+
+		///
+		/// \brief Marks the node as having its children
+		/// currently built in the scene
+		/// \param isExpanded True if the children are built
+		///
+		void SetExpanded(const bool &isExpanded);
+
+		/// \return True if the children of the node are built
+		bool IsExpanded() const;
+
+		///
+		/// \brief Marks the node as the result of a search, drawing
+		/// it with a thicker outline in the highlight colour
+		/// \param isHighlighted True to highlight the node
+		///
+		void SetHighlighted(const bool &isHighlighted);
+
+		/// \return True if the node is highlighted
+		bool IsHighlighted() const;
+
+		///
+		/// \brief Gets the size a node would be when displaying the
+		/// given text, without needing to create the node
+		/// \param text The text to get the size for
+		/// \return The size of the bounding rect for the text
+		///
+		static QSizeF GetSizeForText(const QString &text);
+
+		///
+		/// \brief Gets the padded, centred rect for the given text
+		/// \param text The text to get the rect for
+		/// \return A padded rect centred on (0,0)
+		///
+		static QRectF OutlineRectForText(const QString &text);
+
+		///
+		/// \brief Paints a node with the default colours centred on the
+		/// painters origin, used to draw nodes without creating them
+		/// \param painter The painter to paint with
+		/// \param text The text in the centre of the node
+		///
+		static void PaintDefault(QPainter* painter, const QString &text);
+
+		/// \return The default fill colour
+		static QColor GetDefaultFillColour();
+
+		/// \return The default outline colour
+		static QColor GetDefaultOutlineColour();
+
+		/// \return The default text colour
+		static QColor GetDefaultTextColour();
+
+		/// Roundness of nodes, as a percentage of half the width and height
+		static const int roundness = 60;
+
 		///
 		/// \brief Sets the default colour of future nodes to the given colour
 		/// \param newColour The colour to set the default fill colour to
@@ -160,26 +254,54 @@ class Node : public QGraphicsItem {
 		/// The Agent Index for the node. -1 if not set in constructor.
 		Index agentIndex;
 
+		/// The time step of the node. -1 if not added to a scene.
+		Index timeStep = -1;
+
 		/// Text to go in centre of the node
 		QString nodeText;
 
-		/// The fill colour of the node
-		QColor fillColour = defaultFillColour;
+		/// If the node has children in the policy
+		bool expandable = false;
+
+		/// If the children of the node are currently built
+		bool expanded = false;
+
+		/// If the node is highlighted
+		bool highlighted = false;
 
-		/// The outline colour of the node
-		QColor outlineColour = defaultOutlineColour;
+		/// The fill colour of the node, invalid to use the default
+		QColor fillColour;
 
-		/// The text colour of the node
-		QColor textColour = defaultTextColour;
+		/// The outline colour of the node, invalid to use the default
+		QColor outlineColour;
+
+		/// The text colour of the node, invalid to use the default
+		QColor textColour;
 
 		/// \return A padded node
 		QRectF OutlineRect() const;
 
+		///
+		/// \brief Paints a node centred on the painters origin
+		/// \param painter The painter to paint with
+		/// \param text The text in the centre of the node
+		/// \param outline The outline colour
+		/// \param fill The fill colour
+		/// \param textCol The text colour
+		/// \param outlineWidth The width of the outline
+		///
+		static void Paint(QPainter* painter, const QString &text,
+						  const QColor &outline, const QColor &fill, const QColor &textCol,
+						  const qreal &outlineWidth = 2);
+
 		/// Padding for nodes
 		static const int padding = 8;
 
-		/// Roundness of nodes
-		static const int roundness = 60;
+		/// Width of the outline of highlighted nodes
+		static const int highlightWidth = 4;
+
+		/// Outline colour of highlighted nodes
+		static const QColor highlightColour;
 
 		/// Default node fill colour, set in settings
 		static QColor defaultFillColour;
@@ -0,0 +1,165 @@
+#ifndef PLANCOSTESTIMATOR_H
+#define PLANCOSTESTIMATOR_H
+
+// TreeVis
+#include "PlannerManager.h"
+
+// MADP
+#include "DecPOMDPDiscreteInterface.h"
+#include "PlanningUnitMADPDiscreteParameters.h"
+
+// Qt
+#include <QString>
+
+#include <vector>
+
+///
+/// \brief The PlanCostEstimator class estimates, before planning, how
+/// many histories a plan needs, how large the space of joint policies is,
+/// the memory the planning unit takes with the parameters the planner
+/// uses and roughly how long the planner will run. The estimate is
+/// compared with the memory the machine has free, so a plan that cannot
+/// fit can be stopped before it starts, with a horizon, option or
+/// planner that would fit suggested instead.
+///
+/// The counts are exact, the memory and time are rough: the bytes per
+/// history and operations per second are typical figures, and the open
+/// list of GMAA* and the Q heuristic caches are not counted.
+///
+class PlanCostEstimator {
+
+	public:
+		/// How the estimate compares to the machine
+		enum verdict {
+			Fits,
+			Warn,
+			Block
+		};
+
+		/// The cost of one plan
+		struct Estimate {
+			/// Horizon estimated for
+			Index horizon = 0;
+			/// Observation histories of each agent, all lengths
+			std::vector<double> observationHistories;
+			/// Joint observation histories, all lengths
+			double jointObservationHistories = 0;
+			/// Joint action observation histories, all lengths
+			double jointActionObservationHistories = 0;
+			/// Base 10 logarithm of the number of joint policies
+			double log10JointPolicies = 0;
+			/// Bytes of histories, beliefs and models the planning unit holds
+			double planningUnitBytes = 0;
+			/// Base 10 logarithm of the operations the planner performs
+			double log10Operations = 0;
+			/// Rough running time in seconds
+			double seconds = 0;
+			/// Memory the machine had available, 0 if unknown
+			double availableBytes = 0;
+			/// How the estimate compares to the machine
+			verdict result = Fits;
+		};
+
+		///
+		/// \brief Constructor, reads the sizes of the problem
+		/// \param decpomdp The problem to be planned for
+		///
+		PlanCostEstimator(const DecPOMDPDiscreteInterface &decpomdp);
+		~PlanCostEstimator();
+
+		///
+		/// \brief Estimates the cost of a plan
+		/// \param type The planner to plan with
+		/// \param args The arguments planned with, including the horizon
+		/// \return The estimate, judged against the memory available now
+		///
+		Estimate GetEstimate(const PlannerManager::PlannerType &type,
+							 const ArgumentHandlers::Arguments &args) const;
+
+		///
+		/// \brief Suggests what would fit when an estimate does not: sparse
+		/// beliefs, a smaller horizon or a cheaper planner
+		/// \param type The planner to plan with
+		/// \param args The arguments planned with
+		/// \return The suggestions, empty if nothing would fit
+		///
+		QString GetSuggestion(const PlannerManager::PlannerType &type,
+							  const ArgumentHandlers::Arguments &args) const;
+
+		///
+		/// \brief Describes an estimate for the user
+		/// \param estimate The estimate
+		/// \return Several lines of text
+		///
+		static QString Describe(const Estimate &estimate);
+
+	private:
+		///
+		/// \brief Counts the histories of every length up to a horizon
+		/// \param branching Choices at each step, such as the observations
+		/// \param horizon The horizon
+		/// \return 1 + branching + ... + branching^(horizon-1)
+		///
+		static double CountHistories(const double &branching, const Index &horizon);
+
+		///
+		/// \brief Gets the base 10 logarithm of the operations to solve the
+		/// Bayesian games of GMAA* at every stage
+		/// \param args The arguments planned with
+		/// \param horizon The horizon
+		/// \return The logarithm
+		///
+		double GetLog10BayesianGameOperations(const ArgumentHandlers::Arguments &args, const Index &horizon) const;
+
+		///
+		/// \brief Gets a readable size
+		/// \param bytes The size in bytes
+		/// \return Such as 1.5 GB
+		///
+		static QString FormatBytes(const double &bytes);
+
+		///
+		/// \brief Gets a readable duration
+		/// \param seconds The duration in seconds
+		/// \return Such as 3 hours
+		///
+		static QString FormatSeconds(const double &seconds);
+
+		/// Agents in the problem
+		Index nrAgents;
+
+		/// States in the problem
+		double nrStates;
+
+		/// Actions of each agent
+		std::vector<double> nrActions;
+
+		/// Observations of each agent
+		std::vector<double> nrObservations;
+
+		/// Joint actions
+		double nrJointActions;
+
+		/// Joint observations
+		double nrJointObservations;
+
+		/// Rough bytes MADP holds for each history, its indexes and tree links
+		static constexpr double historyBytes = 96;
+
+		/// Fraction of the states assumed non-zero in a sparse belief
+		static constexpr double sparseBeliefFill = 0.25;
+
+		/// Rough operations a core manages each second
+		static constexpr double operationsPerSecond = 1e8;
+
+		/// Fraction of the available memory above which to warn
+		static constexpr double warnMemoryFraction = 0.5;
+
+		/// Running time above which to warn
+		static constexpr double warnSeconds = 3600;
+
+		/// Iterations JESP is assumed to take to converge
+		static constexpr double jespIterations = 10;
+};
+
+#endif // PLANCOSTESTIMATOR_H
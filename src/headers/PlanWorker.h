@@ -0,0 +1,248 @@
+#ifndef PLANWORKER_H
+#define PLANWORKER_H
+
+// TreeVis
+#include "PlannerManager.h"
+
+// Qt
+#include <QObject>
+#include <QProcess>
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+#include <QDataStream>
+
+#include <string>
+#include <vector>
+
+///
+/// \brief The PlanWorker class plans in a child process, so a planner
+/// that exits, crashes or runs out of memory only fails its own plan
+/// rather than taking the window with it. The child is this program
+/// started with --plan-worker. It sends what the planner prints back
+/// over a pipe as progress, and once planned writes the action of every
+/// observation history into shared memory for the parent to copy. Each
+/// worker has its own shared memory key so several can plan at once.
+///
+/// A memory budget limits the address space of the child, so a plan too
+/// large for it stops cleanly rather than the machine swapping. A plan
+/// that runs out is tried again with sparse joint beliefs and then
+/// without the flat models cached, before it is reported as failed.
+///
+/// Each better policy the planner finds is sent back as it is found, so
+/// stopping the child keeps the best policy rather than losing the plan.
+///
+class PlanWorker : public QObject {
+	Q_OBJECT
+
+	public:
+		///
+		/// \brief Constructor
+		/// \param parent Parent that deletes the worker
+		///
+		PlanWorker(QObject* parent = nullptr);
+
+		/// Kills the child process if it is still planning
+		~PlanWorker();
+
+		///
+		/// \brief Starts planning in a new child process, Finished() is
+		/// emitted once it has ended
+		/// \param type The type of planner to plan with
+		/// \param args The args to pass to the planner, dpf is copied
+		/// \param memoryBudgetMB Megabytes the child may allocate, 0 for no limit
+		///
+		void Start(const PlannerManager::PlannerType &type,
+				   const ArgumentHandlers::Arguments &args,
+				   const int &memoryBudgetMB = 0);
+
+		/// Kills the child process, Finished() is emitted as a failure
+		void Cancel();
+
+		///
+		/// \brief Stops planning, Finished() is emitted as a success with the
+		/// best policy found so far. If none has been found the child is
+		/// asked to stop once the run in progress has found one.
+		///
+		void Stop();
+
+		/// \return The horizon planned for, once Finished() reported success
+		Index GetHorizon() const;
+
+		/// \return The expected reward of the policy, once Finished() reported success
+		double GetExpectedReward() const;
+
+		///
+		/// \brief Gets the policy planned, once Finished() reported success
+		/// \return The action index for each agent and observation history index
+		///
+		const std::vector<std::vector<Index>>& GetPolicies() const;
+
+		///
+		/// \brief Gets the best policy found so far, while planning
+		/// \return The action index for each agent and observation history index
+		///
+		const std::vector<std::vector<Index>>& GetBestPolicies() const;
+
+		///
+		/// \brief Checks if the application was started as a worker
+		/// \param argc Number of command line arguments
+		/// \param argv Command line arguments
+		/// \return True if --plan-worker was given
+		///
+		static bool IsRequested(int argc, char** argv);
+
+		///
+		/// \brief Plans as a worker for the parent process, the application
+		/// must already be created
+		/// \param arguments The application arguments
+		/// \return 0 once the parent has the policy, 2 if planning failed
+		///
+		static int RunFromCommandLine(const QStringList &arguments);
+
+	signals:
+		///
+		/// \brief Emitted for each line the planner prints
+		/// \param text The line
+		///
+		void Progress(QString text);
+
+		///
+		/// \brief Emitted when the planner has found a better policy
+		/// \param value The value of the policy
+		///
+		void BestPolicy(double value);
+
+		///
+		/// \brief Emitted once the child process has ended
+		/// \param success True if the policy was read back
+		/// \param message Why planning failed
+		///
+		void Finished(bool success, QString message = "");
+
+	private slots:
+		/// Reads the lines the child process has written
+		void ReadOutput();
+
+		///
+		/// \brief Reports how the child process ended
+		/// \param exitCode The exit code of the child process
+		/// \param exitStatus If the child process crashed or was killed
+		///
+		void ProcessFinished(int exitCode, QProcess::ExitStatus exitStatus);
+
+		///
+		/// \brief Reports a child process that could not be started
+		/// \param error The error
+		///
+		void ProcessError(QProcess::ProcessError error);
+
+	private:
+		///
+		/// \brief Writes or reads the planner type and every argument the
+		/// wizards and planners use, so both directions stay in step
+		/// \param stream The stream to write to or read from
+		/// \param type The planner type
+		/// \param args The arguments, dpf is ignored
+		/// \param problemFile The problem file, empty if a built in problem
+		/// \param reading True to read from the stream
+		///
+		static void StreamArguments(QDataStream &stream,
+									qint32 &type,
+									ArgumentHandlers::Arguments &args,
+									QString &problemFile,
+									const bool &reading);
+
+		///
+		/// \brief Writes or reads one argument, numbers, booleans and enums
+		/// going through the widest type of their kind
+		/// \param stream The stream to write to or read from
+		/// \param field The argument
+		/// \param reading True to read from the stream
+		///
+		template <typename T>
+		static void StreamField(QDataStream &stream, T &field, const bool &reading);
+
+		///
+		/// \brief Plans, retrying with less memory if it runs out, and
+		/// writes the policy into shared memory
+		/// \param type The planner type
+		/// \param args The arguments to plan with, dpf is ignored
+		/// \param problemFile The problem file, empty if a built in problem
+		/// \param sharedMemoryKey The key of the shared memory to create
+		/// \param memoryBudgetMB Megabytes the worker may allocate, 0 for no limit
+		/// \param protocol Where to write the messages for the parent
+		/// \return The exit code for the worker
+		///
+		static int PlanAndShare(const PlannerManager::PlannerType &type,
+								ArgumentHandlers::Arguments args,
+								const QString &problemFile,
+								const QString &sharedMemoryKey,
+								const int &memoryBudgetMB,
+								std::ostream &protocol);
+
+		///
+		/// \brief Changes the arguments to plan with less memory, the
+		/// next change each time it is called
+		/// \param type The planner type
+		/// \param args The arguments to change
+		/// \return What was changed, empty if there is nothing left to change
+		///
+		static QString ReduceMemory(const PlannerManager::PlannerType &type,
+									ArgumentHandlers::Arguments &args);
+
+		///
+		/// \brief Copies the policy out of the shared memory of the child
+		/// \return False if the shared memory could not be read
+		///
+		bool ReadPolicy();
+
+		///
+		/// \brief Reads a best policy sent on one line, its value, the
+		/// agents, their observation history counts and the action indexes
+		/// \param line The line, after best
+		/// \return False if the line was cut short
+		///
+		bool ReadBestPolicy(const QString &line);
+
+		/// \return A note of the memory budget for failures, empty if there was none
+		QString BudgetNote() const;
+
+		/// The child process, nullptr until started
+		QProcess* process = nullptr;
+
+		/// Key of the shared memory the child writes the policy to
+		QString sharedMemoryKey;
+
+		/// Failure reported by the child
+		QString failure;
+
+		/// If the policy was copied from the child
+		bool policyRead = false;
+
+		/// Megabytes the child may allocate, 0 for no limit
+		int memoryBudget = 0;
+
+		/// Horizon planned for
+		Index horizon = 0;
+
+		/// Expected reward of the policy
+		double expectedReward = 0;
+
+		/// Action index for each agent and observation history index
+		std::vector<std::vector<Index>> policies;
+
+		/// Best policy sent while planning, empty until one is
+		std::vector<std::vector<Index>> bestPolicies;
+
+		/// Value of the best policy sent
+		double bestValue = 0;
+
+		/// If stopped, with the best policy kept
+		bool stopped = false;
+
+		/// Workers started by this process, to make each key unique
+		static int workersStarted;
+};
+
+#endif // PLANWORKER_H
@@ -1,22 +1,58 @@
 #ifndef PLANNER_H
 #define PLANNER_H
 
+// TreeVis
+#include "PlannerTiming.h"
+
 // MADP Files
 #include "PlanningUnitDecPOMDPDiscrete.h"
+#include "PlanningUnitMADPDiscreteParameters.h"
 #include "argumentHandlers.h"
+#include "JointPolicyPureVector.h"
+#include "E.h"
 
 // Smart pointers
 #include <memory>
 
+#include <atomic>
+#include <functional>
+#include <vector>
+
+///
+/// \brief The EOutOfMemory class is thrown by the planners when planning
+/// runs out of memory, so it can be told apart from other failures.
+///
+class EOutOfMemory : public E {
+
+	public:
+		///
+		/// \brief Constructor
+		/// \param message What was being done when memory ran out
+		///
+		EOutOfMemory(const std::string &message) : E(message) {}
+};
+
 ///
 /// \brief The Planner class is a super class for planners.
 /// It holds the ownership to the PlanningUnitDecPOMDPDiscrete
 /// and DecPOMDPDiscreteInterface (both MADP types) used
 /// by the planner.
 ///
+/// Planners that run several times, keeping a policy from each run,
+/// offer each policy as it is found. Those better than any before are
+/// passed to the best policy listener, so a policy can be used while
+/// planning carries on, and planning stops between runs once asked to.
+///
 class Planner {
 
 	public:
+		///
+		/// \brief Called on the planning thread with each policy better than
+		/// those found before, the action index for each agent and observation
+		/// history index, and its value
+		///
+		typedef std::function<void(const std::vector<std::vector<Index>> &policies, double value)> BestPolicyListener;
+
 		/// Destructor
 		virtual ~Planner() {
 			//std::cout << "~Planner" << std::endl;
@@ -25,6 +61,14 @@ class Planner {
 		/// Pure virtual, implemented by base classes
 		virtual void Plan(ArgumentHandlers::Arguments args) = 0;
 
+		///
+		/// \brief Gets the parameters the planning unit is created with,
+		/// which decide the histories and beliefs computed up front
+		/// \param args The arguments planned with
+		/// \return The parameters
+		///
+		virtual PlanningUnitMADPDiscreteParameters GetParameters(const ArgumentHandlers::Arguments &args) const = 0;
+
 		///
 		/// \brief Gets the planning unit. This still
 		/// holds the ownership to the object.
@@ -34,12 +78,72 @@ class Planner {
 			return pUnit.get();
 		}
 
+		///
+		/// \brief Gets the timings of the last plan, such as the
+		/// PlanningUnit and Plan phases. Phases reached before
+		/// planning failed are still recorded.
+		/// \return The timings
+		///
+		const PlannerTiming& GetTiming() const {
+			return timing;
+		}
+
+		///
+		/// \brief Sets the listener told of each better policy found
+		/// \param listener The listener
+		///
+		void SetBestPolicyListener(const BestPolicyListener &listener) {
+			bestPolicyListener = listener;
+		}
+
+		///
+		/// \brief Sets the flag that asks planning to stop, checked between
+		/// runs once one has found a policy
+		/// \param flag The flag, owned by the caller and kept until planned
+		///
+		void SetStopFlag(const std::atomic<bool>* flag) {
+			stopFlag = flag;
+		}
+
 	protected:
+		///
+		/// \brief Checks if planning has been asked to stop
+		/// \return True if the stop flag is set
+		///
+		bool StopRequested() const {
+			return stopFlag && *stopFlag;
+		}
+
+		///
+		/// \brief Offers the policy of a finished run, passed to the
+		/// listener if better than those offered before
+		/// \param unit The planning unit the policy is for
+		/// \param jointPolicy The policy
+		/// \param value The value of the policy
+		///
+		void OfferPolicy(PlanningUnitDecPOMDPDiscrete* unit, JointPolicyPureVector &jointPolicy, const double &value);
+
 		/// The planning unit used by the planner
 		std::unique_ptr<PlanningUnitDecPOMDPDiscrete> pUnit = 0;
 
 		/// The DecPOMDP used by the planner during planning
 		std::unique_ptr<DecPOMDPDiscreteInterface> decpomdp = 0;
+
+		/// The timings of each phase of planning
+		PlannerTiming timing;
+
+	private:
+		/// Told of each better policy found, may be empty
+		BestPolicyListener bestPolicyListener;
+
+		/// Set to ask planning to stop, nullptr if planning cannot be stopped
+		const std::atomic<bool>* stopFlag = nullptr;
+
+		/// If a policy has been offered
+		bool policyOffered = false;
+
+		/// Value of the best policy offered
+		double bestValue = 0;
 };
 
 #endif // PLANNER_H
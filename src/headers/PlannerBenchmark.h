@@ -0,0 +1,154 @@
+#ifndef PLANNERBENCHMARK_H
+#define PLANNERBENCHMARK_H
+
+// TreeVis
+#include "PlannerManager.h"
+
+// Qt
+#include <QString>
+#include <QStringList>
+#include <QJsonObject>
+
+#include <map>
+#include <string>
+#include <vector>
+
+///
+/// \brief The PlannerBenchmark class runs each planner over the built in
+/// problems at a range of horizons, recording the value found and the
+/// time of each phase the planners time. The random number generator is
+/// seeded the same way before every run, so a run can be compared with a
+/// baseline saved from an earlier build to find time and value regressions.
+///
+/// Only built with qmake CONFIG+=benchmark, run with:
+/// MADP-TreeVis-benchmark --planner [--problems aloha,dectiger,...]
+///                        [--planners bfs,gmaa-bfs,...,jesp,dice] [--horizons 2,3]
+///                        [--seed <n>] [--json <file>] [--baseline <file>]
+///                        [--time-tolerance <fraction>] [--min-time-ms <ms>]
+///                        [--value-tolerance <fraction>]
+///
+class PlannerBenchmark {
+
+	public:
+		/// Results for one problem, planner and horizon
+		struct Result {
+			/// Name of the problem
+			QString problem;
+			/// Name of the planner
+			QString planner;
+			/// Horizon planned for
+			Index horizon = 0;
+			/// False if the planner threw
+			bool success = false;
+			/// Message of the exception if the planner threw
+			QString error;
+			/// Expected reward of the policy found
+			double value = 0;
+			/// Milliseconds of each phase the planner timed, such as Overall and Plan
+			std::map<std::string, double> phasesMs;
+			/// \brief Differences from the baseline that are regressions,
+			/// empty without a baseline
+			QStringList regressions;
+		};
+
+		///
+		/// \brief Constructor
+		/// \param randomSeed Seed set before every run
+		///
+		PlannerBenchmark(const unsigned int &randomSeed);
+		~PlannerBenchmark();
+
+		///
+		/// \brief Runs every planner on every problem and horizon, printing each result
+		/// \param problems The problems, as accepted by PlannerManager::GetBuiltInProblemArguments()
+		/// \param planners The planners, as accepted by GetPlannerArguments()
+		/// \param horizons The horizons
+		/// \return The results in the order measured
+		///
+		std::vector<Result> Run(const QStringList &problems,
+								const QStringList &planners,
+								const std::vector<Index> &horizons);
+
+		///
+		/// \brief Plans for one problem with one planner
+		/// \param problem The problem
+		/// \param planner The planner
+		/// \param horizon The horizon
+		/// \return The result
+		///
+		Result Measure(const QString &problem, const QString &planner, const Index &horizon);
+
+		///
+		/// \brief Sets how far a result may be from the baseline before it is flagged
+		/// \param timeFraction Fraction the overall time may grow by
+		/// \param minGrowthMs Growth in milliseconds ignored, as noise on short runs
+		/// \param valueFraction Fraction of the baseline value the value may differ by
+		///
+		void SetTolerances(const double &timeFraction, const double &minGrowthMs, const double &valueFraction);
+
+		///
+		/// \brief Compares a result with the matching one from a baseline, setting its regressions
+		/// \param result The result
+		/// \param baseline The baseline results, keyed with ResultKey()
+		///
+		void CompareWithBaseline(Result &result, const std::map<QString, QJsonObject> &baseline) const;
+
+		///
+		/// \brief Gets the planner type and sets its arguments
+		/// \param planner bfs, jesp, dice, or gmaa- followed by a BGIP solver:
+		/// bfs, bfsnoninc, bnb, am, ce, maxplus or random
+		/// \param type Set to the planner type
+		/// \param args The arguments to set the planner options on
+		/// \return False if the planner is not known
+		///
+		static bool GetPlannerArguments(const QString &planner,
+										PlannerManager::PlannerType &type,
+										ArgumentHandlers::Arguments &args);
+
+		///
+		/// \brief Checks if the planner benchmark was asked for
+		/// \param argc Number of command line arguments
+		/// \param argv Command line arguments
+		/// \return True if --planner was given
+		///
+		static bool IsRequested(int argc, char** argv);
+
+		///
+		/// \brief Parses the command line and runs the benchmark, the
+		/// application must already be created
+		/// \param arguments The application arguments
+		/// \return The exit code for the application, 3 if any regression was found
+		///
+		static int RunFromCommandLine(const QStringList &arguments);
+
+		///
+		/// \brief Converts a result to JSON
+		/// \param result The result
+		/// \return The result as an object
+		///
+		static QJsonObject ToJson(const Result &result);
+
+		///
+		/// \brief Gets the key matching results between runs
+		/// \param problem The problem
+		/// \param planner The planner
+		/// \param horizon The horizon
+		/// \return The key
+		///
+		static QString ResultKey(const QString &problem, const QString &planner, const Index &horizon);
+
+	private:
+		/// Seed set before every run
+		unsigned int seed;
+
+		/// Fraction the overall time may grow by
+		double timeTolerance = 0.25;
+
+		/// Growth in milliseconds that is ignored
+		double minTimeMs = 10;
+
+		/// Fraction of the baseline value the value may differ by
+		double valueTolerance = 1e-6;
+};
+
+#endif // PLANNERBENCHMARK_H
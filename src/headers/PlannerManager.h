@@ -3,6 +3,8 @@
 
 // TreeVis files
 #include "Planner.h"
+#include "AgentPolicy.h"
+#include "SparseModelSupport.h"
 
 // MADP Files
 #include "NullPlanner.h"
@@ -11,11 +13,16 @@
 
 // Smart pointers
 #include <memory>
+#include <istream>
+#include <atomic>
+#include <mutex>
 
 // Qt
-#include <QWidget>
+#include <QObject>
 #include <QStringList>
 
+class PlanWorker;
+
 ///
 /// \brief The PlannerManager class is used to abstract
 /// the planning process and subsequent use of the planner
@@ -26,12 +33,16 @@
 /// plan or read in a policy from a file and provides the abstraction
 /// needed in order to get actions from these.
 ///
-class PlannerManager : public QWidget {
+/// Planners that run several times publish the best policy found so far
+/// while still planning. It can be used before planning has ended, and
+/// planning stopped once it is good enough.
+///
+class PlannerManager : public QObject {
 	Q_OBJECT
 
 	public:
 		/// Constructor
-		PlannerManager() = default;
+		PlannerManager();
 		~PlannerManager();
 
 		// The type of planner used
@@ -44,13 +55,78 @@ class PlannerManager : public QWidget {
 
 		///
 		/// \brief Plan for the given problem using the planner type
-		/// specified and the arguments given
+		/// specified and the arguments given, returning once planned
 		/// \param type The type of planner to plan with
 		/// \param args The args to pass to the planner
 		///
 		void Plan(const PlannerType &type,
 				  const ArgumentHandlers::Arguments &args);
 
+		///
+		/// \brief Plans on another thread, the manager must be used from
+		/// the thread it belongs to. Returns straight away, PlanEnded() is
+		/// emitted on that thread once planning has ended.
+		/// \param type The type of planner to plan with
+		/// \param args The args to pass to the planner
+		///
+		void PlanInBackground(const PlannerType &type,
+							  const ArgumentHandlers::Arguments &args);
+
+		///
+		/// \brief Plans in a child process, so a planner that exits or
+		/// runs out of memory cannot take the program with it. Returns
+		/// straight away, PlanEnded() is emitted once planning has ended
+		/// and the policy is used as a previous plan would be.
+		/// \param type The type of planner to plan with
+		/// \param args The args to pass to the planner
+		/// \param memoryBudgetMB Megabytes the child process may allocate,
+		/// 0 for no limit
+		///
+		void PlanInWorker(const PlannerType &type,
+						  const ArgumentHandlers::Arguments &args,
+						  const int &memoryBudgetMB = 0);
+
+		///
+		/// \brief Copies the best policy found so far by the plan running,
+		/// safe to call while it runs
+		/// \param policies Set to the action index for each agent and observation history index
+		/// \param value Set to the value of the policy
+		/// \return False if no policy has been found yet
+		///
+		bool GetBestPolicy(std::vector<std::vector<Index>> &policies, double &value);
+
+		///
+		/// \brief Makes the best policy found so far the one used, as a
+		/// previous plan is, while planning carries on. The problem is read
+		/// in again the first time, apart from the one the planner uses.
+		/// \param message Set to why the policy could not be used
+		/// \return False if no policy has been found yet or the problem could not be read
+		///
+		bool UseBestPolicy(QString &message);
+
+		///
+		/// \brief Asks the plan running to stop and keep the best policy
+		/// found. A plan in a child process that has found one stops
+		/// straight away, otherwise planning stops once the run in
+		/// progress has ended.
+		///
+		void StopPlanning();
+
+		///
+		/// \brief Gets the arguments for a built in problem with its default options
+		/// \param problem aloha, dectiger, firefighting, firefightingfactored or firefightinggraph
+		/// \param args Set to the arguments, the rest reset to their defaults
+		/// \return False if the problem is not known
+		///
+		static bool GetBuiltInProblemArguments(const QString &problem, ArgumentHandlers::Arguments &args);
+
+		///
+		/// \brief Creates a planner of the given type, without planning
+		/// \param type The type of planner
+		/// \return The planner
+		///
+		static std::unique_ptr<Planner> CreatePlanner(const PlannerType &type);
+
 		///
 		/// \brief Allows a previous plan to be read in to the program
 		/// \param policyFilePath The file path of the saved policy
@@ -76,6 +152,28 @@ class PlannerManager : public QWidget {
 		///
 		Index GetActionIndex(Index agentIndex, Index ohIndex);
 
+		///
+		/// \brief Gets the individual policy of an agent along with the
+		/// names of its actions and observations. The lookup in the
+		/// returned policy calls GetActionIndex() so is only valid while
+		/// the current plan is held by the manager.
+		/// \param agentIndex The agent index to get the policy for
+		/// \return The policy for the agent
+		///
+		AgentPolicy GetAgentPolicy(Index agentIndex);
+
+		///
+		/// \brief Reads the action indexes of a saved policy, the part of
+		/// the file after the horizon, agents and observation history counts
+		/// \param input The policy file, positioned at the first action index
+		/// \param numObservationHistories The number of observation histories of each agent
+		/// \param policies Set to the action index for each agent and observation history index
+		/// \return False if the file ended early or had something other than an index
+		///
+		static bool ReadPolicyIndexes(std::istream &input,
+									  const std::vector<Index> &numObservationHistories,
+									  std::vector<std::vector<Index>> &policies);
+
 		///
 		/// \brief Allows access to the planning unit used to plan.
 		/// The Manager retains ownership of the object.
@@ -83,6 +181,21 @@ class PlannerManager : public QWidget {
 		///
 		PlanningUnitDecPOMDPDiscrete* GetPlanningUnit();
 
+		///
+		/// \brief Gets the non-zero entries of the models of the problem
+		/// planned for, created the first time it is needed after a plan.
+		/// The Manager retains ownership of the object.
+		/// \return A pointer to the model support
+		///
+		const SparseModelSupport* GetModelSupport();
+
+		///
+		/// \brief Returns if the last plan failed by running out of memory,
+		/// rather than for another reason
+		/// \return True if the last plan ran out of memory
+		///
+		bool RanOutOfMemory() const;
+
 		///
 		/// \brief Returns if either a live plan or an offline read in
 		/// has occurred
@@ -107,6 +220,54 @@ class PlannerManager : public QWidget {
 		///
 		void PreviousPlanEnded(bool success, QString message = "");
 
+		///
+		/// \brief PlanProgress Signal emitted for each line a planner in a
+		/// child process prints
+		/// \param text The line
+		///
+		void PlanProgress(QString text);
+
+		///
+		/// \brief BestPolicyFound Signal emitted when the plan running has
+		/// found a policy better than those before, possibly from the
+		/// planning thread
+		/// \param value The value of the policy
+		///
+		void BestPolicyFound(double value);
+
+		///
+		/// \brief PlanRunEnded Signal emitted by the planning thread once
+		/// the planner has ended, taken by RunEnded() on the thread of the manager
+		/// \param type The type of planner
+		/// \param success True if the plan succeeded
+		/// \param message Error message if the plan failed
+		/// \param ranOutOfMemory True if the plan failed by running out of memory
+		///
+		void PlanRunEnded(int type, bool success, QString message, bool ranOutOfMemory);
+
+	private slots:
+		///
+		/// \brief Takes the planner that has ended and uses its policy
+		/// \param type The type of planner
+		/// \param success True if the plan succeeded
+		/// \param message Error message if the plan failed
+		/// \param ranOutOfMemory True if the plan failed by running out of memory
+		///
+		void RunEnded(int type, bool success, QString message, bool ranOutOfMemory);
+
+		///
+		/// \brief Takes the policy planned in a child process
+		/// \param success True if the child process planned
+		/// \param message Why planning failed
+		///
+		void WorkerFinished(bool success, QString message);
+
+		///
+		/// \brief Takes the best policy found so far by a child process
+		/// \param value The value of the policy
+		///
+		void WorkerBestPolicy(double value);
+
 	private:
 
 		/// Live plan taken place
@@ -115,6 +276,9 @@ class PlannerManager : public QWidget {
 		/// Previous plan has been read in
 		bool previousPlan = false;
 
+		/// The last plan ran out of memory
+		bool outOfMemory = false;
+
 		/// The planner used for live plans
 		std::unique_ptr<Planner> planner;
 
@@ -139,6 +303,85 @@ class PlannerManager : public QWidget {
 		/// Used for previous plans instead of a Planner object
 		std::unique_ptr<NullPlanner> nullPlannerUnit;
 
+		/// Support of the models of the current plan, nullptr until needed
+		std::unique_ptr<SparseModelSupport> modelSupport;
+
+		/// Child process planning, nullptr unless planning in one
+		PlanWorker* worker = nullptr;
+
+		/// Arguments of the plan running, to read in the problem again
+		ArgumentHandlers::Arguments planArgs;
+
+		/// Problem file of the plan running, empty if a built in problem
+		std::string planProblemFile;
+
+		/// The problem of the plan running has been read in again
+		bool planProblemLoaded = false;
+
+		/// Set to ask the plan running to stop
+		std::atomic<bool> stopRequested{false};
+
+		/// Guards the best policy and the planner, written on the planning thread
+		std::mutex bestPolicyMutex;
+
+		/// Best policy found by the plan running or last ran, empty if none
+		std::vector<std::vector<Index>> bestPolicies;
+
+		/// Value of the best policy
+		double bestValue = 0;
+
+		/// Planner that has ended on the planning thread, until RunEnded() takes it
+		std::unique_ptr<Planner> endedPlanner;
+
+		/// Best policy of the live plan, copied as the next plan replaces bestPolicies
+		std::vector<std::vector<Index>> liveBestPolicies;
+
+		/// The live plan looks up actions in the best policy, which can be
+		/// from an earlier run than the one the planner ended with
+		bool useBestPolicies = false;
+
+		///
+		/// \brief Keeps the arguments of a plan starting and forgets the
+		/// best policy of the last
+		/// \param args The args of the plan
+		///
+		void StartPlanning(const ArgumentHandlers::Arguments &args);
+
+		///
+		/// \brief Plans with a planner of its own, touching nothing but the
+		/// stop flag and the best policy, then emits PlanRunEnded()
+		/// \param type The type of planner to plan with
+		/// \param args The args to pass to the planner
+		///
+		void RunPlan(const PlannerType &type,
+					 const ArgumentHandlers::Arguments &args);
+
+		///
+		/// \brief Keeps a better policy found and tells the listeners
+		/// \param policies The action index for each agent and observation history index
+		/// \param value The value of the policy
+		///
+		void SetBestPolicy(const std::vector<std::vector<Index>> &policies, const double &value);
+
+		///
+		/// \brief Gets the joint action of individual policies
+		/// \param unit The planning unit the policies are for
+		/// \param policies The action index for each agent and observation history index
+		/// \param johIndex The JOHI index to get the JAI for
+		/// \return The JAI of the individual actions
+		///
+		static Index GetJointActionIndex(PlanningUnitDecPOMDPDiscrete* unit,
+										 const std::vector<std::vector<Index>> &policies,
+										 Index johIndex);
+
+		///
+		/// \brief Reads in the problem and creates the null planner used
+		/// with policies that were not planned by this manager
+		/// \param args The args giving the problem
+		/// \param horizon The horizon of the policy
+		///
+		void CreateNullPlanner(const ArgumentHandlers::Arguments &args, const Index &horizon);
+
 		///
 		/// \brief Sets the class based policy variables at the
 		/// end of a live plan
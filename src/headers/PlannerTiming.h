@@ -0,0 +1,52 @@
+#ifndef PLANNERTIMING_H
+#define PLANNERTIMING_H
+
+// MADP Files
+#include "Timing.h"
+
+// Qt
+#include <QtGlobal>
+
+#include <map>
+#include <string>
+
+///
+/// \brief The PlannerTiming class is the MADP Timing used by the
+/// planners, which also keeps the total time of each phase so it can
+/// be read after planning rather than only printed in the summary.
+/// Each phase stopped is also recorded as a span by the TraceRecorder.
+///
+class PlannerTiming : public Timing {
+
+	public:
+		PlannerTiming() = default;
+		~PlannerTiming();
+
+		///
+		/// \brief Starts timing a phase
+		/// \param id The name of the phase
+		///
+		void Start(const std::string &id);
+
+		///
+		/// \brief Stops timing a phase, adding the time since it was started
+		/// to its total
+		/// \param id The name of the phase
+		///
+		void Stop(const std::string &id);
+
+		///
+		/// \brief Gets the total time of each phase that has been stopped
+		/// \return Milliseconds for each phase name
+		///
+		const std::map<std::string, double>& GetTotalsMs() const;
+
+	private:
+		/// Start in TraceRecorder::NowUs() of each phase running
+		std::map<std::string, qint64> startsUs;
+
+		/// Total time of each phase
+		std::map<std::string, double> totalsMs;
+};
+
+#endif // PLANNERTIMING_H
@@ -0,0 +1,136 @@
+#ifndef POLICYBENCHMARK_H
+#define POLICYBENCHMARK_H
+
+// TreeVis
+#include "PlannerManager.h"
+
+// Qt
+#include <QString>
+#include <QStringList>
+#include <QJsonObject>
+
+#include <vector>
+
+///
+/// \brief The PolicyBenchmark class measures reading in saved policies
+/// and looking up actions in them. Policy files of increasing horizon
+/// are generated for built in problems and read in with
+/// PlannerManager::PreviousPlan(), recording the parse throughput of
+/// the action indexes and the latency of GetActionIndex() and
+/// GetJointActionIndex(). Small horizons are also planned live so the
+/// lookups of both kinds of plan can be compared.
+///
+/// Only built with qmake CONFIG+=benchmark, run with:
+/// MADP-TreeVis-benchmark --policy [--problems dectiger,firefighting]
+///                        [--horizons 4,8,12,14] [--live-horizons 2,3,4]
+///                        [--lookups <n>] [--seed <n>] [--json <file>]
+///
+class PolicyBenchmark {
+
+	public:
+		/// Results for one problem and horizon
+		struct Result {
+			/// Name of the problem
+			QString problem;
+			/// True for a live plan, false for a policy read from a file
+			bool live = false;
+			/// Horizon of the policy
+			Index horizon = 0;
+			/// Observation histories of the first agent
+			Index nrObservationHistories = 0;
+			/// Joint observation histories
+			double nrJointObservationHistories = 0;
+			/// Size of the policy file, 0 for live plans
+			qint64 fileBytes = 0;
+			/// Time for PreviousPlan(), including creating the problem, or to plan live
+			double loadMs = 0;
+			/// Time to parse just the action indexes
+			double parseMs = 0;
+			/// Megabytes of action indexes parsed per second
+			double parseMBPerSecond = 0;
+			/// Mean time of GetActionIndex() for random agents and histories
+			double actionLookupNs = 0;
+			/// \brief Mean time of GetJointActionIndex() for random joint histories,
+			/// 0 if there are too many to index
+			double jointActionLookupNs = 0;
+		};
+
+		///
+		/// \brief Constructor
+		/// \param lookupCount Number of lookups timed for each policy
+		/// \param randomSeed Seed for the generated policies and the lookups
+		///
+		PolicyBenchmark(const int &lookupCount, const unsigned int &randomSeed);
+		~PolicyBenchmark();
+
+		///
+		/// \brief Measures every problem and horizon, printing each result
+		/// \param problems The problems, as accepted by PlannerManager::GetBuiltInProblemArguments()
+		/// \param horizons Horizons to generate policy files for
+		/// \param liveHorizons Horizons to plan live with JESP
+		/// \return The results in the order measured
+		///
+		std::vector<Result> Run(const QStringList &problems,
+								const std::vector<Index> &horizons,
+								const std::vector<Index> &liveHorizons);
+
+		///
+		/// \brief Generates a policy file and measures reading it in
+		/// \param problem The problem
+		/// \param horizon The horizon
+		/// \param result Set to the result
+		/// \return False if the policy could not be written or read in
+		///
+		bool MeasurePreviousPlan(const QString &problem, const Index &horizon, Result &result);
+
+		///
+		/// \brief Plans live with JESP and measures the lookups
+		/// \param problem The problem
+		/// \param horizon The horizon
+		/// \param result Set to the result
+		/// \return False if planning failed
+		///
+		bool MeasureLivePlan(const QString &problem, const Index &horizon, Result &result);
+
+		///
+		/// \brief Checks if the policy benchmark was asked for
+		/// \param argc Number of command line arguments
+		/// \param argv Command line arguments
+		/// \return True if --policy was given
+		///
+		static bool IsRequested(int argc, char** argv);
+
+		///
+		/// \brief Parses the command line and runs the benchmark, the
+		/// application must already be created
+		/// \param arguments The application arguments
+		/// \return The exit code for the application
+		///
+		static int RunFromCommandLine(const QStringList &arguments);
+
+		///
+		/// \brief Converts a result to JSON
+		/// \param result The result
+		/// \return The result as an object
+		///
+		static QJsonObject ToJson(const Result &result);
+
+	private:
+		///
+		/// \brief Times random lookups on a plan that has been made or read in
+		/// \param manager The manager holding the plan
+		/// \param result Set to the lookup times
+		///
+		void MeasureLookups(PlannerManager &manager, Result &result);
+
+		/// Number of lookups timed
+		int lookups;
+
+		/// Seed for everything random
+		unsigned int seed;
+
+		/// Written by the lookups so they are not optimised away
+		volatile Index lookupChecksum = 0;
+};
+
+#endif // POLICYBENCHMARK_H
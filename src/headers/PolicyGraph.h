@@ -0,0 +1,62 @@
+#ifndef POLICYGRAPH_H
+#define POLICYGRAPH_H
+
+// TreeVis
+#include "AgentPolicy.h"
+#include "TreeVisGraphicsScene.h"
+
+#include <vector>
+
+///
+/// \brief The PolicyGraph class compresses the full tree of an agents
+/// policy into a directed acyclic graph by merging identical subtrees.
+/// Two subtrees are identical when they take the same action and
+/// have identical children for every observation, so a policy that
+/// repeats the same behaviour shows each behaviour only once, much
+/// like a finite state controller.
+///
+class PolicyGraph {
+
+	public:
+		///
+		/// \brief Constructor compresses the policy, working up from the
+		/// last level of the tree so each subtree is only compared once
+		/// \param agentPolicy The policy to compress
+		///
+		explicit PolicyGraph(const AgentPolicy &agentPolicy);
+		~PolicyGraph();
+
+		///
+		/// \brief Adds the nodes and edges of the graph to the scene.
+		/// Each level of the graph is one time step, edges with more than
+		/// one observation leading to the same node are merged into one.
+		/// \param scene The scene to add the graph to
+		/// \param nodePadding The space between nodes on a level
+		///
+		void AddToScene(TreeVisGraphicsScene* scene, const qreal &nodePadding) const;
+
+		/// \return The number of nodes in the graph
+		size_t GetNrNodes() const;
+
+	private:
+		/// A node of the graph, representing every identical subtree
+		struct GraphNode {
+			/// The action taken by the subtree
+			Index actionIndex;
+
+			/// \brief The first observation history index (left most in the
+			/// tree) with this subtree, used to show an example history
+			Index representativeOHIndex;
+
+			/// The node on the next level for each observation, empty on the last level
+			std::vector<Index> children;
+		};
+
+		/// The policy the graph represents
+		AgentPolicy policy;
+
+		/// The nodes of the graph on each level, indexed by [depth][node]
+		std::vector<std::vector<GraphNode>> levels;
+};
+
+#endif // POLICYGRAPH_H
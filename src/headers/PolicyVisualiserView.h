@@ -5,12 +5,15 @@
 #include "MainWindow.h"
 #include "PlannerManager.h"
 #include "TreeVisGraphicsView.h"
+#include "BeliefTracker.h"
 
 // Qt
 #include <QWidget>
 #include <QLayout>
 #include <QSplitter>
+#include <QTreeView>
 #include <QTreeWidget>
+#include <QSpinBox>
 #include <QPushButton>
 #include <QComboBox>
 #include <QGroupBox>
@@ -67,6 +70,13 @@ class PolicyVisualiserView : public QWidget {
 		///
 		void RecieveJointObservation(int joIndex);
 
+		///
+		/// \brief Slot called when the settings have been changed, restyles
+		/// and repositions the current visualisation rather than restarting it
+		/// \param fontChanged True if the node or edge font changed
+		///
+		void SettingsChanged(const bool &fontChanged);
+
 	private slots:
 		///
 		/// \brief Slot called when the Save Policy Visualiser
@@ -105,6 +115,16 @@ class PolicyVisualiserView : public QWidget {
 		/// \brief Slot for Match edge to probability checkbox pressed
 		void ChangeEdgeColourProbability(bool checked);
 
+		/// \brief Slot for the belief group box being checked. Tracking
+		/// started part way through replays the steps taken so far
+		void BeliefTrackingToggled(bool checked);
+
+		///
+		/// \brief Shows the most likely states of the tracked belief,
+		/// as many as the top states spin box allows
+		///
+		void UpdateBeliefView();
+
 	private:
 		///
 		/// \brief Creates the UI, sets up all widgets
@@ -131,6 +151,13 @@ class PolicyVisualiserView : public QWidget {
 		///
 		void UpdateTimeStepLabel();
 
+		///
+		/// \brief Gets the name to show for a state
+		/// \param stateIndex The state index
+		/// \return The name of the state if states are named, otherwise its index
+		///
+		QString GetStateName(const Index &stateIndex) const;
+
 		///
 		/// \brief Updates the probability label based
 		/// on the information in currentVisualisation
@@ -162,41 +189,6 @@ class PolicyVisualiserView : public QWidget {
 		///
 		double GetCurrentJointObservationProbability();
 
-		///
-		/// \brief GetIndidividualObservationProbability
-		/// \param agentIndex The agent index to get the probability for
-		/// \param observationIndex The individual observation index to get the
-		/// probability for
-		/// \param jointActionIndex The joint action index taken
-		/// \param stateIndex The state index
-		/// \param succStateIndex The successor state index
-		/// \return The probability of the agent recieving the individual
-		/// observation based on the
-		///
-		double GetIndidividualObservationProbability(const Index &agentIndex,
-													 const Index &observationIndex,
-													 const Index &jointActionIndex,
-													 const Index &stateIndex,
-													 const Index &succStateIndex);
-
-
-		///
-		/// \brief Gets the possible combinations of observations given the
-		/// observation numbers. The given agent index and observation index
-		/// ensure the combinations returned contain this individual observation
-		/// index for the given agent index. This method is used as a helper method
-		/// tfor ghte GetIndividualObservationProbability().
-		/// \param observationNumbers The number of possible observations for each agent
-		/// \param agentIndex The agent index to set the value of the observation index as
-		/// \param observationIndex The individual observation index to leave as the agent index
-		/// \return Each combination of observations with the agent indexs' observation
-		/// fixed as the observation index given
-		///
-		std::vector<std::vector<Index>> GetCombinations(const std::vector<size_t> &observationNumbers,
-														const int &agentIndex,
-														const int &observationIndex);
-
-
 		///
 		/// \brief Computes the individual observation probabilities based on
 		/// the data in current visualisation
@@ -207,16 +199,17 @@ class PolicyVisualiserView : public QWidget {
 
 
 		///
-		/// \brief Gets a tree widget containing all the Joint Observations
+		/// \brief Gets a view containing the possible Joint Observations
 		/// based on the information in currentVisualisation in the format
-		/// JOI | JO Name | Probability
+		/// JOI | JO Name | Probability. The view owns the JointObservationModel
+		/// it shows.
 		///
-		/// \param parent The item to make the parent of the tree widget,
+		/// \param parent The item to make the parent of the view,
 		/// if this is not given the returned pointer must be
 		/// reparented with setParent() otherwise it will be parentless
-		/// \return The constructed tree widget
+		/// \return The constructed view
 		///
-		QTreeWidget* GetJointObservationTreeWidget(QWidget* parent = 0);
+		QTreeView* GetJointObservationView(QWidget* parent = 0);
 
 		///
 		/// \brief Adds the next set of nodes to the visualistation
@@ -226,6 +219,15 @@ class PolicyVisualiserView : public QWidget {
 		///
 		void AddNextNodes(const std::vector<double> &individualProbabilities);
 
+		///
+		/// \brief Gets the position of an agents node based on the
+		/// spacing in currentVisualisation
+		/// \param timeStep The one indexed time step of the node
+		/// \param agentIndex The agent index of the node
+		/// \return The position of the node in the scene
+		///
+		QPointF GetNodePosition(const int &timeStep, const Index &agentIndex) const;
+
 		/// Height to pad from top of scene to nodes
 		const int padding = 75;
 
@@ -264,6 +266,8 @@ class PolicyVisualiserView : public QWidget {
 			Index successorStateIndex;
 			/// The number of agents in the visualisation
 			Index numAgents;
+			/// The joint action and joint observation of each step supplied
+			std::vector<std::pair<Index, Index>> jointActionObservations;
 
 			// Default values
 			CurrentVisualisationData() {
@@ -295,6 +299,15 @@ class PolicyVisualiserView : public QWidget {
 		/// The graphics view
 		TreeVisGraphicsView* graphicsView;
 
+		/// Belief over the states for the current visualisation, nullptr until planned
+		std::unique_ptr<BeliefTracker> beliefTracker;
+
+		// Belief widgets
+		QGroupBox* beliefGroupBox;
+		QSpinBox* beliefTopStatesSpinBox;
+		QLabel* beliefSupportLabel;
+		QTreeWidget* beliefTreeWidget;
+
 		// Initial state options
 		QComboBox* initialStateSelectionComboBox;
 		QGroupBox* initialStateOptionsGroupBox;
@@ -328,7 +341,7 @@ class PolicyVisualiserView : public QWidget {
 		QSplitter* splitter;
 
 		// End screen widgets
-		QTreeWidget* endProbabilityTreeWidget;
+		QTreeView* endProbabilityTreeView;
 		QLabel* endRewardLabel;
 		QLabel* endProbabilityLabel;
 
@@ -0,0 +1,126 @@
+#ifndef RENDERBENCHMARK_H
+#define RENDERBENCHMARK_H
+
+// TreeVis
+#include "AgentPolicy.h"
+
+// Qt
+#include <QString>
+#include <QStringList>
+#include <QJsonObject>
+
+#include <vector>
+
+///
+/// \brief The RenderBenchmark class measures how building and drawing
+/// full trees scales. Trees are built for synthetic policies over a grid
+/// of observation counts, horizons and label lengths. For each one it
+/// records the time to build the tree, the time to place every edge
+/// again, the peak memory, the item counts and the time to render a
+/// frame of the whole tree and a frame at full size.
+///
+/// Only built with qmake CONFIG+=benchmark, run with:
+/// MADP-TreeVis-benchmark [--observations 2,3,5] [--horizons 3,5,7,9]
+///                        [--label-lengths 4,16] [--max-nodes <n>]
+///                        [--repeats <n>] [--json <file>]
+///
+class RenderBenchmark {
+
+	public:
+		/// Results for one point of the grid
+		struct Result {
+			/// Number of observations, the branching factor
+			Index nrObservations = 0;
+			/// Horizon of the policy, the depth of the tree
+			Index horizon = 0;
+			/// Length of every action and observation name
+			int labelLength = 0;
+			/// Number of nodes in the scene
+			int nrNodes = 0;
+			/// Number of edges in the scene
+			int nrEdges = 0;
+			/// Number of items in the scene
+			int nrItems = 0;
+			/// Best time to build the tree
+			double buildMs = 0;
+			/// Best time to call Edge::UpdatePosition() on every edge
+			double updateEdgesMs = 0;
+			/// Best time to render the whole tree into one frame
+			double fitFrameMs = 0;
+			/// Best time to render a frame at full size around the root
+			double detailFrameMs = 0;
+			/// Peak resident memory while building and rendering, above what was used before
+			double peakMemoryMB = 0;
+		};
+
+		///
+		/// \brief Constructor
+		/// \param repeatCount Times each point is measured, the best time is kept
+		/// \param maxNodeCount Points with more nodes than this are skipped
+		///
+		RenderBenchmark(const int &repeatCount, const double &maxNodeCount);
+		~RenderBenchmark();
+
+		///
+		/// \brief Measures every point of the grid, printing each result
+		/// \param observationCounts The numbers of observations
+		/// \param horizons The horizons
+		/// \param labelLengths The lengths of the names
+		/// \return The results in the order measured
+		///
+		std::vector<Result> Run(const std::vector<Index> &observationCounts,
+								const std::vector<Index> &horizons,
+								const std::vector<int> &labelLengths);
+
+		///
+		/// \brief Measures one point of the grid
+		/// \param nrObservations Number of observations
+		/// \param horizon Horizon of the policy
+		/// \param labelLength Length of every name
+		/// \return The result
+		///
+		Result Measure(const Index &nrObservations, const Index &horizon, const int &labelLength);
+
+		///
+		/// \brief Creates a policy with three actions that picks an action
+		/// for each observation history by hashing its index
+		/// \param nrObservations Number of observations
+		/// \param horizon Horizon of the policy
+		/// \param labelLength Length of every name
+		/// \return The policy
+		///
+		static AgentPolicy CreateSyntheticPolicy(const Index &nrObservations,
+												 const Index &horizon,
+												 const int &labelLength);
+
+		///
+		/// \brief Parses the command line and runs the benchmark, the
+		/// application must already be created
+		/// \param arguments The application arguments
+		/// \return The exit code for the application
+		///
+		static int RunFromCommandLine(const QStringList &arguments);
+
+		///
+		/// \brief Converts a result to JSON
+		/// \param result The result
+		/// \return The result as an object
+		///
+		static QJsonObject ToJson(const Result &result);
+
+	private:
+		/// Times each point is measured
+		int repeats;
+
+		/// Points with more nodes are skipped
+		double maxNodes;
+
+		/// The space between nodes, as in the full tree view
+		const int paddingBetweenNodes = 20;
+
+		/// Size of the frames rendered, a full HD view
+		const int frameWidth = 1920;
+		const int frameHeight = 1080;
+};
+
+#endif // RENDERBENCHMARK_H
@@ -13,6 +13,7 @@
 #include <QFontComboBox>
 #include <QSpinBox>
 #include <QDialogButtonBox>
+#include <QCheckBox>
 
 ///
 /// \brief The SettingsDialog class provides a dialog window
@@ -31,6 +32,12 @@ class SettingsDialog : public QDialog {
 		SettingsDialog(QWidget* parent);
 		~SettingsDialog();
 
+		///
+		/// \brief Sets the default node and edge colours and fonts to the
+		/// saved settings, or the hard coded defaults if nothing has been saved
+		///
+		static void ApplySavedSettings();
+
 	private slots:
 		///
 		/// \brief Slot called when the node fill colour is updated
@@ -97,6 +104,15 @@ class SettingsDialog : public QDialog {
 		QFontComboBox* fontComboBox;
 		QSpinBox* fontSizeSpinBox;
 
+		// Rendering options
+		QComboBox* viewportComboBox;
+		QCheckBox* adaptiveAntialiasingCheckBox;
+		QCheckBox* frameStatisticsCheckBox;
+
+		// Planning options
+		QCheckBox* separateProcessCheckBox;
+		QSpinBox* memoryBudgetSpinBox;
+
 		// Live preview items
 		Node* nodeOne;
 		Node* nodeTwo;
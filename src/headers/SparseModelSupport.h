@@ -0,0 +1,80 @@
+#ifndef SPARSEMODELSUPPORT_H
+#define SPARSEMODELSUPPORT_H
+
+// MADP
+#include "DecPOMDPDiscreteInterface.h"
+#include "TransitionModelMappingSparse.h"
+#include "ObservationModelMappingSparse.h"
+
+#include <vector>
+
+///
+/// \brief The SparseModelSupport class gives the non-zero entries
+/// (the support) of the transition and observation models of a problem.
+/// When the problem stores its models as sparse matrices the entries
+/// are read directly from the matrices, so the work done is proportional
+/// to the number of non-zero entries rather than the number of states
+/// or joint observations. Other models fall back to checking every entry.
+///
+class SparseModelSupport {
+
+	public:
+		/// Index and probability of every non-zero entry
+		typedef std::vector<std::pair<Index, double>> SparseVector;
+
+		///
+		/// \brief Constructor finds the models of the problem
+		/// \param decpomdp The problem, must outlive this object
+		///
+		explicit SparseModelSupport(const DecPOMDPDiscreteInterface* decpomdp);
+		~SparseModelSupport();
+
+		///
+		/// \brief Gets the successor states that can be reached
+		/// \param stateIndex The current state index
+		/// \param jointActionIndex The joint action index taken
+		/// \return Each successor state index with P(s'|s,ja) > 0
+		///
+		SparseVector GetSuccessorStates(const Index &stateIndex,
+										const Index &jointActionIndex) const;
+
+		///
+		/// \brief Gets the joint observations that can be recieved
+		/// \param stateIndex The state index the joint action was taken in
+		/// \param jointActionIndex The joint action index taken
+		/// \param succStateIndex The successor state index
+		/// \return Each joint observation index with P(jo|s,ja,s') > 0
+		///
+		SparseVector GetJointObservations(const Index &stateIndex,
+										  const Index &jointActionIndex,
+										  const Index &succStateIndex) const;
+
+		/// \return True if the transition model is read as a sparse matrix
+		bool IsTransitionModelSparse() const;
+
+		/// \return True if the observation model is read as a sparse matrix
+		bool IsObservationModelSparse() const;
+
+	private:
+		/// Matrix type of the MADP sparse models
+		typedef boost::numeric::ublas::compressed_matrix<double> SparseMatrix;
+
+		///
+		/// \brief Gets the non-zero entries of a row of a sparse matrix
+		/// \param matrix The matrix
+		/// \param row The row to get the entries of
+		/// \return The column index and value of each non-zero entry
+		///
+		static SparseVector GetRow(const SparseMatrix* matrix, const Index &row);
+
+		/// The problem the models belong to
+		const DecPOMDPDiscreteInterface* problem;
+
+		/// The transition model, nullptr if it is not sparse
+		const TransitionModelMappingSparse* transitionModel = nullptr;
+
+		/// The observation model, nullptr if it is not sparse
+		const ObservationModelMappingSparse* observationModel = nullptr;
+};
+
+#endif // SPARSEMODELSUPPORT_H
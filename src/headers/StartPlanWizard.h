@@ -57,12 +57,34 @@ class StartPlanWizard : public QWizard {
 		///
 		void StartPlan(PlannerManager::PlannerType type, ArgumentHandlers::Arguments args);
 
+	protected:
+		///
+		/// \brief Checks the plan fits the machine before finishing,
+		/// estimating its memory and running time
+		/// \return False to stay on the page
+		///
+		bool validateCurrentPage();
+
 	private slots:
 		/// \brief Finish button clicked on the wizard,
 		/// emit the stat plan signal as finished
 		void FinishButtonClicked();
 
 	private:
+		///
+		/// \brief Gets the arguments from every page for the planner chosen
+		/// \param type The planner chosen
+		/// \return The arguments, dpf allocated with new[] when parsing
+		///
+		ArgumentHandlers::Arguments GetArguments(const PlannerManager::PlannerType &type);
+
+		///
+		/// \brief Estimates the cost of the plan chosen and asks the user
+		/// whether to go ahead if it may not fit, or tells them it cannot
+		/// \return True to plan
+		///
+		bool ConfirmPlanCost();
+
 		///
 		/// \brief Gets the planner type chosen by the user
 		/// \return The type of planner chosen by the user
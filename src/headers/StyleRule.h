@@ -0,0 +1,72 @@
+#ifndef STYLERULE_H
+#define STYLERULE_H
+
+// TreeVis
+#include "Node.h"
+#include "Edge.h"
+
+// Qt
+#include <QColor>
+#include <QString>
+
+///
+/// \brief The StyleRule struct colours every node or edge in a scene
+/// that matches it, rather than a single item. Rules are kept by the
+/// scene so items built later, such as by expanding a node, are
+/// coloured as well.
+///
+struct StyleRule {
+	/// What the rule matches on
+	enum target {
+		/// Nodes whose action name is the text
+		NodesWithAction,
+		/// Edges whose observation name is the text
+		EdgesWithObservation,
+		/// Nodes at the depth (zero indexed time step)
+		NodesAtDepth
+	};
+
+	/// What the rule matches on
+	target type = NodesWithAction;
+
+	/// The action or observation name to match
+	QString text;
+
+	/// The depth to match for NodesAtDepth
+	Index depth = 0;
+
+	/// The fill colour for nodes or line colour for edges
+	QColor colour;
+
+	/// \return True if the rule applies to nodes
+	bool IsForNodes() const {
+		return type != EdgesWithObservation;
+	}
+
+	///
+	/// \brief Checks if the rule applies to a node
+	/// \param node The node to check
+	/// \return True if the node should be coloured
+	///
+	bool Matches(const Node* node) const {
+		switch(type) {
+			case NodesWithAction:
+				return node->GetText() == text;
+			case NodesAtDepth:
+				return node->GetTimeStep() == depth;
+			default:
+				return false;
+		}
+	}
+
+	///
+	/// \brief Checks if the rule applies to an edge
+	/// \param edge The edge to check
+	/// \return True if the edge should be coloured
+	///
+	bool Matches(const Edge* edge) const {
+		return type == EdgesWithObservation && edge->GetLabelText() == text;
+	}
+};
+
+#endif // STYLERULE_H
@@ -0,0 +1,107 @@
+#ifndef SYNTHETICGENERATOR_H
+#define SYNTHETICGENERATOR_H
+
+// TreeVis
+#include "AgentPolicy.h"
+
+// Qt
+#include <QString>
+#include <QStringList>
+
+#include <ostream>
+#include <random>
+#include <vector>
+
+///
+/// \brief The SyntheticGenerator class writes random but valid policy
+/// files, in the format PlannerManager::PreviousPlan() reads, so large
+/// trees can be tried without planning them. The policy can be for an
+/// existing problem, or for a synthetic .dpomdp problem with the number
+/// of agents, states, actions and observations chosen, which is written
+/// alongside it with random transitions, observations and rewards.
+///
+/// Run with:
+/// MADP-TreeVis --generate --horizon <h> [--problem <file.dpomdp or built in name>]
+///              [--agents <n>] [--states <n>] [--actions <n,...>] [--observations <n,...>]
+///              [--problem-out <file.dpomdp>] [--policy-out <file>] [--seed <n>]
+///
+class SyntheticGenerator {
+
+	public:
+		///
+		/// \brief Constructor
+		/// \param randomSeed Seed for everything generated
+		///
+		SyntheticGenerator(const unsigned int &randomSeed);
+		~SyntheticGenerator();
+
+		///
+		/// \brief Writes a problem where every transition, observation
+		/// and reward is random
+		/// \param filePath Where to write the .dpomdp file
+		/// \param nrStates Number of states
+		/// \param nrActions Number of actions of each agent
+		/// \param nrObservations Number of observations of each agent
+		/// \return False if the file could not be written
+		///
+		bool WriteProblemFile(const QString &filePath,
+							  const Index &nrStates,
+							  const std::vector<Index> &nrActions,
+							  const std::vector<Index> &nrObservations);
+
+		///
+		/// \brief Writes a policy file choosing a random action for every
+		/// observation history
+		/// \param filePath Where to write the file
+		/// \param horizon The horizon of the policy
+		/// \param numObservationHistories Number of observation histories of each agent
+		/// \param numActions Number of actions of each agent
+		/// \return The number of bytes before the first action index, -1 if
+		/// the file could not be written
+		///
+		qint64 WritePolicyFile(const QString &filePath,
+							   const Index &horizon,
+							   const std::vector<Index> &numObservationHistories,
+							   const std::vector<Index> &numActions);
+
+		///
+		/// \brief Counts the observation histories of each agent, the sum of
+		/// nrObservations^t over the time steps
+		/// \param nrObservations Number of observations of each agent
+		/// \param horizon The horizon
+		/// \param numObservationHistories Set to the count for each agent
+		/// \return False if a count is too large to index
+		///
+		static bool CountObservationHistories(const std::vector<Index> &nrObservations,
+											  const Index &horizon,
+											  std::vector<Index> &numObservationHistories);
+
+		///
+		/// \brief Checks if the application was started to generate
+		/// \param argc Number of command line arguments
+		/// \param argv Command line arguments
+		/// \return True if --generate was given
+		///
+		static bool IsRequested(int argc, char** argv);
+
+		///
+		/// \brief Parses the command line and generates the files, the
+		/// application must already be created
+		/// \param arguments The application arguments
+		/// \return The exit code for the application
+		///
+		static int RunFromCommandLine(const QStringList &arguments);
+
+	private:
+		///
+		/// \brief Writes a random probability distribution on one line
+		/// \param output The stream to write to
+		/// \param size Number of probabilities
+		///
+		void WriteDistribution(std::ostream &output, const Index &size);
+
+		/// Generates everything random
+		std::mt19937 generator;
+};
+
+#endif // SYNTHETICGENERATOR_H
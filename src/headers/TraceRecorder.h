@@ -0,0 +1,194 @@
+#ifndef TRACERECORDER_H
+#define TRACERECORDER_H
+
+// Qt
+#include <QString>
+#include <QtGlobal>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+///
+/// \brief The TraceRecorder class records spans of time across planning,
+/// loading policies and building the visualisations, and writes them in
+/// the Chrome trace event format to be opened in chrome://tracing or
+/// Perfetto. Each thread records into its own fixed size ring buffer so
+/// recording takes no shared lock, the oldest spans being overwritten
+/// once a buffer is full. Nothing is recorded until recording is turned on.
+///
+/// Spans recorded by a child process, such as one planning, are sent to
+/// this process as text and written under the child's own process id.
+/// They share one more ring buffer of the same size, so the spans of the
+/// oldest child processes are overwritten first.
+///
+class TraceRecorder {
+
+	public:
+		/// A span of time on one thread
+		struct Event {
+			/// Name shown for the span, must outlive the recorder
+			const char* name = nullptr;
+			/// Category the span can be filtered by, must outlive the recorder
+			const char* category = nullptr;
+			/// Start in microseconds since the recorder was first used
+			qint64 startUs = 0;
+			/// Length in microseconds
+			qint64 durationUs = 0;
+		};
+
+		///
+		/// \brief Turns recording on or off, spans already recorded are kept
+		/// \param enable True to record
+		///
+		static void SetEnabled(const bool &enable);
+
+		/// \return True if spans are being recorded
+		static bool IsEnabled();
+
+		/// \return Microseconds since the recorder was first used
+		static qint64 NowUs();
+
+		///
+		/// \brief Records a span on the calling thread
+		/// \param name Name of the span, a string literal or from Intern()
+		/// \param category Category of the span, a string literal or from Intern()
+		/// \param startUs Start from NowUs()
+		/// \param durationUs Length in microseconds
+		///
+		static void Record(const char* name, const char* category, const qint64 &startUs, const qint64 &durationUs);
+
+		///
+		/// \brief Keeps a copy of a name for as long as the recorder exists,
+		/// for names that are not string literals
+		/// \param name The name
+		/// \return The copy, the same pointer for equal names
+		///
+		static const char* Intern(const std::string &name);
+
+		/// Forgets every span recorded
+		static void Clear();
+
+		///
+		/// \brief Writes every span recorded as a Chrome trace JSON file
+		/// \param filePath Where to write the file
+		/// \return False if the file could not be written
+		///
+		static bool WriteChromeTrace(const QString &filePath);
+
+		///
+		/// \brief Writes every span recorded, one per line, for another
+		/// process to add with AddProcessEvent()
+		/// \param output Where to write the lines
+		/// \param prefix Written at the start of each line
+		///
+		static void WriteEvents(std::ostream &output, const std::string &prefix);
+
+		///
+		/// \brief Adds a span written by WriteEvents() in another process,
+		/// written to the trace under that process
+		/// \param processId The id of the other process
+		/// \param processName Name shown for the other process
+		/// \param line The line, after the prefix
+		/// \return False if the line was not a span
+		///
+		static bool AddProcessEvent(const qint64 &processId, const QString &processName, const QString &line);
+
+	private:
+		/// A span recorded by another process
+		struct ProcessEvent {
+			/// Id of the process
+			qint64 processId = 0;
+			/// Name shown for the process
+			QString processName;
+			/// Thread id within the process
+			int threadId = 0;
+			/// Name of the span
+			QString name;
+			/// Category of the span
+			QString category;
+			/// Start in microseconds since this recorder was first used
+			qint64 startUs = 0;
+			/// Length in microseconds
+			qint64 durationUs = 0;
+		};
+
+		/// \return Microseconds from the start of the steady clock to the recorder's first use,
+		/// the same clock in every process on the machine
+		static qint64 EpochUs();
+
+		/// Spans recorded by one thread
+		struct ThreadBuffer {
+			/// Ring of spans, oldest overwritten first
+			std::vector<Event> events;
+			/// Where the next span is written
+			size_t next = 0;
+			/// Spans recorded since cleared, including those overwritten
+			size_t recorded = 0;
+			/// Trace thread id
+			int threadId = 0;
+			/// Name shown for the thread
+			QString threadName;
+			/// \brief Only contended while the trace is being written,
+			/// so recording stays cheap
+			std::mutex mutex;
+		};
+
+		/// \return The buffer of the calling thread, created on first use
+		static ThreadBuffer* GetThreadBuffer();
+
+		/// If spans are being recorded
+		static std::atomic<bool> enabled;
+
+		/// Guards the list of buffers and the interned names
+		static std::mutex registryMutex;
+
+		/// Every thread's buffer, kept after the thread ends so its spans can be written
+		static std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+
+		/// Ring of the spans of other processes, oldest overwritten first,
+		/// guarded by the registry mutex
+		static std::vector<ProcessEvent> processEvents;
+
+		/// Where the next span of another process is written once the ring is full
+		static size_t nextProcessEvent;
+
+		/// Spans kept for each thread, and for all other processes together
+		static const size_t bufferSize = 1 << 16;
+};
+
+///
+/// \brief The TraceSpan class records the time from its construction to
+/// its destruction as a span, when the TraceRecorder is recording.
+///
+class TraceSpan {
+
+	public:
+		///
+		/// \brief Starts the span
+		/// \param spanName Name of the span, a string literal or from TraceRecorder::Intern()
+		/// \param spanCategory Category of the span
+		///
+		TraceSpan(const char* spanName, const char* spanCategory = "treevis");
+
+		/// Ends the span and records it
+		~TraceSpan();
+
+		TraceSpan(const TraceSpan&) = delete;
+		TraceSpan& operator=(const TraceSpan&) = delete;
+
+	private:
+		/// Name of the span
+		const char* name;
+
+		/// Category of the span
+		const char* category;
+
+		/// Start of the span, -1 if the recorder was not recording
+		qint64 startUs;
+};
+
+#endif // TRACERECORDER_H
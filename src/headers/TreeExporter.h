@@ -0,0 +1,127 @@
+#ifndef TREEEXPORTER_H
+#define TREEEXPORTER_H
+
+// TreeVis
+#include "AgentPolicy.h"
+#include "TreeLayout.h"
+
+// Qt
+#include <QString>
+#include <QPainter>
+
+// Smart pointers
+#include <memory>
+#include <functional>
+
+///
+/// \brief The TreeExporter class writes the full tree of an agents
+/// policy straight to a file from the layout, without creating a
+/// scene. The tree is walked level by level and only the nodes and
+/// edges in the region being drawn are visited, so the memory used does
+/// not depend on the size of the tree. Trees too big to display can
+/// therefore still be exported.
+///
+class TreeExporter {
+
+	public:
+		///
+		/// \brief Constructor lays out the policy using the current fonts
+		/// \param agentPolicy The policy to export
+		/// \param nodePadding The space between nodes on the bottom level
+		///
+		TreeExporter(const AgentPolicy &agentPolicy, const qreal &nodePadding);
+		~TreeExporter();
+
+		///
+		/// \brief Writes the tree to an SVG file, the SVG is written as
+		/// the tree is walked rather than built up in memory first
+		/// \param filePath The path of the file to write
+		/// \return True if the file was written
+		///
+		bool ExportToSVG(const QString &filePath) const;
+
+		///
+		/// \brief Writes the tree to a PDF file. Large trees are split
+		/// over several pages so each page stays within PDF size limits
+		/// \param filePath The path of the file to write
+		/// \return True if the file was written
+		///
+		bool ExportToPDF(const QString &filePath) const;
+
+		///
+		/// \brief Writes the tree to a grid of PNG images. Each tile is named
+		/// after the file path with its row and column, e.g. tree_r0_c1.png
+		/// \param filePath The path the tile names are based on
+		/// \param tileSize The width and height of each tile in pixels
+		/// \return True if every tile was written
+		///
+		bool ExportToTiledPNG(const QString &filePath, const int &tileSize = defaultTileSize) const;
+
+		///
+		/// \brief Paints the nodes and edges inside the region, the painter
+		/// must already be transformed so the region is where it should be drawn
+		/// \param painter The painter to paint with
+		/// \param region The region of the tree to paint
+		///
+		void PaintRegion(QPainter* painter, const QRectF &region) const;
+
+		///
+		/// \brief Paints an edge with the default colours and font,
+		/// its label placed the same as an Edge in a scene
+		/// \param painter The painter to paint with
+		/// \param from The centre of the node the edge is from
+		/// \param to The centre of the node the edge goes to
+		/// \param label The label of the edge
+		///
+		static void PaintEdge(QPainter* painter, const QPointF &from, const QPointF &to, const QString &label);
+
+		///
+		/// \brief Paints a node with the default colours and font
+		/// \param painter The painter to paint with
+		/// \param centre The centre of the node
+		/// \param text The text in the centre of the node
+		///
+		static void PaintNode(QPainter* painter, const QPointF &centre, const QString &text);
+
+		/// \return The area covered by the whole tree
+		QRectF GetTreeRect() const;
+
+		/// Default width and height of a PNG tile
+		static const int defaultTileSize = 4096;
+
+	private:
+		///
+		/// \brief Visits the edges and nodes that may be in the region, level
+		/// by level. The edges going into a level are visited before the
+		/// nodes above them so nodes are drawn over the edges.
+		/// \param region The region of the tree to visit
+		/// \param edgeFunction Called with the start, end and label of each edge
+		/// \param nodeFunction Called with the centre and action of each node
+		///
+		void ForEachItemInRegion(const QRectF &region,
+								 const std::function<void(const QPointF&, const QPointF&, const QString&)> &edgeFunction,
+								 const std::function<void(const QPointF&, const QString&)> &nodeFunction) const;
+
+		///
+		/// \brief Gets the positions on a level with nodes between the two x values
+		/// \param depth The depth of the level
+		/// \param left The left most x value
+		/// \param right The right most x value
+		/// \param first Set to the first position in the range
+		/// \param last Set to the last position in the range
+		/// \return False if no nodes on the level are in the range
+		///
+		bool GetPositionsInRange(const Index &depth, const qreal &left, const qreal &right,
+								 Index &first, Index &last) const;
+
+		/// The policy being exported
+		AgentPolicy policy;
+
+		/// Position of every node in the tree
+		std::unique_ptr<TreeLayout> layout;
+
+		/// Largest PDF page side in points, the PDF limit is 200 inches
+		const qreal maxPDFPageSize = 14400;
+};
+
+#endif // TREEEXPORTER_H
@@ -0,0 +1,154 @@
+#ifndef TREELAYOUT_H
+#define TREELAYOUT_H
+
+// TreeVis
+#include "AgentPolicy.h"
+
+// Qt
+#include <QPointF>
+#include <QRectF>
+
+#include <vector>
+
+///
+/// \brief The TreeLayout class computes where each node of a full
+/// policy tree is placed using only index arithmetic on the
+/// observation history indexes. Every leaf is given a slot of
+/// equal width and a parent is centred over the leaves beneath it,
+/// so the position of any node can be found without creating
+/// any of the other nodes in the tree.
+///
+/// Observation history indexes follow the MADP numbering where the
+/// root is index 0 and the child of ohIndex for observation o is
+/// (nrObservations * ohIndex) + o + 1.
+///
+class TreeLayout {
+
+	public:
+		///
+		/// \brief Constructor
+		/// \param nrObs The number of observations of the agent
+		/// \param hor The horizon of the policy
+		/// \param slot The width given to each leaf of the tree
+		/// \param separation The vertical distance between levels of the tree
+		///
+		TreeLayout(const size_t &nrObs, const Index &hor, const qreal &slot, const qreal &separation);
+
+		///
+		/// \brief Gets the depth (time step) of an observation history index
+		/// \param ohIndex The observation history index
+		/// \return The depth, 0 being the root
+		///
+		Index GetDepth(const Index &ohIndex) const;
+
+		///
+		/// \brief Gets the first (left most) observation history index on a level
+		/// \param depth The depth of the level
+		/// \return The observation history index of the left most node
+		///
+		Index GetFirstOHIndexAtDepth(const Index &depth) const;
+
+		///
+		/// \brief Gets the number of nodes on a level of the tree
+		/// \param depth The depth of the level
+		/// \return nrObservations^depth
+		///
+		Index GetNrNodesAtDepth(const Index &depth) const;
+
+		///
+		/// \brief Gets the observation history index of a child
+		/// \param ohIndex The observation history index of the parent
+		/// \param observationIndex The observation leading to the child
+		/// \return The observation history index of the child
+		///
+		Index GetChildOHIndex(const Index &ohIndex, const Index &observationIndex) const;
+
+		///
+		/// \brief Gets the observation history index of the parent. Must not be the root.
+		/// \param ohIndex The observation history index of the child
+		/// \return The observation history index of the parent
+		///
+		Index GetParentOHIndex(const Index &ohIndex) const;
+
+		///
+		/// \brief Gets the last observation of a history. Must not be the root.
+		/// \param ohIndex The observation history index
+		/// \return The observation index of the edge into the node
+		///
+		Index GetLastObservationIndex(const Index &ohIndex) const;
+
+		///
+		/// \brief Gets the observation history index reached by following
+		/// the observations from the root. Must be shorter than the horizon.
+		/// \param observationIndexes The observation indexes, first to last
+		/// \return The observation history index
+		///
+		Index GetOHIndex(const std::vector<Index> &observationIndexes) const;
+
+		///
+		/// \brief Gets the observations leading from the root to a node
+		/// \param ohIndex The observation history index
+		/// \return The observation indexes, first to last. Empty for the root.
+		///
+		std::vector<Index> GetObservationIndexes(Index ohIndex) const;
+
+		///
+		/// \brief Checks if a node is on the last level of the tree
+		/// \param ohIndex The observation history index
+		/// \return True if the node has no children
+		///
+		bool IsLeaf(const Index &ohIndex) const;
+
+		///
+		/// \brief Gets the centre position of the node for the observation history index
+		/// \param ohIndex The observation history index
+		/// \return The position in scene coordinates
+		///
+		QPointF GetPosition(const Index &ohIndex) const;
+
+		///
+		/// \brief Gets the width taken by the subtree under a node on the given level
+		/// \param depth The depth of the node
+		/// \return The width of the subtree in scene coordinates
+		///
+		qreal GetSubtreeWidth(const Index &depth) const;
+
+		/// \return The rect the whole tree occupies once fully expanded
+		QRectF GetSceneRect() const;
+
+		/// \return The number of observations per node
+		size_t GetNrObservations() const;
+
+		/// \return The horizon of the tree
+		Index GetHorizon() const;
+
+		/// \return The total number of observation histories in the tree
+		Index GetNrOHIndexes() const;
+
+		/// \return The width of a leaf slot
+		qreal GetSlotWidth() const;
+
+		/// \return The vertical separation between levels
+		qreal GetLevelSeparation() const;
+
+	private:
+		/// Number of observations, the branching factor of the tree
+		size_t nrObservations;
+
+		/// Horizon, the number of levels of the tree
+		Index horizon;
+
+		/// Width of each leaf slot
+		qreal slotWidth;
+
+		/// Vertical space between each level
+		qreal levelSeparation;
+
+		/// The first observation history index for each depth, horizon+1 entries
+		std::vector<Index> firstOHIndexAtDepth;
+
+		/// Number of leaves below a node at each depth
+		std::vector<qreal> leavesBelowDepth;
+};
+
+#endif // TREELAYOUT_H
@@ -0,0 +1,125 @@
+#ifndef TREEOVERVIEWWIDGET_H
+#define TREEOVERVIEWWIDGET_H
+
+// TreeVis
+#include "TreeLayout.h"
+#include "TreeVisGraphicsScene.h"
+#include "Node.h"
+
+// Qt
+#include <QWidget>
+#include <QGraphicsView>
+#include <QImage>
+#include <QTransform>
+
+///
+/// \brief The TreeOverviewWidget class is a small overview of a whole
+/// full tree drawn over the corner of a view. The outline of the tree
+/// is drawn once from the layout, without any items, and the nodes that
+/// have been built are drawn over it as they are added to the scene.
+/// The area shown in the view is outlined, clicking or dragging in the
+/// overview centres the view on that point.
+///
+class TreeOverviewWidget : public QWidget {
+	Q_OBJECT
+
+	public:
+		///
+		/// \brief Constructor, the overview is hidden until a tree is set
+		/// \param graphicsView The view to navigate, also the parent
+		///
+		TreeOverviewWidget(QGraphicsView* graphicsView);
+		~TreeOverviewWidget();
+
+		///
+		/// \brief Sets the tree to show, drawing the outline of the
+		/// tree again. Call again if the layout is replaced.
+		/// \param treeLayout The layout of the tree, nullptr to hide the overview
+		/// \param treeScene The scene the tree is built into
+		///
+		void SetTree(const TreeLayout* treeLayout, TreeVisGraphicsScene* treeScene);
+
+	protected:
+		/// Draws the cached images and the area shown in the view
+		void paintEvent(QPaintEvent* event);
+
+		/// Centres the view on the point pressed
+		void mousePressEvent(QMouseEvent* event);
+
+		/// Centres the view on the point dragged to
+		void mouseMoveEvent(QMouseEvent* event);
+
+		///
+		/// \brief Keeps the overview in the corner of the view when it is resized
+		/// \param watched The view
+		/// \param event The event on the view
+		/// \return False, the event is not consumed
+		///
+		bool eventFilter(QObject* watched, QEvent* event);
+
+	private slots:
+		///
+		/// \brief Draws a node added to the scene onto the cached image
+		/// \param node The node added
+		///
+		void NodeAdded(Node* node);
+
+		/// Marks the built nodes to be drawn again on the next paint
+		void NodeRemoved();
+
+	private:
+		/// \brief Draws the outline of the whole tree from the layout. Levels
+		/// with more nodes than pixels are drawn as a single band.
+		void DrawTreeImage();
+
+		/// Draws every built node again, after nodes have been removed
+		void DrawBuiltImage();
+
+		///
+		/// \brief Draws a built node onto the built image
+		/// \param painter Painter on the built image
+		/// \param node The node to draw
+		///
+		void DrawBuiltNode(QPainter &painter, const Node* node);
+
+		/// Moves the overview to the top right corner of the view
+		void UpdatePosition();
+
+		///
+		/// \brief Centres the view on a point in the overview
+		/// \param point The point in the overview
+		///
+		void CentreViewOn(const QPoint &point);
+
+		/// The view being navigated
+		QGraphicsView* view;
+
+		/// The layout of the tree shown, nullptr if none
+		const TreeLayout* layout = nullptr;
+
+		/// The scene the tree is built into, nullptr if none
+		TreeVisGraphicsScene* scene = nullptr;
+
+		/// The outline of the whole tree
+		QImage treeImage;
+
+		/// The nodes built so far, transparent elsewhere
+		QImage builtImage;
+
+		/// If the built image needs drawing again before the next paint
+		bool builtImageDirty = false;
+
+		/// Maps scene coordinates to the overview
+		QTransform sceneToOverview;
+
+		/// Width and height of the overview
+		static const int overviewSize = 200;
+
+		/// Space between the overview and the edge of the view
+		static const int overviewMargin = 10;
+
+		/// Size of a built node in the overview
+		static const int builtNodeSize = 3;
+};
+
+#endif // TREEOVERVIEWWIDGET_H
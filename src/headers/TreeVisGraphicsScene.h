@@ -4,23 +4,34 @@
 // TreeVis
 #include "Node.h"
 #include "Edge.h"
+#include "StyleRule.h"
 
 // Qt
 #include <QGraphicsScene>
 #include <QAction>
 #include <QMenu>
+#include <QHash>
+#include <QSet>
+#include <QPair>
 
 #include <iostream>
+#include <vector>
 
 
 ///
 /// \brief The TreeVisGraphicsScene class provides extra functionality
-/// for context menus for edges and node object types.
+/// for context menus for edges and node object types. Nodes and edges
+/// added through AddNode() and AddEdge() are indexed by agent, time step
+/// and observation history index so lookups and bulk changes only visit
+/// the items they affect rather than every item in the scene.
 ///
 class TreeVisGraphicsScene : public QGraphicsScene {
 	Q_OBJECT
 
 	public:
+		/// Identifies a node by (agent index, observation history index)
+		typedef QPair<Index, Index> NodeKey;
+
 		///
 		/// \brief Constructor. Creates context menu actions and
 		/// connects slots.
@@ -29,6 +40,101 @@ class TreeVisGraphicsScene : public QGraphicsScene {
 		TreeVisGraphicsScene(QWidget* parent = 0);
 		~TreeVisGraphicsScene();
 
+		///
+		/// \brief Adds the node to the scene and records it against its
+		/// agent, time step and observation history index
+		/// \param node The node to add, the scene takes ownership
+		/// \param timeStep The zero indexed time step (depth) of the node
+		///
+		void AddNode(Node* node, const Index &timeStep);
+
+		///
+		/// \brief Adds the edge to the scene and records it against
+		/// the node it goes to
+		/// \param edge The edge to add, the scene takes ownership
+		///
+		void AddEdge(Edge* edge);
+
+		///
+		/// \brief Gets a node added with AddNode()
+		/// \param agentIndex The agent index of the node
+		/// \param ohIndex The observation history index of the node
+		/// \return The node or nullptr if it is not in the scene
+		///
+		Node* GetNode(const Index &agentIndex, const Index &ohIndex) const;
+
+		///
+		/// \brief Removes and deletes the node and the edges going into it
+		/// \param agentIndex The agent index of the node
+		/// \param ohIndex The observation history index of the node
+		///
+		void RemoveNode(const Index &agentIndex, const Index &ohIndex);
+
+		/// \return The nodes added with AddNode()
+		const QHash<NodeKey, Node*>& GetNodes() const;
+
+		///
+		/// \brief Gets the nodes on a time step
+		/// \param timeStep The zero indexed time step
+		/// \return The nodes, empty if there are none
+		///
+		QSet<Node*> GetNodesAtTimeStep(const Index &timeStep) const;
+
+		///
+		/// \brief Gets the nodes of an agent
+		/// \param agentIndex The agent index
+		/// \return The nodes, empty if there are none
+		///
+		QSet<Node*> GetNodesForAgent(const Index &agentIndex) const;
+
+		/// \return The edges added with AddEdge()
+		const QSet<Edge*>& GetEdges() const;
+
+		///
+		/// \brief Highlights the node, removing the highlight from
+		/// the node highlighted before if it is still in the scene
+		/// \param agentIndex The agent index of the node
+		/// \param ohIndex The observation history index of the node
+		///
+		void HighlightNode(const Index &agentIndex, const Index &ohIndex);
+
+		///
+		/// \brief Colours every node or edge matching the rule in one pass
+		/// with a single repaint of the scene. The rule is kept and applied
+		/// to matching items added afterwards.
+		/// \param rule The rule to add
+		///
+		void AddStyleRule(const StyleRule &rule);
+
+		/// \brief Removes every rule, items they coloured go back
+		/// to the default colours
+		void ClearStyleRules();
+
+		/// \return The rules in the order they were added, later rules take priority
+		const std::vector<StyleRule>& GetStyleRules() const;
+
+		///
+		/// \brief Sets whether the lines of the edges are drawn together,
+		/// grouped by colour, rather than by each edge. Fewer draw calls
+		/// suits OpenGL viewports where each call has a fixed cost.
+		/// \param batch True to draw the lines together
+		///
+		void SetBatchEdgeLines(const bool &batch);
+
+		/// \brief Removes and deletes every item, including those
+		/// added with AddNode() and AddEdge(). Style rules are kept.
+		void Clear();
+
+		///
+		/// \brief Restyles the nodes and edges in the scene after the default
+		/// colours or fonts have changed, without recreating them
+		/// \param fontChanged True if the node font changed, nodes only need
+		/// updating if their size may have changed
+		/// \param placeEdges False if the caller has already placed the edges
+		/// for the new font, such as from geometry shared between edges
+		///
+		void RefreshItemStyles(const bool &fontChanged, const bool &placeEdges = true);
+
 	protected:
 		///
 		/// \brief Context menu event on the scene, a right click.
@@ -36,6 +142,14 @@ class TreeVisGraphicsScene : public QGraphicsScene {
 		///
 		void contextMenuEvent(QGraphicsSceneContextMenuEvent* event);
 
+		///
+		/// \brief Draws the lines of the edges in the exposed area when
+		/// they are batched, behind every item
+		/// \param painter The painter to draw with
+		/// \param rect The exposed area in scene coordinates
+		///
+		void drawBackground(QPainter* painter, const QRectF &rect);
+
 
 	signals:
 		///
@@ -45,6 +159,31 @@ class TreeVisGraphicsScene : public QGraphicsScene {
 		///
 		void DisplayObservationHistoryForNode(Node* node);
 
+		///
+		/// \brief Signals the children of the node should be built
+		/// \param node The node selected to expand
+		///
+		void ExpandNode(Node* node);
+
+		///
+		/// \brief Signals the children of the node should be removed
+		/// \param node The node selected to collapse
+		///
+		void CollapseNode(Node* node);
+
+		///
+		/// \brief Signals a node has been added with AddNode()
+		/// \param node The node added
+		///
+		void NodeAdded(Node* node);
+
+		///
+		/// \brief Signals a node is being removed with RemoveNode(),
+		/// it is no longer in GetNodes() and is deleted afterwards
+		/// \param node The node being removed
+		///
+		void NodeRemoved(Node* node);
+
 	private slots:
 		///
 		/// \brief Changes the currently selected item (either edge or node)
@@ -73,7 +212,29 @@ class TreeVisGraphicsScene : public QGraphicsScene {
 		///
 		void ViewNodeObservationHistory();
 
+		/// Expands the selected node. Called from the context menu
+		void ExpandSelectedNode();
+
+		/// Collapses the selected node. Called from the context menu
+		void CollapseSelectedNode();
+
+		///
+		/// \brief Adds a rule matching the selected node or edge.
+		/// Called from the context menu
+		/// \param type What the rule matches on
+		/// \param id The id of the colour chosen in the menu
+		///
+		void AddStyleRuleForSelection(const StyleRule::target &type, const int &id);
+
 	private:
+		///
+		/// \brief Colours the items matching a rule without repainting them,
+		/// the caller repaints the scene
+		/// \param rule The rule to match items with
+		/// \param colour The colour to give them, invalid for the default
+		///
+		void ApplyStyleRule(const StyleRule &rule, const QColor &colour);
+
 		/// Selected node when context menu shown
 		Node* selectedNode;
 		/// Selected edge when context menu shown
@@ -83,12 +244,43 @@ class TreeVisGraphicsScene : public QGraphicsScene {
 		QMenu* itemColourPickMenu;
 		QMenu* textColourPickMenu;
 		QMenu* nodeOutlineColourPickMenu;
+		QMenu* actionRuleColourPickMenu;
+		QMenu* depthRuleColourPickMenu;
+		QMenu* observationRuleColourPickMenu;
 
 		// Actions for context menu
 		QAction* changeItemColourAction;
 		QAction* changeItemTextColourAction;
 		QAction* changeNodeOutlineColourAction;
 		QAction* viewNodeOHAction;
+		QAction* expandNodeAction;
+		QAction* collapseNodeAction;
+		QAction* clearStyleRulesAction;
+
+		/// Nodes added via AddNode() by agent and observation history index
+		QHash<NodeKey, Node*> nodes;
+
+		/// Nodes added via AddNode() by time step
+		QHash<Index, QSet<Node*>> nodesAtTimeStep;
+
+		/// Nodes added via AddNode() by agent
+		QHash<Index, QSet<Node*>> nodesForAgent;
+
+		/// Edges added via AddEdge()
+		QSet<Edge*> edges;
+
+		/// \brief Edges added via AddEdge() by the node they go to, policy
+		/// graph nodes can have more than one edge going into them
+		QMultiHash<NodeKey, Edge*> edgesTo;
+
+		/// The highlighted node, (-1, -1) if none
+		NodeKey highlightedNode = NodeKey(-1, -1);
+
+		/// Rules applied to the scene, in the order they were added
+		std::vector<StyleRule> styleRules;
+
+		/// If the scene draws the lines of the edges
+		bool batchEdgeLines = false;
 };
 
 #endif // TREEVISGRAPHICSSCENE_H
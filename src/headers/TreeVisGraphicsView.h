@@ -4,18 +4,34 @@
 // TreeVis
 #include "Node.h"
 #include "PlannerManager.h"
+#include "FrameStatsOverlay.h"
 
 // Qt
 #include <QGraphicsView>
+#include <QTimer>
 
 ///
 /// \brief Custom QGraphicsView to support zooming
-/// via the mouse wheel.
+/// via the mouse wheel. The view can draw through an OpenGL
+/// viewport and can drop antialiasing while it is being panned
+/// or zoomed, both chosen in the settings. The settings can also
+/// show the time taken to paint each frame over the view.
 ///
 class TreeVisGraphicsView : public QGraphicsView {
 	Q_OBJECT
 
 	public:
+		/// The viewports the view can draw through
+		enum viewportType {
+			/// Default QWidget viewport, drawn by the raster engine
+			RasterViewport,
+			/// QOpenGLWidget viewport using the system OpenGL
+			OpenGLViewport,
+			/// \brief QOpenGLWidget viewport forced to software OpenGL
+			/// (Mesa llvmpipe), needs a restart to take effect
+			SoftwareOpenGLViewport
+		};
+
 		///
 		/// \brief Calls the super constructor of the QGraphicsView the class inherits from.
 		/// Sets display rendering properties
@@ -35,11 +51,59 @@ class TreeVisGraphicsView : public QGraphicsView {
 		/// \param newScene The scene to change to
 		void ChangeScene(QGraphicsScene* newScene);
 
+		///
+		/// \brief Switches to the viewport chosen in the settings and
+		/// resets the antialiasing. Called when the view is created and
+		/// when the settings change.
+		///
+		void ApplyViewportSettings();
+
+		///
+		/// \brief Sets the viewport of all views, used by views created
+		/// afterwards and by the others once ApplyViewportSettings() is called
+		/// \param type The viewport to use
+		///
+		static void SetViewportType(const viewportType &type);
+
+		/// \return The viewport used by all views
+		static viewportType GetViewportType();
+
+		///
+		/// \brief Sets whether antialiasing is turned off while
+		/// a view is being panned or zoomed
+		/// \param adaptive True to turn it off while moving
+		///
+		static void SetAdaptiveAntialiasing(const bool &adaptive);
+
+		/// \return True if antialiasing is turned off while moving
+		static bool GetAdaptiveAntialiasing();
+
+		///
+		/// \brief Sets whether views show their frame statistics, shown by
+		/// views created afterwards and by the others once
+		/// ApplyViewportSettings() is called
+		/// \param show True to show the overlay
+		///
+		static void SetShowFrameStatistics(const bool &show);
+
+		/// \return True if views show their frame statistics
+		static bool GetShowFrameStatistics();
+
 
 	protected:
 		/// Mouse Wheel event on the view
 		virtual void wheelEvent(QWheelEvent* event);
 
+		///
+		/// \brief Called when the view is scrolled, including by dragging
+		/// \param dx Horizontal distance scrolled
+		/// \param dy Vertical distance scrolled
+		///
+		virtual void scrollContentsBy(int dx, int dy);
+
+		/// Paints the view, timing it when the frame statistics are shown
+		virtual void paintEvent(QPaintEvent* event);
+
 	public slots:
 		///
 		/// \brief Slot called from QGraphicsScene via the
@@ -49,7 +113,42 @@ class TreeVisGraphicsView : public QGraphicsView {
 		///
 		void DisplayObservationHistoryForNode(const Node* node);
 
+	private slots:
+		/// \brief Called once the view has stopped moving,
+		/// turns antialiasing back on
+		void InteractionFinished();
+
 	private:
+		///
+		/// \brief Turns antialiasing off if adaptive antialiasing is
+		/// on, until the view stops moving for a moment
+		///
+		void InteractionStarted();
+
+		/// Tells the scene shown whether to batch its edges for the viewport
+		void UpdateSceneEdgeBatching();
+
+		/// Restarted on each movement, turns antialiasing back on when it fires
+		QTimer* interactionTimer;
+
+		/// Time without movement before antialiasing is turned back on
+		const int interactionSettleTime = 150;
+
+		/// If the current viewport is a QOpenGLWidget
+		bool usingOpenGL = false;
+
+		/// Viewport of all views, set in settings
+		static viewportType viewport;
+
+		/// If antialiasing is turned off while moving, set in settings
+		static bool adaptiveAntialiasing;
+
+		/// If the frame statistics are shown, set in settings
+		static bool showFrameStatistics;
+
+		/// Paint times and scene statistics over the corner of the view
+		FrameStatsOverlay* frameStatsOverlay;
+
 		/// Zoom factor
 		const double factor = 1.15;
 
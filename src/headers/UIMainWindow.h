@@ -45,15 +45,30 @@ class Ui_MainWindow : public QObject {
 		/// Action to load a saved policy from a file, connected to main window
 		QAction* actionLoadSavedPolicy;
 
+		/// Action to stop the plan running and keep its best policy, connected to main window
+		QAction* actionStopPlanning;
+
+		/// Action to show the best policy of the plan running, connected to main window
+		QAction* actionShowBestPolicy;
+
 		/// Action to save the full tree viewer to a file, connected to main window
 		QAction* actionSaveFullTreeViewerScreenToImage;
 
 		/// Action to save the policy visualiser viewer to a file, connected to main window
 		QAction* actionSavePolicyVisualiserScreenToImage;
 
+		/// Action to export the whole full tree of an agent to a file, connected to full tree view
+		QAction* actionExportFullTree;
+
 		/// Action to set default settings
 		QAction* actionSetSettings;
 
+		/// Checkable action to record trace spans, connected to main window
+		QAction* actionRecordTrace;
+
+		/// Action to write the trace spans recorded to a file, connected to main window
+		QAction* actionExportTrace;
+
 		/// Layout to expand all
 		QHBoxLayout* horizontalLayout;
 
@@ -131,9 +146,17 @@ class Ui_MainWindow : public QObject {
 			// Create menu actions
 			actionNewPlan = new QAction("New Plan", MainWindow);
 			actionLoadSavedPolicy = new QAction("Load Saved Policy", MainWindow);
+			actionStopPlanning = new QAction("Stop Planning", MainWindow);
+			actionStopPlanning->setEnabled(false);
+			actionShowBestPolicy = new QAction("Show Best Policy So Far", MainWindow);
+			actionShowBestPolicy->setEnabled(false);
 			actionSaveFullTreeViewerScreenToImage = new QAction("Save Full Tree Viewer Screen to file", MainWindow);
 			actionSavePolicyVisualiserScreenToImage = new QAction("Save Policy Visualiser Screen to file", MainWindow);
+			actionExportFullTree = new QAction("Export Full Tree to file", MainWindow);
 			actionSetSettings = new QAction("Settings", MainWindow);
+			actionRecordTrace = new QAction("Record Trace", MainWindow);
+			actionRecordTrace->setCheckable(true);
+			actionExportTrace = new QAction("Export Trace to file", MainWindow);
 
 			// New file menu in menu bar
 			fileMenu = new QMenu("File", menuBar);
@@ -143,9 +166,15 @@ class Ui_MainWindow : public QObject {
 			menuBar->addAction(fileMenu->menuAction());
 			fileMenu->addAction(actionNewPlan);
 			fileMenu->addAction(actionLoadSavedPolicy);
+			fileMenu->addAction(actionStopPlanning);
+			fileMenu->addAction(actionShowBestPolicy);
 			fileMenu->addAction(actionSaveFullTreeViewerScreenToImage);
 			fileMenu->addAction(actionSavePolicyVisualiserScreenToImage);
+			fileMenu->addAction(actionExportFullTree);
 			fileMenu->addAction(actionSetSettings);
+			fileMenu->addSeparator();
+			fileMenu->addAction(actionRecordTrace);
+			fileMenu->addAction(actionExportTrace);
 
 			// Connect the slots up
 			ConnectSlots(MainWindow);
@@ -157,9 +186,14 @@ class Ui_MainWindow : public QObject {
 			// Connect menu actions
 			connect(actionNewPlan, SIGNAL(triggered(bool)), MainWindow, SLOT(ActionNewPlan()));
 			connect(actionLoadSavedPolicy, SIGNAL(triggered(bool)), MainWindow, SLOT(ActionLoadSavedPolicy()));
+			connect(actionStopPlanning, SIGNAL(triggered(bool)), MainWindow, SLOT(ActionStopPlanning()));
+			connect(actionShowBestPolicy, SIGNAL(triggered(bool)), MainWindow, SLOT(ActionShowBestPolicy()));
 			connect(actionSaveFullTreeViewerScreenToImage, SIGNAL(triggered(bool)), fullTreeViewer, SLOT(SaveGraphicsViewToFile()));
 			connect(actionSavePolicyVisualiserScreenToImage, SIGNAL(triggered(bool)), policyVisualiserView, SLOT(SaveGraphicsViewToFile()));
+			connect(actionExportFullTree, SIGNAL(triggered(bool)), fullTreeViewer, SLOT(ExportFullTreeToFile()));
 			connect(actionSetSettings, SIGNAL(triggered(bool)), MainWindow, SLOT(ActionSetSettings()));
+			connect(actionRecordTrace, SIGNAL(toggled(bool)), MainWindow, SLOT(ActionRecordTrace(bool)));
+			connect(actionExportTrace, SIGNAL(triggered(bool)), MainWindow, SLOT(ActionExportTrace()));
 
 			// Connect slot to allow the components to output to the info text field
 			connect(fullTreeViewer, SIGNAL(AppendToInformationText(std::string, MainWindow::textStyle)), MainWindow, SLOT(AppendToInformationText(std::string, MainWindow::textStyle)));
@@ -170,6 +204,8 @@ class Ui_MainWindow : public QObject {
 			connect(MainWindow, SIGNAL(PlanFinished()), fullTreeViewer, SLOT(PlanFinished()));
 			connect(MainWindow, SIGNAL(PlanStarting()), policyVisualiserView, SLOT(PlanStarting()));
 			connect(MainWindow, SIGNAL(PlanFinished()), policyVisualiserView, SLOT(PlanFinished()));
+			connect(MainWindow, SIGNAL(SettingsChanged(bool)), fullTreeViewer, SLOT(SettingsChanged(bool)));
+			connect(MainWindow, SIGNAL(SettingsChanged(bool)), policyVisualiserView, SLOT(SettingsChanged(bool)));
 		}
 };
 
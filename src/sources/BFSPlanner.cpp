@@ -1,7 +1,6 @@
 #include "BFSPlanner.h"
 
 #include "argumentUtils.h"
-#include "Timing.h"
 
 void BFSPlanner::Plan(ArgumentHandlers::Arguments args) {
 	std::cout << "Running BFS Planner..." << std::endl;
@@ -10,28 +9,29 @@ void BFSPlanner::Plan(ArgumentHandlers::Arguments args) {
 	args.dryrun = true;
 
 	// Start timers
-	Timing Time;
+	PlannerTiming &Time = timing;
 	Time.Start("Overall");
-	Time.Start("PlanningUnit");
+	Time.Start("Problem");
 
 	// Set decpomdp
 	decpomdp = std::unique_ptr<DecPOMDPDiscreteInterface>(
 				ArgumentUtils::GetDecPOMDPDiscreteInterfaceFromArgs(args));
 
-	Time.Stop("PlanningUnit");
+	Time.Stop("Problem");
 
 	// Set parameters as necessary
-	PlanningUnitMADPDiscreteParameters params;
-	params.SetComputeAll(true);
-	params.SetUseSparseJointBeliefs(args.sparse);
+	PlanningUnitMADPDiscreteParameters params = GetParameters(args);
 
 	std::cout << "Instantiating the planning unit..." << std::endl;
+	Time.Start("PlanningUnit");
 
 	// Create a new Brute Force Search planner, sufficient to set
 	// pUnit directly here
 	pUnit = std::unique_ptr<BruteForceSearchPlanner>(
 				new BruteForceSearchPlanner(args.horizon, decpomdp.get(), &params));
 
+	Time.Stop("PlanningUnit");
+
 	std::cout << "Planning unit instantiated" << std::endl;
 
 	// For the number of restarts
@@ -52,6 +52,14 @@ void BFSPlanner::Plan(ArgumentHandlers::Arguments args) {
 	Time.PrintSummary();
 }
 
+PlanningUnitMADPDiscreteParameters BFSPlanner::GetParameters(const ArgumentHandlers::Arguments &args) const {
+	PlanningUnitMADPDiscreteParameters params;
+	params.SetComputeAll(true);
+	params.SetUseSparseJointBeliefs(args.sparse);
+
+	return params;
+}
+
 BFSPlanner::~BFSPlanner() {
 	// std::cout << "~BFSPlanner()" << std::endl;
 }
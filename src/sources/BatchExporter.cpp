@@ -0,0 +1,351 @@
+#include "BatchExporter.h"
+
+// TreeVis
+#include "TreeExporter.h"
+#include "SettingsDialog.h"
+#include "Node.h"
+#include "Edge.h"
+
+// Qt
+#include <QCommandLineParser>
+#include <QDir>
+#include <QFileInfo>
+#include <QImage>
+#include <QFontMetricsF>
+#include <QPainter>
+#include <QSvgGenerator>
+#include <QThread>
+#include <QtConcurrent/QtConcurrentMap>
+#include <QtMath>
+
+// MADP
+#include "Action.h"
+#include "Observation.h"
+#include "argumentUtils.h"
+
+#include <algorithm>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+
+
+BatchExporter::BatchExporter(const QString &problemFilePath,
+							 const QString &outputDirectory,
+							 const imageFormat &format) {
+	problemFile = problemFilePath;
+	outputDir = outputDirectory;
+	imageType = format;
+}
+
+
+BatchExporter::~BatchExporter() {
+	//std::cout << "~BatchExporter()" << std::endl;
+}
+
+
+bool BatchExporter::IsRequested(int argc, char** argv) {
+	for(int i=1; i<argc; ++i) {
+		if(strcmp(argv[i], "--export") == 0) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
+int BatchExporter::RunFromCommandLine(const QStringList &arguments) {
+	QCommandLineParser parser;
+	parser.setApplicationDescription("Exports the full trees and a sampled trajectory of saved policies");
+	parser.addHelpOption();
+
+	parser.addOption(QCommandLineOption("export", "Export without showing a window."));
+	parser.addOption(QCommandLineOption("problem", "The .dpomdp problem the policies are for.", "file"));
+	parser.addOption(QCommandLineOption("output", "Directory to write the images to.", "dir", "."));
+	parser.addOption(QCommandLineOption("format", "Image format, svg or png.", "format", "svg"));
+	parser.addOption(QCommandLineOption("seed", "Seed for sampling the trajectories.", "n"));
+	parser.addPositionalArgument("policies", "Policy files saved from previous plans.", "<policies...>");
+
+	parser.process(arguments);
+
+	QString format = parser.value("format").toLower();
+
+	if(!parser.isSet("problem") || parser.positionalArguments().isEmpty() ||
+			(format != "svg" && format != "png")) {
+		std::cerr << parser.helpText().toStdString();
+		return 1;
+	}
+
+	if(!QDir().mkpath(parser.value("output"))) {
+		std::cerr << "Could not create output directory " << parser.value("output").toStdString() << std::endl;
+		return 1;
+	}
+
+	// Same seed gives the same trajectories
+	if(parser.isSet("seed")) {
+		srand(parser.value("seed").toUInt());
+	} else {
+		srand(time(NULL));
+	}
+
+	// Fonts and colours as they are in the application
+	SettingsDialog::ApplySavedSettings();
+
+	BatchExporter exporter(parser.value("problem"), parser.value("output"), format == "png" ? PNG : SVG);
+	int failed = exporter.Run(parser.positionalArguments());
+
+	if(failed < 0) {
+		return 1;
+	}
+
+	std::cout << "Exported " << parser.positionalArguments().size() - failed << "/"
+			  << parser.positionalArguments().size() << " policies" << std::endl;
+
+	return failed == 0 ? 0 : 2;
+}
+
+
+int BatchExporter::Run(const QStringList &policyFilePaths) {
+	int failed = 0;
+	QString problemError;
+
+	if(!CheckProblem(problemError)) {
+		std::cerr << "Could not read problem " << problemFile.toStdString() << ": "
+				  << problemError.toStdString() << std::endl;
+		return -1;
+	}
+
+	// One problem is held per thread at a time
+	int batchSize = std::max(1, QThread::idealThreadCount());
+
+	for(int batchStart=0; batchStart<policyFilePaths.size(); batchStart += batchSize) {
+		int batchEnd = std::min(policyFilePaths.size(), batchStart + batchSize);
+		std::vector<PolicyJob> jobs(batchEnd - batchStart);
+
+		// Read in the batch of policies in turn, the parser is shared
+		for(int i=batchStart; i<batchEnd; ++i) {
+			jobs[i-batchStart].policyFilePath = policyFilePaths[i];
+			jobs[i-batchStart].manager = std::unique_ptr<PlannerManager>(new PlannerManager());
+			LoadPolicy(jobs[i-batchStart]);
+		}
+
+		// Every agents tree and the trajectory of each policy is a separate export.
+		// Agent index -1 is the trajectory
+		std::vector<std::pair<PolicyJob*, int>> exports;
+
+		for(PolicyJob &job : jobs) {
+			if(!job.loaded) {
+				std::cerr << "Could not load " << job.policyFilePath.toStdString() << ": "
+						  << job.errorMessage.toStdString() << std::endl;
+				continue;
+			}
+
+			for(Index i=0; i<job.manager->GetPlanningUnit()->GetNrAgents(); ++i) {
+				exports.push_back(std::make_pair(&job, (int) i));
+			}
+
+			// In policy order, only the drawing is done in parallel
+			SampleTrajectory(job);
+			exports.push_back(std::make_pair(&job, -1));
+		}
+
+		QtConcurrent::blockingMap(exports, [this](std::pair<PolicyJob*, int> &item) {
+			bool success = item.second == -1 ? ExportTrajectory(*item.first) :
+											   ExportFullTree(*item.first, item.second);
+
+			// Several exports of the same policy can fail at once
+			if(!success) {
+				item.first->exported = false;
+			}
+		});
+
+		for(const PolicyJob &job : jobs) {
+			if(!job.loaded || !job.exported) {
+				++failed;
+
+				if(job.loaded) {
+					std::cerr << "Could not write every image for " << job.policyFilePath.toStdString() << std::endl;
+				}
+			} else {
+				std::cout << "Exported " << job.policyFilePath.toStdString() << std::endl;
+			}
+		}
+	}
+
+	return failed;
+}
+
+
+bool BatchExporter::CheckProblem(QString &message) const {
+	ArgumentHandlers::Arguments args;
+	args.problem_type = ProblemType::PARSE;
+
+	std::string problemPath = problemFile.toStdString();
+	args.dpf = &problemPath[0];
+
+	try {
+		std::unique_ptr<DecPOMDPDiscreteInterface> decpomdp(
+					ArgumentUtils::GetDecPOMDPDiscreteInterfaceFromArgs(args));
+	} catch(E &e) {
+		message = QString::fromStdString(e.SoftPrint());
+		return false;
+	}
+
+	return true;
+}
+
+
+void BatchExporter::LoadPolicy(PolicyJob &job) const {
+	ArgumentHandlers::Arguments args;
+	args.problem_type = ProblemType::PARSE;
+
+	// Deleted by the planner manager once the problem is read
+	std::string problemPath = problemFile.toStdString();
+	char* problemFilePath = new char[problemPath.length()+1];
+	strcpy(problemFilePath, problemPath.c_str());
+	args.dpf = problemFilePath;
+
+	// Emitted from this thread so the result is known before returning
+	QObject::connect(job.manager.get(), &PlannerManager::PreviousPlanEnded,
+					 [&job](bool success, QString message) {
+		job.loaded = success;
+		job.errorMessage = message;
+	});
+
+	try {
+		job.manager->PreviousPlan(job.policyFilePath.toStdString(), args);
+	} catch(E &e) {
+		// Thrown reading in the problem, before the manager deletes the path
+		delete[] problemFilePath;
+		job.loaded = false;
+		job.errorMessage = QString::fromStdString(e.SoftPrint());
+	}
+}
+
+
+bool BatchExporter::ExportFullTree(const PolicyJob &job, const Index &agentIndex) const {
+	TreeExporter exporter(job.manager->GetAgentPolicy(agentIndex), paddingBetweenNodes);
+	QString path = GetOutputPath(job, "_agent" + QString::number(agentIndex+1));
+
+	if(imageType == PNG) {
+		return exporter.ExportToTiledPNG(path);
+	}
+
+	return exporter.ExportToSVG(path);
+}
+
+
+void BatchExporter::SampleTrajectory(PolicyJob &job) const {
+	PlanningUnitDecPOMDPDiscrete* pUnit = job.manager->GetPlanningUnit();
+	Index horizon = pUnit->GetHorizon();
+
+	// Sample the trajectory as the policy visualiser does when randomising
+	job.jointActions = std::vector<Index>(horizon);
+	job.jointObservations = std::vector<Index>(horizon);
+
+	Index stateIndex = pUnit->GetProblem()->SampleInitialState();
+	Index johIndex = 0;
+	job.jointActions[0] = job.manager->GetJointActionIndex(johIndex);
+
+	for(Index t=1; t<horizon; ++t) {
+		Index successorStateIndex = pUnit->GetProblem()->SampleSuccessorState(stateIndex, job.jointActions[t-1]);
+		job.jointObservations[t] = pUnit->GetProblem()->SampleJointObservation(stateIndex, job.jointActions[t-1],
+																			   successorStateIndex);
+
+		johIndex = pUnit->GetSuccessorJOHI(johIndex, job.jointObservations[t]);
+		job.jointActions[t] = job.manager->GetJointActionIndex(johIndex);
+		stateIndex = successorStateIndex;
+	}
+}
+
+
+bool BatchExporter::ExportTrajectory(const PolicyJob &job) const {
+	PlanningUnitDecPOMDPDiscrete* pUnit = job.manager->GetPlanningUnit();
+	Index numAgents = pUnit->GetNrAgents();
+	Index horizon = pUnit->GetHorizon();
+	const std::vector<Index> &jointActions = job.jointActions;
+	const std::vector<Index> &jointObservations = job.jointObservations;
+
+	// Columns fit the widest action of any agent, rows fit the longest observation
+	qreal columnWidth = 0;
+	qreal nodeHeight = 0;
+	qreal longestObservation = 0;
+	QFontMetricsF fontMetrics = QFontMetricsF(Edge::GetFont());
+
+	for(Index i=0; i<numAgents; ++i) {
+		for(Index j=0; j<pUnit->GetNrActions(i); ++j) {
+			QSizeF size = Node::GetSizeForText(QString::fromStdString(pUnit->GetAction(i, j)->GetName()));
+			columnWidth = std::max(columnWidth, size.width());
+			nodeHeight = std::max(nodeHeight, size.height());
+		}
+
+		for(Index j=0; j<pUnit->GetNrObservations(i); ++j) {
+			longestObservation = std::max(longestObservation, fontMetrics.boundingRect(
+				QString::fromStdString(pUnit->GetObservation(i, j)->GetName())).width());
+		}
+	}
+
+	columnWidth += paddingBetweenAgents;
+	qreal rowSeparation = std::max((qreal) 120, longestObservation + nodeHeight + 50);
+
+	QRectF rect = QRectF(-columnWidth/2, -rowSeparation/2, numAgents*columnWidth, horizon*rowSeparation);
+
+	// Edges first so the nodes are drawn over them
+	auto paintTrajectory = [&](QPainter* painter) {
+		painter->setRenderHint(QPainter::Antialiasing);
+
+		for(Index t=1; t<horizon; ++t) {
+			std::vector<Index> observations = pUnit->JointToIndividualObservationIndices(jointObservations[t]);
+
+			for(Index i=0; i<numAgents; ++i) {
+				TreeExporter::PaintEdge(painter,
+										QPointF(i*columnWidth, (t-1)*rowSeparation),
+										QPointF(i*columnWidth, t*rowSeparation),
+										QString::fromStdString(pUnit->GetObservation(i, observations[i])->GetName()));
+			}
+		}
+
+		for(Index t=0; t<horizon; ++t) {
+			std::vector<Index> actions = pUnit->JointToIndividualActionIndices(jointActions[t]);
+
+			for(Index i=0; i<numAgents; ++i) {
+				TreeExporter::PaintNode(painter, QPointF(i*columnWidth, t*rowSeparation),
+										QString::fromStdString(pUnit->GetAction(i, actions[i])->GetName()));
+			}
+		}
+	};
+
+	QString path = GetOutputPath(job, "_trajectory");
+	QPainter painter;
+
+	if(imageType == PNG) {
+		QImage image(qCeil(rect.width()), qCeil(rect.height()), QImage::Format_ARGB32);
+		image.fill(Qt::white);
+
+		painter.begin(&image);
+		painter.translate(-rect.topLeft());
+		paintTrajectory(&painter);
+		painter.end();
+
+		return image.save(path, "PNG");
+	}
+
+	QSvgGenerator generator;
+	generator.setFileName(path);
+	generator.setSize(QSize(qCeil(rect.width()), qCeil(rect.height())));
+	generator.setViewBox(rect);
+	generator.setTitle("MADP TreeVis Output");
+
+	if(!painter.begin(&generator)) {
+		return false;
+	}
+
+	paintTrajectory(&painter);
+	return painter.end();
+}
+
+
+QString BatchExporter::GetOutputPath(const PolicyJob &job, const QString &suffix) const {
+	return QDir(outputDir).filePath(QFileInfo(job.policyFilePath).completeBaseName() + suffix +
+									(imageType == PNG ? ".png" : ".svg"));
+}
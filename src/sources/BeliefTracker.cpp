@@ -0,0 +1,95 @@
+#include "BeliefTracker.h"
+
+#include <algorithm>
+
+
+BeliefTracker::BeliefTracker(const DecPOMDPDiscreteInterface* decpomdp,
+							 const SparseModelSupport* modelSupport) {
+	problem = decpomdp;
+	support = modelSupport;
+	accumulator = std::vector<double>(problem->GetNrStates(), 0.0);
+	Reset();
+}
+
+
+BeliefTracker::~BeliefTracker() {
+	//std::cout << "~BeliefTracker()" << std::endl;
+}
+
+
+void BeliefTracker::Reset() {
+	belief.clear();
+
+	for(Index stateIndex=0; stateIndex<problem->GetNrStates(); ++stateIndex) {
+		double probability = problem->GetInitialStateProbability(stateIndex);
+
+		if(probability > 0) {
+			belief.push_back(std::make_pair(stateIndex, probability));
+		}
+	}
+}
+
+
+bool BeliefTracker::Update(const Index &jointActionIndex, const Index &jointObservationIndex) {
+	double total = 0.0;
+
+	// Push the probability of each state in the belief to its successors
+	for(const std::pair<Index, double> &state : belief) {
+		SparseModelSupport::SparseVector successors =
+				support->GetSuccessorStates(state.first, jointActionIndex);
+
+		for(const std::pair<Index, double> &successor : successors) {
+			double observationProbability = problem->GetObservationProbability(
+						state.first, jointActionIndex, successor.first, jointObservationIndex);
+
+			double probability = state.second * successor.second * observationProbability;
+
+			if(probability <= 0) {
+				continue;
+			}
+
+			if(accumulator[successor.first] == 0) {
+				touchedStates.push_back(successor.first);
+			}
+
+			accumulator[successor.first] += probability;
+			total += probability;
+		}
+	}
+
+	belief.clear();
+
+	// Collect and normalise, clearing the accumulator for the next update
+	for(const Index &stateIndex : touchedStates) {
+		if(total > 0) {
+			belief.push_back(std::make_pair(stateIndex, accumulator[stateIndex]/total));
+		}
+
+		accumulator[stateIndex] = 0.0;
+	}
+
+	touchedStates.clear();
+
+	// Keep the belief in state order
+	std::sort(belief.begin(), belief.end());
+
+	return total > 0;
+}
+
+
+const SparseModelSupport::SparseVector& BeliefTracker::GetBelief() const {
+	return belief;
+}
+
+
+SparseModelSupport::SparseVector BeliefTracker::GetTopStates(const size_t &k) const {
+	SparseModelSupport::SparseVector topStates(std::min(k, belief.size()));
+
+	// Only the top k need ordering
+	std::partial_sort_copy(belief.begin(), belief.end(), topStates.begin(), topStates.end(),
+						   [](const std::pair<Index, double> &a, const std::pair<Index, double> &b) {
+		return a.second > b.second;
+	});
+
+	return topStates;
+}
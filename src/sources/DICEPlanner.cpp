@@ -5,7 +5,6 @@
 
 // MADP Files
 #include "DICEPSPlanner.h"
-#include "Timing.h"
 #include "argumentUtils.h"
 
 
@@ -19,25 +18,21 @@ void DICEPlanner::Plan(ArgumentHandlers::Arguments args) {
 	args.dryrun = true; // Avoid output to file
 
 	// Start timers
-	Timing Time;
+	PlannerTiming &Time = timing;
 	Time.Start("Overall");
 
 	// Get the decpomdp from the given args
+	Time.Start("Problem");
 	decpomdp = std::unique_ptr<DecPOMDPDiscreteInterface>(
 				ArgumentUtils::GetDecPOMDPDiscreteInterfaceFromArgs(args));
+	Time.Stop("Problem");
 
 	DICEPSPlanner* diceps = 0;
 
 	Time.Start("PlanningUnit");
 
 	// Typical Paramaters for DICEPS Algorithm
-	PlanningUnitMADPDiscreteParameters params;
-	params.SetComputeAll(false);
-	params.SetComputeIndividualObservationHistories(true);
-
-	// Joint observations histories needed for efficient computation of joint actions
-	params.SetComputeJointObservationHistories(true);
-	params.SetUseSparseJointBeliefs(args.sparse);
+	PlanningUnitMADPDiscreteParameters params = GetParameters(args);
 
 	std::cout << "Instantiating the planning unit..." << std::endl;
 
@@ -63,9 +58,17 @@ void DICEPlanner::Plan(ArgumentHandlers::Arguments args) {
 	std::cout << "Planning unit instantiated" << std::endl;
 
 	double totalValue = 0;
+	Index nrRuns = 0;
 
 	// Go until the number of restarts
 	for(Index restartI = 0; restartI < args.nrCERestarts; restartI++) {
+
+		// The best policy of the runs so far is kept
+		if(restartI > 0 && StopRequested()) {
+			std::cout << "DICE stopped after " << restartI << " runs" << std::endl;
+			break;
+		}
+
 		std::cout << "DICE Run: "  << restartI+1 << "/" << args.nrCERestarts << std::endl;
 
 		// Start timers
@@ -79,9 +82,12 @@ void DICEPlanner::Plan(ArgumentHandlers::Arguments args) {
 
 		std::cout << diceps->GetExpectedReward() << std::endl;
 		totalValue += diceps->GetExpectedReward();
+		++nrRuns;
+
+		OfferPolicy(diceps, *diceps->GetJointPolicyPureVector(), diceps->GetExpectedReward());
 	}
 
-	std::cout << "Average Value of run: " << totalValue/args.nrCERestarts << std::endl;
+	std::cout << "Average Value of run: " << totalValue/nrRuns << std::endl;
 
 	// Stop the overall
 	Time.Stop("Overall");
@@ -91,3 +97,16 @@ void DICEPlanner::Plan(ArgumentHandlers::Arguments args) {
 	// Set the planning unit
 	pUnit = std::unique_ptr<DICEPSPlanner>(diceps);
 }
+
+
+PlanningUnitMADPDiscreteParameters DICEPlanner::GetParameters(const ArgumentHandlers::Arguments &args) const {
+	PlanningUnitMADPDiscreteParameters params;
+	params.SetComputeAll(false);
+	params.SetComputeIndividualObservationHistories(true);
+
+	// Joint observations histories needed for efficient computation of joint actions
+	params.SetComputeJointObservationHistories(true);
+	params.SetUseSparseJointBeliefs(args.sparse);
+
+	return params;
+}
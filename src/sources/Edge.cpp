@@ -2,6 +2,8 @@
 
 // Qt
 #include <QPen>
+#include <QPainter>
+#include <QStyleOptionGraphicsItem>
 #include <math.h>
 
 const qreal labelPaddingAdjust = 3;
@@ -9,81 +11,115 @@ const qreal labelPaddingAdjust = 3;
 QColor Edge::defaultEdgeColour;
 QColor Edge::defaultTextColour;
 QFont Edge::font;
+QFontMetricsF Edge::fontMetrics = QFontMetricsF(font);
 
 
-Edge::Edge(Node* from, Node* to, const QString &labelText, const double& obvsProb) {
+Edge::Edge(Node* from, Node* to, const QString &labelText,
+		   const EdgeGeometry &geometry, const double& obvsProb) {
 	// Set nodes values
 	fromNode = from;
 	toNode = to;
 	observationProbability = obvsProb;
+	this->labelText = labelText;
 
 	// Hide behind the nodes
 	setZValue(-1);
 
-	// If a label has been supplied
-	if(labelText != "") {
+	// Colour is read when painting, the pen is only for the bounding rect
+	setPen(GetPen());
 
-		// Create new label with the text, passing the line as the parent of the label
-		label = new QGraphicsSimpleTextItem(labelText, this);
-	}
-
-	UpdatePosition();
+	SetGeometry(geometry);
 }
 
 
+// Call constructor with the geometry worked out from the nodes
+Edge::Edge(Node* from, Node* to, const QString &labelText, const double& obvsProb) :
+	Edge(from, to, labelText, GetGeometry(QLineF(QPointF(0, 0), to->pos() - from->pos()), labelText), obvsProb) {}
+
+
 // Call constructor with converted QString
 Edge::Edge(Node* from, Node* to, const std::string& labelText, const double& obvsProb) :
 	Edge(from, to, QString::fromStdString(labelText), obvsProb) {}
 
 
 void Edge::UpdatePosition() {
-	// Set the start position of the edge to be from nodes position
+	SetGeometry(GetGeometry(QLineF(QPointF(0, 0), toNode->pos() - fromNode->pos()), labelText));
+}
+
+
+void Edge::SetGeometry(const EdgeGeometry &geometry) {
+	// Label is part of the bounding rect
+	prepareGeometryChange();
+
+	// Line starts at the position of the node the edge is from
 	setPos(fromNode->pos());
+	setLine(geometry.line);
+
+	labelSize = geometry.labelSize;
+	labelTransform = geometry.labelTransform;
+}
+
+
+EdgeGeometry Edge::GetGeometry(const QLineF &line, const QString &labelText) {
+	EdgeGeometry geometry;
+	geometry.line = line;
+
+	// If there is a label, place it on the centre of the line
+	if(!labelText.isEmpty()) {
+		geometry.labelSize = fontMetrics.boundingRect(QRectF(), Qt::TextSingleLine, labelText).size();
+		geometry.labelTransform = GetLabelTransform(line, geometry.labelSize);
+	}
+
+	return geometry;
+}
+
+
+void Edge::paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget*) {
+	// Pen is read here so colour changes only need a repaint
+	if(!lineDrawnByScene) {
+		painter->setPen(GetPen());
+		painter->drawLine(line());
+	}
+
+	// Labels are unreadable this far out, laying out the text is most of the cost
+	if(labelText.isEmpty() ||
+	   option->levelOfDetailFromTransform(painter->worldTransform()) < labelLevelOfDetail) {
+		return;
+	}
+
+	// Drawn as TreeExporter draws labels
+	painter->save();
+	painter->setTransform(labelTransform, true);
+	painter->setFont(font);
+	painter->setPen(textColour.isValid() ? textColour : defaultTextColour);
+	painter->drawText(QPointF(0, fontMetrics.ascent()), labelText);
+	painter->restore();
+}
 
-	// Set the position of the edge, set the pen to the defaults
-	setLine(QLineF(mapFromScene(pos()), mapFromScene(toNode->pos())));
-	setPen(QPen(edgeColour, edgeThickness));
-
-	// If a label has been created
-	if(label) {
-
-		// Brush to text colour
-		label->setFont(font);
-		label->setBrush(textColour);
-
-		// Centre on line and get angle
-		label->setPos(line().center());
-		qreal angle = line().angle();
-
-		// Offset to position on centre of line rather than top left corner
-		qreal xOffset = label->boundingRect().width()/2;
-		qreal yOffset = label->boundingRect().height();
-
-		// Edge is going left if angle is < 270, calculate
-		// angle as a percentage between 0-90
-		bool leftSide = (angle < 270);
-		qreal mult = (double) ((int) angle % 90) / 90;
-
-		// If left side adjust appropriately
-		if(leftSide) {
-			xOffset += mult*labelPaddingAdjust;
-			yOffset += (1-mult)*labelPaddingAdjust;
-			if(angle != 0) angle += 180; // Flip label if not horizontal i.e. -
-		} else {
-
-			// Otherwise opposite direction
-			xOffset -= (1-mult)*labelPaddingAdjust;
-			yOffset += mult*labelPaddingAdjust;
-		}
-
-		// Move by the offset, set the origin point to the bottom left of the label
-		label->moveBy(-xOffset, -yOffset);
-		label->setTransformOriginPoint(label->boundingRect().width()/2,
-									   label->boundingRect().height());
-
-		// Rotate
-		label->setRotation(360-angle);
+
+QRectF Edge::boundingRect() const {
+	if(labelText.isEmpty()) {
+		return QGraphicsLineItem::boundingRect();
 	}
+
+	return QGraphicsLineItem::boundingRect().united(LabelRect());
+}
+
+
+QPainterPath Edge::shape() const {
+	QPainterPath path = QGraphicsLineItem::shape();
+
+	if(!labelText.isEmpty()) {
+		path.addPolygon(labelTransform.map(QPolygonF(QRectF(QPointF(0, 0), labelSize))));
+		path.closeSubpath();
+	}
+
+	return path;
+}
+
+
+QRectF Edge::LabelRect() const {
+	return labelTransform.mapRect(QRectF(QPointF(0, 0), labelSize));
 }
 
 
@@ -92,6 +128,52 @@ QFont Edge::GetFont() {
 }
 
 
+QColor Edge::GetDefaultColour() {
+	return defaultEdgeColour;
+}
+
+
+QColor Edge::GetDefaultTextColour() {
+	return defaultTextColour;
+}
+
+
+QTransform Edge::GetLabelTransform(const QLineF &line, const QSizeF &labelSize) {
+	qreal angle = line.angle();
+
+	// Offset to position on centre of line rather than top left corner
+	qreal xOffset = labelSize.width()/2;
+	qreal yOffset = labelSize.height();
+
+	// Edge is going left if angle is < 270, calculate
+	// angle as a percentage between 0-90
+	bool leftSide = (angle < 270);
+	qreal mult = (double) ((int) angle % 90) / 90;
+
+	// If left side adjust appropriately
+	if(leftSide) {
+		xOffset += mult*labelPaddingAdjust;
+		yOffset += (1-mult)*labelPaddingAdjust;
+		if(angle != 0) angle += 180; // Flip label if not horizontal i.e. -
+	} else {
+
+		// Otherwise opposite direction
+		xOffset -= (1-mult)*labelPaddingAdjust;
+		yOffset += mult*labelPaddingAdjust;
+	}
+
+	// Move by the offset, rotating about the bottom centre of the label
+	QPointF origin(labelSize.width()/2, labelSize.height());
+	QPointF position = line.center() - QPointF(xOffset, yOffset);
+
+	QTransform transform;
+	transform.translate(position.x() + origin.x(), position.y() + origin.y());
+	transform.rotate(360-angle);
+	transform.translate(-origin.x(), -origin.y());
+	return transform;
+}
+
+
 void Edge::SetDefaultColour(const QColor &newColour) {
 	defaultEdgeColour = newColour;
 }
@@ -104,38 +186,80 @@ void Edge::SetDefaultTextColour(const QColor &newColour) {
 
 void Edge::SetFont(const QFont &newFont) {
 	font = newFont;
+
+	// Update metrics
+	fontMetrics = QFontMetricsF(newFont);
 }
 
 
 void Edge::ChangeColourToMatchProbability(const bool &colourToProbability) {
-	// Change to default colour
-	if(colourToProbability) {
-		setPen(QPen(edgeColour, edgeThickness));
+	// True changes back to the edges colour
+	colouredToProbability = !colourToProbability;
+	update();
+}
 
-	} else {
+
+QPen Edge::GetPen() const {
+	if(colouredToProbability) {
 		// HSL Colour, 120 is code for all green so we take a
 		// percentage of the number based on the observation probability.
 		// Full saturation at 255 & 255/2 = ~127 for lightness
 		QColor colour = QColor::fromHsl((120 * observationProbability), 255, 127);
-		setPen(QPen(colour, edgeThickness));
+		return QPen(colour, edgeThickness);
 	}
+
+	return QPen(edgeColour.isValid() ? edgeColour : defaultEdgeColour, edgeThickness);
+}
+
+
+void Edge::RefreshStyle() {
+	// Label size depends on the font, colours are read when painting
+	UpdatePosition();
 }
 
 
 void Edge::SetEdgeColour(const QColor &newColour) {
+	// A chosen colour replaces the probability colour until it is toggled again
 	edgeColour = newColour;
-	setPen(QPen(edgeColour, edgeThickness));
+	colouredToProbability = false;
+	update();
 }
 
 
 void Edge::SetTextColour(const QColor &newColour) {
 	// If there is a label associated with the edge
-	if(label) {
+	if(!labelText.isEmpty()) {
 		textColour = newColour;
-		label->setBrush(textColour);
+		update();
 	}
 }
 
+Node* Edge::GetFromNode() const {
+	return fromNode;
+}
+
+
+Node* Edge::GetToNode() const {
+	return toNode;
+}
+
+
+void Edge::SetLineDrawnByScene(const bool &drawnByScene) {
+	lineDrawnByScene = drawnByScene;
+	update();
+}
+
+
+QString Edge::GetLabelText() const {
+	return labelText;
+}
+
+
+QSizeF Edge::GetLabelSize() const {
+	return labelSize;
+}
+
+
 Edge::~Edge()  {
 	// std::cout << "~Edge()" << std::endl;
 }
@@ -0,0 +1,259 @@
+#include "FrameStatsOverlay.h"
+
+// TreeVis
+#include "TreeVisGraphicsScene.h"
+#include "GeneralUtils.h"
+#include "Node.h"
+#include "Edge.h"
+
+// Qt
+#include <QPainter>
+#include <QMenu>
+#include <QContextMenuEvent>
+#include <QFileDialog>
+#include <QMessageBox>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QFile>
+#include <QDir>
+
+#include <algorithm>
+
+const std::vector<double> FrameStatsOverlay::binBounds = {2, 4, 8, 16, 33, 50, 100};
+
+
+FrameStatsOverlay::FrameStatsOverlay(QGraphicsView* graphicsView) : QWidget(graphicsView) {
+	view = graphicsView;
+
+	setFixedSize(overlayWidth, overlayHeight);
+	move(overlayMargin, overlayMargin);
+	hide();
+
+	frameTimes.reserve(framesKept);
+
+	refreshTimer = new QTimer(this);
+	refreshTimer->setInterval(refreshInterval);
+	connect(refreshTimer, &QTimer::timeout, this, &FrameStatsOverlay::Refresh);
+}
+
+
+FrameStatsOverlay::~FrameStatsOverlay() {
+	//std::cout << "~FrameStatsOverlay()" << std::endl;
+}
+
+
+void FrameStatsOverlay::AddFrame(const double &paintMs) {
+	if(frameTimes.size() < (size_t) framesKept) {
+		frameTimes.push_back(paintMs);
+	} else {
+		frameTimes[nextFrame] = paintMs;
+	}
+
+	nextFrame = (nextFrame + 1) % framesKept;
+	++totalFrames;
+}
+
+
+void FrameStatsOverlay::ClearFrames() {
+	frameTimes.clear();
+	nextFrame = 0;
+	totalFrames = 0;
+	update();
+}
+
+
+void FrameStatsOverlay::showEvent(QShowEvent* event) {
+	Refresh();
+	refreshTimer->start();
+	QWidget::showEvent(event);
+}
+
+
+void FrameStatsOverlay::hideEvent(QHideEvent* event) {
+	refreshTimer->stop();
+	QWidget::hideEvent(event);
+}
+
+
+void FrameStatsOverlay::Refresh() {
+	QGraphicsScene* scene = view->scene();
+	TreeVisGraphicsScene* treeScene = qobject_cast<TreeVisGraphicsScene*>(scene);
+
+	itemsInView = 0;
+	totalItems = 0;
+	sceneMemory = 0;
+
+	if(scene) {
+		// The items the view paints are those whose bounds cross the visible area
+		QRectF visible = view->mapToScene(view->viewport()->rect()).boundingRect();
+		itemsInView = scene->items(visible, Qt::IntersectsItemBoundingRect).size();
+
+		// The tree scene counts its items without listing them
+		if(treeScene) {
+			int nodes = treeScene->GetNodes().size();
+			int edges = treeScene->GetEdges().size();
+
+			totalItems = nodes + edges;
+			sceneMemory = nodes * (sizeof(Node) + itemOverhead) + edges * (sizeof(Edge) + itemOverhead);
+		} else {
+			totalItems = scene->items().size();
+			sceneMemory = totalItems * itemOverhead;
+		}
+	}
+
+	residentMemory = MemoryUtils::GetResidentMemory();
+	update();
+}
+
+
+double FrameStatsOverlay::Percentile(const double &fraction) const {
+	if(frameTimes.empty()) {
+		return 0;
+	}
+
+	std::vector<double> sorted = frameTimes;
+	size_t index = std::min(sorted.size() - 1, (size_t) (fraction * sorted.size()));
+	std::nth_element(sorted.begin(), sorted.begin() + index, sorted.end());
+
+	return sorted[index];
+}
+
+
+std::vector<int> FrameStatsOverlay::HistogramCounts() const {
+	std::vector<int> counts(binBounds.size() + 1, 0);
+
+	for(const double &frameTime : frameTimes) {
+		size_t bin = std::upper_bound(binBounds.begin(), binBounds.end(), frameTime) - binBounds.begin();
+		++counts[bin];
+	}
+
+	return counts;
+}
+
+
+void FrameStatsOverlay::paintEvent(QPaintEvent* event) {
+	Q_UNUSED(event);
+
+	QPainter painter(this);
+	painter.fillRect(rect(), QColor(0, 0, 0, 190));
+	painter.setPen(Qt::white);
+
+	QFont font = painter.font();
+	font.setPointSize(9);
+	painter.setFont(font);
+
+	double lastMs = frameTimes.empty() ? 0 : frameTimes[(nextFrame + framesKept - 1) % framesKept];
+	double maxMs = frameTimes.empty() ? 0 : *std::max_element(frameTimes.begin(), frameTimes.end());
+
+	QStringList lines;
+	lines << QString("Paint: %1 ms, median %2, 95%: %3, max %4")
+			 .arg(lastMs, 0, 'f', 1).arg(Percentile(0.5), 0, 'f', 1)
+			 .arg(Percentile(0.95), 0, 'f', 1).arg(maxMs, 0, 'f', 1);
+	lines << QString("Items in view: %1 of %2").arg(itemsInView).arg(totalItems);
+	lines << QString("Zoom: %1%").arg(view->transform().m11() * 100, 0, 'f', 1);
+	lines << QString("Memory: scene ~%1 MB, process %2 MB")
+			 .arg(sceneMemory / (1024.0*1024.0), 0, 'f', 1).arg(residentMemory / (1024.0*1024.0), 0, 'f', 1);
+
+	int lineHeight = painter.fontMetrics().height();
+	int y = 4;
+
+	for(const QString &line : lines) {
+		painter.drawText(QRect(6, y, width() - 12, lineHeight), Qt::AlignLeft | Qt::AlignVCenter, line);
+		y += lineHeight;
+	}
+
+	// Histogram of the frames kept, a bar per bin labelled with its upper bound
+	std::vector<int> counts = HistogramCounts();
+	int largest = std::max(1, *std::max_element(counts.begin(), counts.end()));
+
+	QRect chart(6, y + 6, width() - 12, height() - y - 12 - lineHeight);
+	int barWidth = chart.width() / counts.size();
+
+	for(size_t bin=0; bin<counts.size(); ++bin) {
+		int barHeight = chart.height() * counts[bin] / largest;
+		QRect bar(chart.left() + bin * barWidth + 1, chart.bottom() - barHeight, barWidth - 2, barHeight);
+
+		// Slower than a 60Hz frame is shown in red
+		bool slow = bin > 0 && binBounds[bin-1] >= 16;
+		painter.fillRect(bar, slow ? QColor(230, 90, 80) : QColor(110, 200, 120));
+
+		QString label = bin < binBounds.size() ? QString::number(binBounds[bin]) : ">" + QString::number(binBounds.back());
+		painter.drawText(QRect(chart.left() + bin * barWidth, chart.bottom() + 2, barWidth, lineHeight),
+						 Qt::AlignHCenter | Qt::AlignTop, label);
+	}
+}
+
+
+void FrameStatsOverlay::contextMenuEvent(QContextMenuEvent* event) {
+	QMenu menu(this);
+
+	QAction* exportAction = menu.addAction("Export Frame Statistics...");
+	QAction* clearAction = menu.addAction("Clear Frames");
+	QAction* chosen = menu.exec(event->globalPos());
+
+	if(chosen == exportAction) {
+		Export();
+	} else if(chosen == clearAction) {
+		ClearFrames();
+	}
+}
+
+
+void FrameStatsOverlay::Export() {
+	QString filePath = QFileDialog::getSaveFileName(
+			this, "Export Frame Statistics", QDir::homePath(), "JSON (*.json)");
+
+	if(filePath.isEmpty()) {
+		return;
+	}
+
+	QFile file(filePath);
+
+	if(!file.open(QIODevice::WriteOnly | QIODevice::Truncate) ||
+	   file.write(QJsonDocument(ToJson()).toJson()) == -1) {
+		QMessageBox::warning(this, "MADP Tree Vis", "Could not write " + filePath);
+	}
+}
+
+
+QJsonObject FrameStatsOverlay::ToJson() const {
+	QJsonObject object;
+
+	// Oldest first, starting after the frame written last
+	QJsonArray frames;
+
+	for(size_t i=0; i<frameTimes.size(); ++i) {
+		frames.append(frameTimes[(nextFrame + i) % frameTimes.size()]);
+	}
+
+	QJsonArray histogram;
+	std::vector<int> counts = HistogramCounts();
+
+	for(size_t bin=0; bin<counts.size(); ++bin) {
+		QJsonObject binObject;
+
+		// The last bin has no upper bound
+		if(bin < binBounds.size()) {
+			binObject["upToMs"] = binBounds[bin];
+		}
+
+		binObject["frames"] = counts[bin];
+		histogram.append(binObject);
+	}
+
+	object["framesRecorded"] = (double) totalFrames;
+	object["frameTimesMs"] = frames;
+	object["histogram"] = histogram;
+	object["medianMs"] = Percentile(0.5);
+	object["percentile95Ms"] = Percentile(0.95);
+	object["itemsInView"] = itemsInView;
+	object["totalItems"] = totalItems;
+	object["zoom"] = view->transform().m11();
+	object["sceneMemoryMB"] = sceneMemory / (1024.0*1024.0);
+	object["residentMemoryMB"] = residentMemory / (1024.0*1024.0);
+	object["viewportWidth"] = view->viewport()->width();
+	object["viewportHeight"] = view->viewport()->height();
+	object["openGL"] = QString(view->viewport()->metaObject()->className()) == "QOpenGLWidget";
+
+	return object;
+}
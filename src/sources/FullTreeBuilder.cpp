@@ -0,0 +1,197 @@
+#include "FullTreeBuilder.h"
+
+// TreeVis
+#include "Edge.h"
+#include "TraceRecorder.h"
+
+// Qt
+#include <QFontMetricsF>
+
+#include <algorithm>
+
+
+FullTreeBuilder::FullTreeBuilder(const AgentPolicy &agentPolicy,
+								 TreeVisGraphicsScene* treeScene,
+								 const qreal &nodePadding) {
+	policy = agentPolicy;
+	scene = treeScene;
+	padding = nodePadding;
+
+	layout = CreateLayout(policy, padding);
+	ComputeEdgeGeometries();
+}
+
+
+FullTreeBuilder::~FullTreeBuilder() {
+	//std::cout << "~FullTreeBuilder()" << std::endl;
+}
+
+
+void FullTreeBuilder::Build(const Index &levels) {
+	TraceSpan span("FullTreeBuilder::Build", "tree");
+
+	// Root is observation history index 0
+	Node* root = AddNode(0);
+
+	if(levels > 1) {
+		Expand(root, levels-1);
+	}
+}
+
+
+void FullTreeBuilder::Expand(Node* node, const Index &levels) {
+	// Nothing below a leaf, or already built
+	if(levels == 0 || !node->IsExpandable() || node->IsExpanded()) {
+		return;
+	}
+
+	Index ohIndex = node->GetOHIndex();
+
+	for(Index obvsIndex=0; obvsIndex<policy.GetNrObservations(); ++obvsIndex) {
+		Node* child = AddNode(layout->GetChildOHIndex(ohIndex, obvsIndex));
+
+		// Shared by every edge from this level for the observation
+		scene->AddEdge(new Edge(node, child, policy.observationNames[obvsIndex],
+								edgeGeometries[node->GetTimeStep()][obvsIndex]));
+
+		Expand(child, levels-1);
+	}
+
+	node->SetExpanded(true);
+}
+
+
+void FullTreeBuilder::Collapse(Node* node) {
+	if(!node->IsExpanded()) {
+		return;
+	}
+
+	Index ohIndex = node->GetOHIndex();
+
+	for(Index obvsIndex=0; obvsIndex<policy.GetNrObservations(); ++obvsIndex) {
+		Index childIndex = layout->GetChildOHIndex(ohIndex, obvsIndex);
+
+		// Remove everything below the child before the child itself
+		Node* child = scene->GetNode(policy.agentIndex, childIndex);
+
+		if(child) {
+			Collapse(child);
+			scene->RemoveNode(policy.agentIndex, childIndex);
+		}
+	}
+
+	node->SetExpanded(false);
+}
+
+
+Node* FullTreeBuilder::BuildPathTo(const Index &ohIndex) {
+	Node* node = scene->GetNode(policy.agentIndex, 0);
+
+	// Each node on the path only needs its own children built
+	for(const Index &observationIndex : layout->GetObservationIndexes(ohIndex)) {
+		Expand(node, 1);
+		node = scene->GetNode(policy.agentIndex, layout->GetChildOHIndex(node->GetOHIndex(), observationIndex));
+	}
+
+	return node;
+}
+
+
+Node* FullTreeBuilder::AddNode(const Index &ohIndex) {
+	Node* node = new Node(policy.GetActionName(ohIndex), ohIndex, policy.agentIndex);
+	node->setPos(layout->GetPosition(ohIndex));
+	node->SetExpandable(!layout->IsLeaf(ohIndex));
+
+	scene->AddNode(node, layout->GetDepth(ohIndex));
+	return node;
+}
+
+
+void FullTreeBuilder::RefreshLayout() {
+	TraceSpan span("FullTreeBuilder::RefreshLayout", "tree");
+
+	qreal oldSlotWidth = layout->GetSlotWidth();
+	qreal oldLevelSeparation = layout->GetLevelSeparation();
+
+	layout = CreateLayout(policy, padding);
+	ComputeEdgeGeometries();
+
+	// Node sizes are unchanged by the new font, nothing needs to move
+	if(layout->GetSlotWidth() != oldSlotWidth || layout->GetLevelSeparation() != oldLevelSeparation) {
+
+		// Only the nodes that have been built need moving
+		for(Node* node : scene->GetNodes()) {
+			node->setPos(layout->GetPosition(node->GetOHIndex()));
+		}
+	}
+
+	// Labels may have changed size even if the nodes did not move
+	for(Edge* edge : scene->GetEdges()) {
+		Index depth = edge->GetFromNode()->GetTimeStep();
+		Index obvsIndex = layout->GetLastObservationIndex(edge->GetToNode()->GetOHIndex());
+		edge->SetGeometry(edgeGeometries[depth][obvsIndex]);
+	}
+
+	scene->setSceneRect(scene->itemsBoundingRect());
+}
+
+
+void FullTreeBuilder::ComputeEdgeGeometries() {
+	edgeGeometries.assign(layout->GetHorizon(), std::vector<EdgeGeometry>());
+
+	// Leaves have no edges below them
+	for(Index depth=0; depth+1<layout->GetHorizon(); ++depth) {
+		Index parent = layout->GetFirstOHIndexAtDepth(depth);
+		QPointF parentPosition = layout->GetPosition(parent);
+
+		for(Index obvsIndex=0; obvsIndex<policy.GetNrObservations(); ++obvsIndex) {
+			QPointF childPosition = layout->GetPosition(layout->GetChildOHIndex(parent, obvsIndex));
+
+			edgeGeometries[depth].push_back(Edge::GetGeometry(QLineF(QPointF(0, 0), childPosition - parentPosition),
+															  policy.observationNames[obvsIndex]));
+		}
+	}
+}
+
+
+std::unique_ptr<TreeLayout> FullTreeBuilder::CreateLayout(const AgentPolicy &agentPolicy, const qreal &nodePadding) {
+	// Every leaf slot must fit the widest action
+	qreal slotWidth = 0;
+	qreal nodeHeight = 0;
+
+	for(const QString &actionName : agentPolicy.actionNames) {
+		QSizeF size = Node::GetSizeForText(actionName);
+		slotWidth = std::max(slotWidth, size.width());
+		nodeHeight = std::max(nodeHeight, size.height());
+	}
+
+	slotWidth += nodePadding;
+
+	// Rotated observation labels need to fit between the levels
+	qreal longestObservation = 0;
+	QFontMetricsF fontMetrics = QFontMetricsF(Edge::GetFont());
+
+	for(const QString &observationName : agentPolicy.observationNames) {
+		longestObservation = std::max(longestObservation, fontMetrics.boundingRect(observationName).width());
+	}
+
+	// -50 per observation is a base number to separate the levels,
+	// otherwise the observation name dominates
+	qreal levelSeparation = std::max((qreal) 50*agentPolicy.GetNrObservations(),
+									 longestObservation + nodeHeight + 10);
+
+	return std::unique_ptr<TreeLayout>(new TreeLayout(agentPolicy.GetNrObservations(),
+													  agentPolicy.horizon,
+													  slotWidth,
+													  levelSeparation));
+}
+
+
+const TreeLayout& FullTreeBuilder::GetLayout() const {
+	return *layout;
+}
+
+
+const AgentPolicy& FullTreeBuilder::GetPolicy() const {
+	return policy;
+}
@@ -1,5 +1,16 @@
 #include "FullTreeView.h"
 
+// TreeVis
+#include "TreeExporter.h"
+#include "TraceRecorder.h"
+
+// Qt
+#include <QApplication>
+#include <QFileDialog>
+#include <QRegularExpression>
+
+#include <algorithm>
+
 FullTreeView::FullTreeView(PlannerManager* man, QWidget* parent) : QWidget(parent) {
 	pManager = man;
 	SetupUI(parent);
@@ -18,6 +29,9 @@ void FullTreeView::SetupUI(QWidget* parent) {
 	QSizePolicy graphicsViewSizePol(QSizePolicy::Expanding, QSizePolicy::Expanding);
 	graphicsView->setSizePolicy(graphicsViewSizePol);
 
+	// Sits over the view, hidden until a full tree is shown
+	overviewWidget = new TreeOverviewWidget(graphicsView);
+
 	// Label container
 	buttonLabelContainer = new QWidget(this);
 	QSizePolicy labelContainerSizePol(QSizePolicy::Minimum, QSizePolicy::Preferred);
@@ -49,6 +63,33 @@ void FullTreeView::SetupUI(QWidget* parent) {
 	generateButton = new QPushButton(buttonLabelContainer);
 	infoHorizontalLayout->addWidget(generateButton);
 
+	// Levels to build at once, deeper levels are built by expanding nodes
+	levelsSpinBox = new QSpinBox(buttonLabelContainer);
+	levelsSpinBox->setRange(1, 99);
+	levelsSpinBox->setValue(defaultLevelsToBuild);
+	infoHorizontalLayout->addWidget(new QLabel("Levels:", buttonLabelContainer));
+	infoHorizontalLayout->addWidget(levelsSpinBox);
+
+	// View mode, order must match the viewMode enum
+	viewModeComboBox = new QComboBox(buttonLabelContainer);
+	viewModeComboBox->addItem("Full Tree");
+	viewModeComboBox->addItem("Policy Graph");
+	infoHorizontalLayout->addWidget(viewModeComboBox);
+
+	// Search for an observation history in the full tree
+	searchLineEdit = new QLineEdit(buttonLabelContainer);
+	searchLineEdit->setPlaceholderText("OH index or observations");
+	searchLineEdit->setToolTip("An observation history index, or the observation names "
+							   "from the root separated by commas or spaces");
+	findButton = new QPushButton("Find", buttonLabelContainer);
+	infoHorizontalLayout->addWidget(searchLineEdit);
+	infoHorizontalLayout->addWidget(findButton);
+
+	overviewCheckBox = new QCheckBox("Overview", buttonLabelContainer);
+	overviewCheckBox->setChecked(true);
+	overviewCheckBox->setToolTip("Shows the whole tree, click or drag in it to move the view");
+	infoHorizontalLayout->addWidget(overviewCheckBox);
+
 	// Hide buttons initially
 	buttonLabelContainer->hide();
 
@@ -77,6 +118,9 @@ void FullTreeView::SetupUI(QWidget* parent) {
 	connect(incrementButton, &QPushButton::clicked, this, &FullTreeView::IncrementButtonClicked);
 	connect(decrementButton, &QPushButton::clicked, this, &FullTreeView::DecrementButtonClicked);
 	connect(generateButton, &QPushButton::clicked, this, &FullTreeView::GenerateButtonClicked);
+	connect(findButton, &QPushButton::clicked, this, &FullTreeView::FindObservationHistory);
+	connect(searchLineEdit, &QLineEdit::returnPressed, this, &FullTreeView::FindObservationHistory);
+	connect(overviewCheckBox, &QCheckBox::toggled, this, &FullTreeView::UpdateOverview);
 
 	// Main vertical layout
 	verticalLayout = new QVBoxLayout(parent);
@@ -94,14 +138,19 @@ void FullTreeView::PlanStarting() {
 
 	// Nothing needs displaying
 	graphicsView->ChangeScene(NULL);
+	overviewWidget->SetTree(nullptr, nullptr);
 
 	// Delete all previous scenes
 	for(Index i=0; i<scenes.size(); ++i) {
 		scenes[i]->deleteLater();
+		graphScenes[i]->deleteLater();
 	}
 
-	// Reset
+	// Reset, builders refer to the scenes
+	builders.clear();
+	policyGraphs.clear();
 	scenes.clear();
+	graphScenes.clear();
 	fullPolicyToShow = -1;
 	currentFullPolicyShown = -1;
 }
@@ -109,8 +158,10 @@ void FullTreeView::PlanStarting() {
 
 void FullTreeView::PlanFinished() {
 	// Get new vectors
-	fullPoliciesGenerated = std::vector<bool>(pManager->GetPlanningUnit()->GetNrAgents(), false);
+	builders = std::vector<std::unique_ptr<FullTreeBuilder>>(pManager->GetPlanningUnit()->GetNrAgents());
 	scenes = std::vector<TreeVisGraphicsScene*>(pManager->GetPlanningUnit()->GetNrAgents());
+	graphScenes = std::vector<TreeVisGraphicsScene*>(pManager->GetPlanningUnit()->GetNrAgents());
+	policyGraphs = std::vector<std::unique_ptr<PolicyGraph>>(pManager->GetPlanningUnit()->GetNrAgents());
 
 	// Create new graphics scenes for all
 	for(Index i=0; i<scenes.size(); ++i) {
@@ -118,6 +169,15 @@ void FullTreeView::PlanFinished() {
 
 		connect(scenes[i], &TreeVisGraphicsScene::DisplayObservationHistoryForNode,
 				graphicsView, &TreeVisGraphicsView::DisplayObservationHistoryForNode);
+
+		connect(scenes[i], &TreeVisGraphicsScene::ExpandNode, this, &FullTreeView::ExpandNode);
+		connect(scenes[i], &TreeVisGraphicsScene::CollapseNode, this, &FullTreeView::CollapseNode);
+
+		// Graph nodes show the history of the first subtree they represent
+		graphScenes[i] = new TreeVisGraphicsScene(graphicsView);
+
+		connect(graphScenes[i], &TreeVisGraphicsScene::DisplayObservationHistoryForNode,
+				graphicsView, &TreeVisGraphicsView::DisplayObservationHistoryForNode);
 	}
 
 	// Set text
@@ -136,6 +196,50 @@ void FullTreeView::SaveGraphicsViewToFile() {
 }
 
 
+void FullTreeView::ExportFullTreeToFile() {
+	// Export the agent chosen with the increment/decrement buttons
+	if(!pManager->HasPlanned() || fullPolicyToShow == -1) {
+		emit AppendToInformationText("Choose an agent to export the policy for first...",
+									 MainWindow::Orange);
+		return;
+	}
+
+	QString selectedFilter;
+	QString filePath = QFileDialog::getSaveFileName(
+			this, "Export Full Tree", QDir::homePath(),
+			"SVG (*.svg);;PDF (*.pdf);;Tiled PNG (*.png)", &selectedFilter);
+
+	// Dialog cancelled
+	if(filePath == "") {
+		return;
+	}
+
+	emit AppendToInformationText("Exporting full tree for Agent " + std::to_string(fullPolicyToShow+1) + "...",
+								 MainWindow::Normal);
+
+	QApplication::setOverrideCursor(Qt::WaitCursor);
+
+	TreeExporter exporter(pManager->GetAgentPolicy(fullPolicyToShow), paddingBetweenNodes);
+	bool success;
+
+	if(selectedFilter.startsWith("PDF")) {
+		success = exporter.ExportToPDF(filePath);
+	} else if(selectedFilter.startsWith("Tiled PNG")) {
+		success = exporter.ExportToTiledPNG(filePath);
+	} else {
+		success = exporter.ExportToSVG(filePath);
+	}
+
+	QApplication::restoreOverrideCursor();
+
+	if(success) {
+		emit AppendToInformationText("Full tree exported to " + filePath.toStdString(), MainWindow::Green);
+	} else {
+		emit AppendToInformationText("Could not export the full tree to " + filePath.toStdString(), MainWindow::Red);
+	}
+}
+
+
 void FullTreeView::IncrementButtonClicked() {
 	// Wrap as necessary
 	fullPolicyToShow = ++fullPolicyToShow >= pManager->GetPlanningUnit()->GetNrAgents() ? 0 : fullPolicyToShow;
@@ -163,30 +267,49 @@ void FullTreeView::GenerateButtonClicked() {
 
 		// Update full policy shown text
 		infoLabel->setText("Policy for agent " +
-						   QString::number(currentFullPolicyShown+1) + " Currently shown");
+						   QString::number(currentFullPolicyShown+1) + " Currently shown" +
+						   (currentModeShown == PolicyGraphMode ? " as a policy graph" : ""));
 	}
 }
 
 
 void FullTreeView::ShowFullPolicyForAgent(const Index &agentIndex) {
+	viewMode mode = static_cast<viewMode>(viewModeComboBox->currentIndex());
 
 	// If the policy has already been shown and the user is not attempting
 	// to show the same policy again, we can just hide the current one and unhide the other one the user wants to see
-	if(agentIndex != currentFullPolicyShown) {
+	if(agentIndex != currentFullPolicyShown || mode != currentModeShown) {
+
+		if(mode == PolicyGraphMode) {
+
+			// Graphs are generated once, like the trees
+			if(policyGraphs[agentIndex]) {
+				emit AppendToInformationText("Policy graph already generated for agent " +
+											 std::to_string(agentIndex+1) + ", showing the graph.", MainWindow::Normal);
+			} else {
+				GeneratePGForAgent(agentIndex);
+			}
 
-		// If the new policy has already been expanded, show it
-		if(fullPoliciesGenerated[agentIndex]) {
-			emit AppendToInformationText("Policy already generated for agent " +
-										 std::to_string(agentIndex+1) + ", showing the policy.", MainWindow::Normal);
+			graphicsView->ChangeScene(graphScenes[agentIndex]);
 
 		} else {
-			// Otherwise we need to generate the full tree for the agent
-			GenerateFTForAgent(agentIndex);
-		}
 
+			// If the new policy has already been expanded, show it
+			if(builders[agentIndex]) {
+				emit AppendToInformationText("Policy already generated for agent " +
+											 std::to_string(agentIndex+1) + ", showing the policy.", MainWindow::Normal);
+
+			} else {
+				// Otherwise we need to generate the full tree for the agent
+				GenerateFTForAgent(agentIndex);
+			}
+
+			graphicsView->ChangeScene(scenes[agentIndex]);
+		}
 
-		graphicsView->ChangeScene(scenes[agentIndex]);
 		currentFullPolicyShown = fullPolicyToShow;
+		currentModeShown = mode;
+		UpdateOverview();
 	} else {
 		emit AppendToInformationText("Policy for agent " + std::to_string(agentIndex+1) +
 									 " already shown", MainWindow::Orange);
@@ -200,136 +323,163 @@ void FullTreeView::UpdateFullPolicyToShowLabel() {
 }
 
 
-int FullTreeView::GetLongestObservationLengthForAgent(const Index& agentIndex) {
-	int longest = 0;
+void FullTreeView::GenerateFTForAgent(const Index &agentIndex) {
+	TraceSpan span("FullTreeView::GenerateFTForAgent", "tree");
 
-	QFontMetricsF fontMetrics = QFontMetricsF(Edge::GetFont());
+	emit AppendToInformationText("Generating tree for Agent " + std::to_string(agentIndex+1) + "...",
+								 MainWindow::Normal);
 
-	for(Index j=0; j<pManager->GetPlanningUnit()->GetNrObservations(agentIndex); ++j) {
-		int width = fontMetrics.boundingRect(QString::fromStdString(
-						pManager->GetPlanningUnit()->GetObservation(agentIndex, j)->GetName())).width();
+	// Only the top levels are built, the rest is built on demand from the context menu
+	builders[agentIndex] = std::unique_ptr<FullTreeBuilder>(
+				new FullTreeBuilder(pManager->GetAgentPolicy(agentIndex), scenes[agentIndex], paddingBetweenNodes));
 
-		if(width > longest) {
-			longest = width;
-		}
+	builders[agentIndex]->Build(levelsSpinBox->value());
+}
+
+
+void FullTreeView::ExpandNode(Node* node) {
+	TraceSpan span("FullTreeView::ExpandNode", "tree");
+
+	builders[node->GetAgentIndex()]->Expand(node, levelsSpinBox->value());
+}
+
+
+void FullTreeView::CollapseNode(Node* node) {
+	builders[node->GetAgentIndex()]->Collapse(node);
+}
+
+
+void FullTreeView::FindObservationHistory() {
+	// Only the full tree has a node for every observation history
+	if(currentFullPolicyShown == -1 || currentModeShown != FullTreeMode) {
+		emit AppendToInformationText("Generate the full tree for an agent to search it first...",
+									 MainWindow::Orange);
+		return;
+	}
+
+	FullTreeBuilder* builder = builders[currentFullPolicyShown].get();
+	Index ohIndex;
+
+	if(!ParseObservationHistory(searchLineEdit->text(), *builder, ohIndex)) {
+		return;
 	}
 
-	return longest;
+	// Position comes from the index so only the path needs building
+	Node* node = builder->BuildPathTo(ohIndex);
+	scenes[currentFullPolicyShown]->HighlightNode(currentFullPolicyShown, ohIndex);
+	graphicsView->centerOn(node);
+
+	emit AppendToInformationText("Found observation history index " + std::to_string(ohIndex) +
+								 " for Agent " + std::to_string(currentFullPolicyShown+1), MainWindow::Green);
 }
 
 
-void FullTreeView::GenerateFTForAgent(const Index &agentIndex) {
-	// Otherwise we need to generate the policy, +1 from arrray index
-	emit AppendToInformationText("Generating tree for Agent " + std::to_string(agentIndex+1) + "...",
-								 MainWindow::Normal);
+bool FullTreeView::ParseObservationHistory(const QString &text, const FullTreeBuilder &builder, Index &ohIndex) {
+	const TreeLayout &layout = builder.GetLayout();
+	const AgentPolicy &policy = builder.GetPolicy();
 
-	// Get the scene for this agent
-	TreeVisGraphicsScene* scene = scenes[agentIndex];
+	QStringList tokens = text.split(QRegularExpression("[,\\s]+"), QString::SkipEmptyParts);
 
-	// Get the number of observations and the history index (-1 as starts from 0)
-	int nrObservations = pManager->GetPlanningUnit()->GetNrObservations(agentIndex);
-	int obvsHistoryIndex = pManager->GetPlanningUnit()->GetNrObservationHistories(agentIndex)-1;
+	if(tokens.isEmpty()) {
+		emit AppendToInformationText("Enter an observation history index or observation names to find",
+									 MainWindow::Orange);
+		return false;
+	}
 
-	// Create vector of correct size (+1 as index)
-	std::vector<Node*> nodes(obvsHistoryIndex+1);
+	// A single number is an index, unless it is also the name of an observation
+	bool isNumber;
+	uint number = tokens[0].toUInt(&isNumber);
 
-	// Create first node
-	Node* toAdd = new Node(pManager->GetPlanningUnit()->GetAction(agentIndex,
-								pManager->GetActionIndex(agentIndex, obvsHistoryIndex))->GetName(),
-						   obvsHistoryIndex,
-						   agentIndex);
+	if(tokens.size() == 1 && isNumber &&
+	   std::find(policy.observationNames.begin(), policy.observationNames.end(), tokens[0]) == policy.observationNames.end()) {
 
-	// Set the position to (0,0), add it to the scene and set the reference in the vector to it
-	toAdd->setPos(QPoint(0, 0));
-	scene->addItem(toAdd);
-	nodes[obvsHistoryIndex] = toAdd;
+		if(number >= layout.GetNrOHIndexes()) {
+			emit AppendToInformationText("Observation history index " + std::to_string(number) +
+										 " is not in the tree", MainWindow::Red);
+			return false;
+		}
 
-	// Calculate number of nodes
-	int numNodes = pow(nrObservations, pManager->GetPlanningUnit()->GetHorizon()-1);
+		ohIndex = number;
+		return true;
+	}
 
-	// Take off 1 as we have added the first node
-	--numNodes;
-	--obvsHistoryIndex;
+	// Leaves are at depth horizon-1
+	if((Index) tokens.size() >= layout.GetHorizon()) {
+		emit AppendToInformationText("Too many observations for a horizon of " +
+									 std::to_string(layout.GetHorizon()), MainWindow::Red);
+		return false;
+	}
 
-	// Are we still on the last level of the tree
-	bool lastLevel = (numNodes != 0);
+	std::vector<Index> observationIndexes;
 
-	// Height multiplier works in reverse to the current depth basically...
-	// We want to set this as the min of (-100, -(lengthOfLongestObvsName + toAdd->boundingRect().height()))
-	// -100 is a base number to separate at least -100 vertical coordinates between levels of the tree,
-	// otherwise we want a larger separation as the observation name dominates the 100
-	int heightMultiplier = 0;
+	for(const QString &token : tokens) {
+		std::vector<QString>::const_iterator it =
+				std::find(policy.observationNames.begin(), policy.observationNames.end(), token);
 
-	// How much to separate
-	int heightSeparation = GetLongestObservationLengthForAgent(agentIndex);
-	heightSeparation = std::max(50*nrObservations, (heightSeparation + (int) std::round(toAdd->boundingRect().height())+10));
+		if(it == policy.observationNames.end()) {
+			emit AppendToInformationText("No observation named " + token.toStdString() +
+										 " for Agent " + std::to_string(policy.agentIndex+1), MainWindow::Red);
+			return false;
+		}
 
-	// Generate nodes
-	for(int currentDepth=pManager->GetPlanningUnit()->GetHorizon(); currentDepth>0; --currentDepth) {
+		observationIndexes.push_back(it - policy.observationNames.begin());
+	}
 
-		// Iterate for the number of nodes on this level
-		for(int j=0; j<numNodes; ++j) {
+	ohIndex = layout.GetOHIndex(observationIndexes);
+	return true;
+}
 
-			// Create a new node
-			toAdd = new Node(pManager->GetPlanningUnit()->GetAction(agentIndex,
-							 pManager->GetActionIndex(agentIndex, obvsHistoryIndex))->GetName(),
-							 obvsHistoryIndex,
-							 agentIndex);
 
-			// If we are on the 'last level' we want to position the next node to the left of the
-			// previously placed one by a set number of 'padding'
-			if(lastLevel) {
+void FullTreeView::UpdateOverview() {
+	if(!overviewCheckBox->isChecked() || currentFullPolicyShown == -1 || currentModeShown != FullTreeMode) {
+		overviewWidget->SetTree(nullptr, nullptr);
+		return;
+	}
 
-				// Extract node to 'right'
-				Node* prev = nodes[obvsHistoryIndex+1];
+	overviewWidget->SetTree(&builders[currentFullPolicyShown]->GetLayout(), scenes[currentFullPolicyShown]);
+}
 
-				// Get the position, set the new node to the left of the previously added node by 20
-				// Offset calculated as the two mid points added together to get the correct number
-				QPoint point(prev->scenePos().x(), prev->scenePos().y());
-				int offset = prev->GetWidth()/2 + toAdd->GetWidth()/2 + paddingBetweenNodes;
 
-				// Set the position
-				toAdd->setPos(point.x()-offset, point.y());
-			} else {
+void FullTreeView::GeneratePGForAgent(const Index &agentIndex) {
+	TraceSpan span("FullTreeView::GeneratePGForAgent", "tree");
 
-				// Otherwise we want to position the node in the mid point between it's two furthest children nodes
-				int leftMostChildIndex = (nrObservations*obvsHistoryIndex)+1;
-				int rightMostChildIndex = leftMostChildIndex + (nrObservations-1);
+	emit AppendToInformationText("Generating policy graph for Agent " + std::to_string(agentIndex+1) + "...",
+								 MainWindow::Normal);
 
-				// Get the two edge children of the node
-				Node* leftMostChild = nodes[leftMostChildIndex];
-				Node* rightMostChild = nodes[rightMostChildIndex];
+	// Kept so the scene can be laid out again when the fonts change
+	policyGraphs[agentIndex] = std::unique_ptr<PolicyGraph>(new PolicyGraph(pManager->GetAgentPolicy(agentIndex)));
+	policyGraphs[agentIndex]->AddToScene(graphScenes[agentIndex], paddingBetweenNodes);
 
-				// Calculate the offset and place the parent node at this offset
-				int offset = (leftMostChild->x() - leftMostChild->GetWidth()/2) + (rightMostChild->x() + rightMostChild->GetWidth()/2);
-				toAdd->setPos((offset/2), heightMultiplier*-heightSeparation);
+	emit AppendToInformationText("Policy graph for Agent " + std::to_string(agentIndex+1) + " has " +
+								 std::to_string(policyGraphs[agentIndex]->GetNrNodes()) + " nodes", MainWindow::Normal);
+}
 
-				// Add the Edges between the parent and child nodes
-				// this loop will naturally iterate over the number of observations the agent has
-				for(int q=leftMostChildIndex, obvsIndex = 0; q<=rightMostChildIndex; ++q, ++obvsIndex) {
-					// Get the observation name
-					std::string obvsName = pManager->GetPlanningUnit()->GetObservation(agentIndex, obvsIndex)->GetName();
 
-					// Create edge and add
-					Edge* edge = new Edge(toAdd, nodes[q], obvsName);
-					scene->addItem(edge);
-				}
-			}
+void FullTreeView::SettingsChanged(const bool &fontChanged) {
+	graphicsView->ApplyViewportSettings();
 
-			// Add to the scene and vector
-			scene->addItem(toAdd);
-			nodes[obvsHistoryIndex] = toAdd;
+	for(Index i=0; i<scenes.size(); ++i) {
+		if(builders[i]) {
+			// Moves the nodes and edges already built if they no longer fit
+			if(fontChanged) {
+				builders[i]->RefreshLayout();
+			}
 
-			// To prev index (next node)
-			--obvsHistoryIndex;
+			scenes[i]->RefreshItemStyles(fontChanged, false);
 		}
 
-		// No longer on last level, re calculate number of nodes
-		lastLevel = false;
-		numNodes = pow(nrObservations, currentDepth-2);
-		++heightMultiplier;
+		if(policyGraphs[i]) {
+			// Graph layout depends on the merged edge labels, cheapest to add it again.
+			// The graph is already compressed so this is only the scene items
+			if(fontChanged) {
+				graphScenes[i]->Clear();
+				policyGraphs[i]->AddToScene(graphScenes[i], paddingBetweenNodes);
+			} else {
+				graphScenes[i]->RefreshItemStyles(false);
+			}
+		}
 	}
 
-	// Policy has been generated
-	fullPoliciesGenerated[agentIndex] = true;
+	// The layout is replaced when the font changes, and the colours may differ
+	UpdateOverview();
 }
@@ -78,9 +78,9 @@ void GMAAPlanner::Plan(ArgumentHandlers::Arguments args) {
 
 	std::cout << description.str() << std::endl;
 
-	Timing Time;
+	PlannerTiming &Time = timing;
 	Time.Start("Overall");
-	Time.Start("PlanningUnit");
+	Time.Start("Problem");
 
 	std::cout << "Instantiating the problem..." << std::endl;
 
@@ -88,6 +88,8 @@ void GMAAPlanner::Plan(ArgumentHandlers::Arguments args) {
 	decpomdp = std::unique_ptr<DecPOMDPDiscreteInterface>(
 				ArgumentUtils::GetDecPOMDPDiscreteInterfaceFromArgs(args));
 
+	Time.Stop("Problem");
+
 	std::cout << "...done." << std::endl;
 
 	// Set parameters
@@ -95,9 +97,7 @@ void GMAAPlanner::Plan(ArgumentHandlers::Arguments args) {
 	double V = -DBL_MAX;
 
 	// Setup params for the gmaa unit
-	PlanningUnitMADPDiscreteParameters params;
-	params.SetComputeAll(false);
-	params.SetUseSparseJointBeliefs(args.sparse);
+	PlanningUnitMADPDiscreteParameters params = GetParameters(args);
 
 	std::cout << "Instantiating the planning unit..." << std::endl;
 	Time.Start("PlanningUnit");
@@ -139,9 +139,7 @@ void GMAAPlanner::Plan(ArgumentHandlers::Arguments args) {
 		}
 
 	} catch(std::bad_alloc &e) {
-		std::stringstream stream;
-		stream << "GMAA ran out of memory while computing the QHeuristic:\n" << e.what();
-		throw(stream);
+		throw EOutOfMemory(std::string("GMAA ran out of memory while computing the QHeuristic: ") + e.what());
 	}
 
 	Time.Stop("ComputeQ");
@@ -151,6 +149,13 @@ void GMAAPlanner::Plan(ArgumentHandlers::Arguments args) {
 
 	// While a restart left and no error has occurred
 	for(int restartI = 0; (restartI < args.nrRestarts) && !errorOccurred; restartI++) {
+
+		// The best policy of the restarts so far is kept
+		if(restartI > 0 && StopRequested()) {
+			std::cout << "GMAA stopped after " << restartI << " runs" << std::endl;
+			break;
+		}
+
 		std::cout << std::endl << "GMAA run " << restartI+1 << "/"
 			 << args.nrRestarts << " starting" << std::endl;
 
@@ -170,7 +175,7 @@ void GMAAPlanner::Plan(ArgumentHandlers::Arguments args) {
 
 		  // Catch and propagate back up to planner manager
 		} catch(std::bad_alloc &e) {
-			throw E("GMAA Ran out or memory whilst planning");
+			throw EOutOfMemory("GMAA ran out of memory whilst planning");
 
 			// Next restart
 			errorOccurred = true;
@@ -257,13 +262,17 @@ void GMAAPlanner::Plan(ArgumentHandlers::Arguments args) {
 			}
 		}
 
+		// Offered once checked, restarts of k-GMAA can find better policies
+		boost::shared_ptr<JointPolicyPureVector> runPolicy(gmaa->GetJointPolicyDiscretePure()->ToJointPolicyPureVector());
+		OfferPolicy(gmaa, *runPolicy, V);
+
 		// Simulations running
 		std::cout << "Running Simulation to determine control quality..." << std::endl;
 
 		// Get joint policy
 		boost::shared_ptr<JointPolicyDiscretePure> found_jpol;
 		if(!args.useBGclustering) {
-			found_jpol = gmaa->GetJointPolicyDiscretePure()->ToJointPolicyPureVector();
+			found_jpol = runPolicy;
 		}
 
 		Time.Start("Simulation");
@@ -318,6 +327,16 @@ void GMAAPlanner::Plan(ArgumentHandlers::Arguments args) {
 	pUnit = std::unique_ptr<GeneralizedMAAStarPlannerForDecPOMDPDiscrete>(gmaa);
 }
 
+
+PlanningUnitMADPDiscreteParameters GMAAPlanner::GetParameters(const ArgumentHandlers::Arguments &args) const {
+	PlanningUnitMADPDiscreteParameters params;
+	params.SetComputeAll(false);
+	params.SetUseSparseJointBeliefs(args.sparse);
+
+	return params;
+}
+
+
 void GMAAPlanner::SampleRandomPolicy(const ArgumentHandlers::Arguments &args) {
 	NullPlanner* np = new NullPlanner(args.horizon, decpomdp.get());
 
@@ -363,9 +382,7 @@ GMAAPlanner::GetGMAAInstance(const PlanningUnitMADPDiscreteParameters &params,
 			case MAAstar:
 
 				if(!bgipsc_p->IsExactSolver()) {
-					std::cout << "Error: MAAstar requires an exact BG solver, and "
-						 << bgipsc_p->SoftPrintBrief() << " is not" << std::endl;
-					exit(1);
+					throw E("MAAstar requires an exact BG solver, and " + bgipsc_p->SoftPrintBrief() + " is not");
 				}
 
 				gmaaToReturn = new GMAA_MAAstarCluster(bgipsc_p, args.horizon, decpomdp.get(), &params, args.verbose);
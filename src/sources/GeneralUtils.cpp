@@ -1,5 +1,38 @@
 #include "GeneralUtils.h"
 
+// Qt
+#include <QFile>
+#include <QTextStream>
+
+#ifdef Q_OS_LINUX
+#include <sys/resource.h>
+#endif
+
+///
+/// \brief Reads a field given in kB from a file such as /proc/self/status
+/// \param filePath The file, /proc/self/status or /proc/meminfo
+/// \param field The name of the field, such as VmRSS
+/// \return The value in bytes, 0 if it could not be read
+///
+static size_t ReadKilobyteField(const QString &filePath, const QString &field) {
+	QFile file(filePath);
+
+	if(!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+		return 0;
+	}
+
+	// Lines look like "VmRSS:	   1234 kB"
+	QTextStream stream(&file);
+
+	for(QString line = stream.readLine(); !line.isNull(); line = stream.readLine()) {
+		if(line.startsWith(field + ":")) {
+			return line.section(':', 1).simplified().section(' ', 0, 0).toULongLong() * 1024;
+		}
+	}
+
+	return 0;
+}
+
 
 QColor ColourUtils::GetColourFromID(const int &id) {
 
@@ -43,3 +76,51 @@ QColor ColourUtils::GetColourFromID(const int &id) {
 	// Default to black, shouldn't get here
 	return QColor("black");
 }
+
+
+size_t MemoryUtils::GetResidentMemory() {
+	return ReadKilobyteField("/proc/self/status", "VmRSS");
+}
+
+
+size_t MemoryUtils::GetPeakResidentMemory() {
+	return ReadKilobyteField("/proc/self/status", "VmHWM");
+}
+
+
+size_t MemoryUtils::GetAvailableMemory() {
+	return ReadKilobyteField("/proc/meminfo", "MemAvailable");
+}
+
+
+bool MemoryUtils::LimitFurtherMemory(const size_t &bytes) {
+#ifdef Q_OS_LINUX
+	// The address space already holds the libraries and heap, which count towards the limit
+	size_t mapped = ReadKilobyteField("/proc/self/status", "VmSize");
+
+	if(mapped == 0) {
+		return false;
+	}
+
+	struct rlimit limit;
+	limit.rlim_cur = mapped + bytes;
+	limit.rlim_max = mapped + bytes;
+
+	return setrlimit(RLIMIT_AS, &limit) == 0;
+#else
+	Q_UNUSED(bytes);
+	return false;
+#endif
+}
+
+
+bool MemoryUtils::ResetPeakResidentMemory() {
+	// Writing 5 resets the peak, Linux 4.0 and later
+	QFile file("/proc/self/clear_refs");
+
+	if(!file.open(QIODevice::WriteOnly)) {
+		return false;
+	}
+
+	return file.write("5") == 1;
+}
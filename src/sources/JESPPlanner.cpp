@@ -2,7 +2,6 @@
 
 #include "JESPExhaustivePlanner.h"
 #include "JESPDynamicProgrammingPlanner.h"
-#include "Timing.h"
 
 #include "argumentUtils.h"
 
@@ -16,20 +15,17 @@ void JESPPlanner::Plan(ArgumentHandlers::Arguments args) {
 	args.dryrun = true;
 
 	// Start timers
-	Timing Time;
+	PlannerTiming &Time = timing;
 	Time.Start("Overall");
 
+	Time.Start("Problem");
 	decpomdp = std::unique_ptr<DecPOMDPDiscreteInterface>(ArgumentUtils::GetDecPOMDPDiscreteInterfaceFromArgs(args));
+	Time.Stop("Problem");
 
 	//Initialization of the planner with typical options for JESP:
 	Time.Start("PlanningUnit");
 
-	PlanningUnitMADPDiscreteParameters params;
-	params.SetComputeAll(true);
-	params.SetComputeJointActionObservationHistories(false);
-	params.SetComputeJointObservationHistories(false);
-	params.SetComputeJointBeliefs(false);
-	params.SetUseSparseJointBeliefs(args.sparse);
+	PlanningUnitMADPDiscreteParameters params = GetParameters(args);
 
 	// Sufficient to set directly on the pUnit in this class
 	if(args.jesp == JESPtype::JESPExhaustive) {
@@ -46,6 +42,13 @@ void JESPPlanner::Plan(ArgumentHandlers::Arguments args) {
 
 	// Do for all restarts
 	for(int restartI = 0; restartI < args.nrRestarts; restartI++) {
+
+		// The best policy of the runs so far is kept
+		if(restartI > 0 && StopRequested()) {
+			std::cout << "JESP stopped after " << restartI << " runs" << std::endl;
+			break;
+		}
+
 		std::cout << "JESP Run: "  << restartI+1 << "/" << args.nrCERestarts << std::endl;
 
 		//start all timers:
@@ -57,8 +60,22 @@ void JESPPlanner::Plan(ArgumentHandlers::Arguments args) {
 
 		// Stop all timers
 		Time.Stop("Plan");
+
+		OfferPolicy(pUnit.get(), *pUnit->GetJointPolicyPureVector(), pUnit->GetExpectedReward());
 	}
 
 	Time.Stop("Overall");
 	Time.PrintSummary();
 }
+
+
+PlanningUnitMADPDiscreteParameters JESPPlanner::GetParameters(const ArgumentHandlers::Arguments &args) const {
+	PlanningUnitMADPDiscreteParameters params;
+	params.SetComputeAll(true);
+	params.SetComputeJointActionObservationHistories(false);
+	params.SetComputeJointObservationHistories(false);
+	params.SetComputeJointBeliefs(false);
+	params.SetUseSparseJointBeliefs(args.sparse);
+
+	return params;
+}
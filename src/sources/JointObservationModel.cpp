@@ -0,0 +1,138 @@
+#include "JointObservationModel.h"
+
+#include <algorithm>
+#include <numeric>
+
+
+JointObservationModel::JointObservationModel(const std::vector<Entry> &jointObservations,
+											 const std::function<QString(Index)> &nameFunction,
+											 QObject* parent) : QAbstractTableModel(parent) {
+	entries = jointObservations;
+	names = std::vector<QString>(entries.size());
+	getName = nameFunction;
+}
+
+
+JointObservationModel::~JointObservationModel() {
+	//std::cout << "~JointObservationModel()" << std::endl;
+}
+
+
+int JointObservationModel::rowCount(const QModelIndex &parent) const {
+	// Table, so no children
+	return parent.isValid() ? 0 : entries.size();
+}
+
+
+int JointObservationModel::columnCount(const QModelIndex &parent) const {
+	return parent.isValid() ? 0 : 3;
+}
+
+
+QVariant JointObservationModel::data(const QModelIndex &index, int role) const {
+	if(!index.isValid() || index.row() >= (int) entries.size()) {
+		return QVariant();
+	}
+
+	const Entry &entry = entries[index.row()];
+
+	if(role == JointObservationIndexRole) {
+		return entry.joIndex;
+	}
+
+	if(role != Qt::DisplayRole) {
+		return QVariant();
+	}
+
+	switch(index.column()) {
+		case IndexColumn:
+			return entry.joIndex;
+		case NameColumn:
+			return GetName(index.row());
+		case ProbabilityColumn:
+			return QString::number(entry.probability*100) + "%";
+	}
+
+	return QVariant();
+}
+
+
+QVariant JointObservationModel::headerData(int section, Qt::Orientation orientation, int role) const {
+	if(orientation != Qt::Horizontal || role != Qt::DisplayRole) {
+		return QVariant();
+	}
+
+	switch(section) {
+		case IndexColumn:
+			return "Index";
+		case NameColumn:
+			return "Name";
+		case ProbabilityColumn:
+			return "Probability";
+	}
+
+	return QVariant();
+}
+
+
+void JointObservationModel::sort(int column, Qt::SortOrder order) {
+	emit layoutAboutToBeChanged();
+
+	// New order as the old row of each entry
+	std::vector<int> rowOrder(entries.size());
+	std::iota(rowOrder.begin(), rowOrder.end(), 0);
+
+	std::function<bool(int, int)> lessThan;
+
+	switch(column) {
+		case NameColumn:
+			lessThan = [this](int a, int b) { return GetName(a) < GetName(b); };
+			break;
+		case ProbabilityColumn:
+			lessThan = [this](int a, int b) { return entries[a].probability < entries[b].probability; };
+			break;
+		default:
+			lessThan = [this](int a, int b) { return entries[a].joIndex < entries[b].joIndex; };
+			break;
+	}
+
+	if(order == Qt::AscendingOrder) {
+		std::stable_sort(rowOrder.begin(), rowOrder.end(), lessThan);
+	} else {
+		std::stable_sort(rowOrder.begin(), rowOrder.end(), [&lessThan](int a, int b) { return lessThan(b, a); });
+	}
+
+	// Reorder the rows and any names already created
+	std::vector<Entry> sortedEntries(entries.size());
+	std::vector<QString> sortedNames(entries.size());
+	std::vector<int> newRow(entries.size());
+
+	for(size_t row=0; row<rowOrder.size(); ++row) {
+		sortedEntries[row] = entries[rowOrder[row]];
+		sortedNames[row].swap(names[rowOrder[row]]);
+		newRow[rowOrder[row]] = row;
+	}
+
+	entries.swap(sortedEntries);
+	names.swap(sortedNames);
+
+	// Keep the selection on the same joint observations
+	QModelIndexList oldIndexes = persistentIndexList();
+	QModelIndexList newIndexes;
+
+	for(const QModelIndex &oldIndex : oldIndexes) {
+		newIndexes.append(index(newRow[oldIndex.row()], oldIndex.column()));
+	}
+
+	changePersistentIndexList(oldIndexes, newIndexes);
+	emit layoutChanged();
+}
+
+
+const QString& JointObservationModel::GetName(const int &row) const {
+	if(names[row].isEmpty()) {
+		names[row] = getName(entries[row].joIndex);
+	}
+
+	return names[row];
+}
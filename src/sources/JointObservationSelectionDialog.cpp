@@ -1,15 +1,14 @@
 #include "JointObservationSelectionDialog.h"
-#include "NumSortTreeWidgetItem.h"
+#include "JointObservationModel.h"
 
 
-JointObservationSelectionDialog::JointObservationSelectionDialog(QTreeWidget* widget, QWidget *parent) : QDialog(parent) {
+JointObservationSelectionDialog::JointObservationSelectionDialog(QTreeView* view, QWidget *parent) : QDialog(parent) {
 	// Setup UI
 	verticalLayout = new QVBoxLayout(this);
-	treeWidget = widget;
-	treeWidget->setParent(this);
+	treeView = view;
+	treeView->setParent(this);
 
-	//treeWidget = new QTreeWidget(this);
-	verticalLayout->addWidget(treeWidget);
+	verticalLayout->addWidget(treeView);
 	resize(500, 300);
 
 	buttonBox = new QDialogButtonBox(this);
@@ -24,15 +23,20 @@ JointObservationSelectionDialog::JointObservationSelectionDialog(QTreeWidget* wi
 	connect(buttonBox, &QDialogButtonBox::rejected, this, &JointObservationSelectionDialog::Reject);
 
 	// Double click acts as accept
-	connect(treeWidget, SIGNAL(itemDoubleClicked(QTreeWidgetItem*, int)), this, SLOT(Accept()));
-	treeWidget->setCurrentItem(treeWidget->topLevelItem(0));
-	treeWidget->resizeColumnToContents(1);
+	connect(treeView, &QTreeView::doubleClicked, this, &JointObservationSelectionDialog::Accept);
+	treeView->setCurrentIndex(treeView->model()->index(0, 0));
+	treeView->resizeColumnToContents(1);
 }
 
 
 void JointObservationSelectionDialog::Accept() {
+	QModelIndex selected = treeView->currentIndex();
+
 	// We can only have one selected, emit the JO Index
-	emit SendJointObservation(treeWidget->selectedItems().first()->text(0).toInt());
+	if(selected.isValid()) {
+		emit SendJointObservation(selected.data(JointObservationModel::JointObservationIndexRole).toInt());
+	}
+
 	close();
 }
 
@@ -1,5 +1,16 @@
 #include "MainWindow.h"
+#include "BatchExporter.h"
+#include "SyntheticGenerator.h"
+#include "PlanWorker.h"
+#include "TreeVisGraphicsView.h"
 #include <QApplication>
+#include <QSettings>
+
+#ifdef TREEVIS_BENCHMARK
+#include "RenderBenchmark.h"
+#include "PolicyBenchmark.h"
+#include "PlannerBenchmark.h"
+#endif
 
 ///
 /// Entry point for the Qt Application.
@@ -14,6 +25,54 @@ int main(int argc, char** argv) {
 	QCoreApplication::setOrganizationName("UoL");
 	QCoreApplication::setApplicationVersion("1.0");
 
+#ifdef TREEVIS_BENCHMARK
+	// The benchmark build only runs the benchmarks, drawing offscreen so no display is needed
+	qputenv("QT_QPA_PLATFORM", "offscreen");
+	QApplication benchmarkApp(argc, argv);
+
+	if(PolicyBenchmark::IsRequested(argc, argv)) {
+		return PolicyBenchmark::RunFromCommandLine(benchmarkApp.arguments());
+	}
+
+	if(PlannerBenchmark::IsRequested(argc, argv)) {
+		return PlannerBenchmark::RunFromCommandLine(benchmarkApp.arguments());
+	}
+
+	return RenderBenchmark::RunFromCommandLine(benchmarkApp.arguments());
+#endif
+
+	// Planning for the window in a child process, no window of its own
+	if(PlanWorker::IsRequested(argc, argv)) {
+		QCoreApplication a(argc, argv);
+
+		return PlanWorker::RunFromCommandLine(a.arguments());
+	}
+
+	// Generating files needs no window at all
+	if(SyntheticGenerator::IsRequested(argc, argv)) {
+		QCoreApplication a(argc, argv);
+
+		return SyntheticGenerator::RunFromCommandLine(a.arguments());
+	}
+
+	// Export without a window, drawing offscreen so no display is needed
+	if(BatchExporter::IsRequested(argc, argv)) {
+		qputenv("QT_QPA_PLATFORM", "offscreen");
+		QApplication a(argc, argv);
+
+		return BatchExporter::RunFromCommandLine(a.arguments());
+	}
+
+	// Software OpenGL has to be chosen before the application is created
+	QSettings settings;
+
+	if(settings.value("view/viewport").toInt() == TreeVisGraphicsView::SoftwareOpenGLViewport) {
+		QCoreApplication::setAttribute(Qt::AA_UseSoftwareOpenGL);
+
+		// Mesa picks llvmpipe when asked for software rendering
+		qputenv("LIBGL_ALWAYS_SOFTWARE", "1");
+	}
+
 	// Create application, show it
     QApplication a(argc, argv);
     MainWindow w;
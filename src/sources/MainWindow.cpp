@@ -5,6 +5,7 @@
 #include "StartPlanWizard.h"
 #include "PreviousPlanWizard.h"
 #include "SettingsDialog.h"
+#include "TraceRecorder.h"
 
 // Smart pointers
 #include <memory>
@@ -29,6 +30,11 @@ MainWindow::MainWindow(QWidget* parent) : QMainWindow(parent), ui(new Ui::MainWi
 	// Connect slots for finished events
 	connect(pManager.get(), &PlannerManager::PlanEnded, this, &MainWindow::PlanEnded); // SIGNAL(PlanSucceeded()), this, SLOT(PlanSucceeded()));
 	connect(pManager.get(), &PlannerManager::PreviousPlanEnded, this, &MainWindow::PreviousPlanEnded);
+	connect(pManager.get(), &PlannerManager::PlanProgress, this, &MainWindow::PlanProgress);
+	connect(pManager.get(), &PlannerManager::BestPolicyFound, this, &MainWindow::BestPolicyFound);
+
+	// Fonts, colours and viewport saved from the settings dialog, before the views are created with them
+	SettingsDialog::ApplySavedSettings();
 
 	// Setup the UI
 	ui->SetupUi(this, pManager.get());
@@ -38,34 +44,15 @@ MainWindow::MainWindow(QWidget* parent) : QMainWindow(parent), ui(new Ui::MainWi
 	informationMessageBox->setStandardButtons(0);
 	informationMessageBox->setWindowFlags(Qt::Dialog);
 
-	QSettings settings;
-
-	// If settings have been created
-	if(settings.contains("node/fillColour")) {
-		Node::SetDefaultFillColour(settings.value("node/fillColour").value<QColor>());
-		Node::SetDefaultOutlineColour(settings.value("node/outlineColour").value<QColor>());
-		Node::SetDefaultTextColour(settings.value("node/textColour").value<QColor>());
-
-		Edge::SetDefaultColour(settings.value("edge/colour").value<QColor>());
-		Edge::SetDefaultTextColour(settings.value("edge/textColour").value<QColor>());
-
-		QFont font = settings.value("font/font").value<QFont>();
-		font.setPointSize(settings.value("font/size").toInt());
+	// Clicking either closes the box, so the views can be used while planning
+	showBestPolicyButton = informationMessageBox->addButton("Show Best So Far", QMessageBox::ActionRole);
+	stopPlanningButton = informationMessageBox->addButton("Stop Planning", QMessageBox::ActionRole);
+	connect(showBestPolicyButton, &QPushButton::clicked, this, &MainWindow::ActionShowBestPolicy);
+	connect(stopPlanningButton, &QPushButton::clicked, this, &MainWindow::ActionStopPlanning);
 
-		Node::SetFont(font);
-		Edge::SetFont(font);
-	} else {
-		// Otherwise use hard coded defaults
-		Node::SetDefaultFillColour(QColor("white"));
-		Node::SetDefaultOutlineColour(QColor("black"));
-		Node::SetDefaultTextColour(QColor("black"));
-
-		Edge::SetDefaultColour(QColor("black"));
-		Edge::SetDefaultTextColour(QColor("black"));
-
-		QFont font = QFont("Helvetica", 12);
-		Node::SetFont(font);
-		Edge::SetFont(font);
+	// Record from launch, so the first plan is traced too
+	if(qEnvironmentVariableIsSet("TREEVIS_TRACE")) {
+		ui->actionRecordTrace->setChecked(true);
 	}
 }
 
@@ -101,19 +88,85 @@ void MainWindow::ActionSetSettings() {
 	dialog->setModal(true);
 	dialog->setAttribute(Qt::WA_DeleteOnClose);
 
+	// The dialog previews fonts by changing them for every item
+	QFont oldFont = Node::GetFont();
+
 	// Get result
 	int result = dialog->exec();
 
-	// If new settings, reset visualiser tools to use new values
+	// If new settings, update the visualiser tools to use new values
 	if(result == QDialog::Accepted) {
 
-		// If planned reset
-		if(pManager->HasPlanned()) {
-			emit PlanStarting();
-			emit PlanFinished();
-		}
+		// Items already shown are restyled in place, nothing is regenerated.
+		// Sent without a plan too, the views apply the viewport settings
+		emit SettingsChanged(Node::GetFont() != oldFont);
 
 		AppendToInformationText("Settings saved", Green);
+	} else {
+		// Undo the preview
+		Node::SetFont(oldFont);
+		Edge::SetFont(oldFont);
+	}
+}
+
+
+void MainWindow::ActionStopPlanning() {
+	pManager->StopPlanning();
+
+	ui->actionStopPlanning->setEnabled(false);
+	stopPlanningButton->setEnabled(false);
+	AppendToInformationText("Stopping the plan, the best policy found will be kept", Orange);
+
+	// Shown again, the plan may finish its current run first
+	informationMessageBox->setText("The plan is stopping...\n\nThe run in progress may need to finish "
+								   "if no policy has been found yet.");
+	informationMessageBox->show();
+}
+
+
+void MainWindow::ActionShowBestPolicy() {
+	QString message;
+
+	if(!pManager->UseBestPolicy(message)) {
+		AppendToInformationText("Could not show the best policy so far: " + message.toStdString(), Red);
+		return;
+	}
+
+	informationMessageBox->hide();
+
+	// Rebuilt as for a finished plan
+	emit PlanStarting();
+	emit PlanFinished();
+	bestPolicyShown = true;
+
+	AppendToInformationText("Showing the best policy so far, planning carries on. "
+							"File > Stop Planning keeps it as the plan", Orange);
+}
+
+
+void MainWindow::ActionRecordTrace(bool checked) {
+	TraceRecorder::SetEnabled(checked);
+
+	if(checked) {
+		AppendToInformationText("Recording trace");
+	} else {
+		AppendToInformationText("Stopped recording trace");
+	}
+}
+
+
+void MainWindow::ActionExportTrace() {
+	QString filePath = QFileDialog::getSaveFileName(this, "Export Trace", QDir::homePath(), "Chrome Trace (*.json)");
+
+	if(filePath.isEmpty()) {
+		return;
+	}
+
+	if(TraceRecorder::WriteChromeTrace(filePath)) {
+		AppendToInformationText("Trace written to " + filePath.toStdString() +
+								", open it in chrome://tracing or Perfetto", Green);
+	} else {
+		AppendToInformationText("Could not write trace to " + filePath.toStdString(), Red);
 	}
 }
 
@@ -127,27 +180,72 @@ void MainWindow::StartPlan(PlannerManager::PlannerType type, ArgumentHandlers::A
 
 	informationMessageBox->setWindowTitle("Planning");
 	informationMessageBox->setText("The plan is currently running...");
+
+	// BFS plans in one run, with no best policy before the end or point to stop at
+	bool stoppable = (type != PlannerManager::BFS);
+	SetPlanningActions(true, stoppable);
+
+	if(!stoppable) {
+		AppendToInformationText("BFS cannot be stopped early or show a best policy so far, "
+								"it runs until the plan is complete", Orange);
+	}
+
 	informationMessageBox->show();
 
-	// Start the computation
-	QtConcurrent::run(pManager.get(), &PlannerManager::Plan, type, args);
+	// Start the computation, in a child process unless turned off in the settings
+	QSettings settings;
+
+	if(settings.value("planning/separateProcess", true).toBool()) {
+		pManager->PlanInWorker(type, args, settings.value("planning/memoryBudgetMB", 0).toInt());
+	} else {
+		pManager->PlanInBackground(type, args);
+	}
+}
+
+
+void MainWindow::PlanProgress(QString text) {
+	informationMessageBox->setText("The plan is currently running...\n\n" + text);
+}
+
+
+void MainWindow::BestPolicyFound(double value) {
+	AppendToInformationText("Best policy so far has value " + std::to_string(value));
+
+	informationMessageBox->setText("The plan is currently running...\n\nBest policy so far has value " +
+								   QString::number(value));
+	showBestPolicyButton->setEnabled(true);
+	ui->actionShowBestPolicy->setEnabled(true);
 }
 
 
 void MainWindow::PlanEnded(bool success, QString errorMessage) {
+	// Views showing the best policy so far refer to what the plan replaced, cleared before any events
+	if(success && bestPolicyShown) {
+		emit PlanStarting();
+	}
+
 	informationMessageBox->hide();
 	QApplication::processEvents(); // Ensure hidden
 
+	SetPlanningActions(false);
+
 	// If the plan was a success
 	if(success) {
 		AppendToInformationText("Plan finished", Green);
 		emit PlanFinished();
 	} else {
 
+		// The best policy shown while planning is still valid
+		if(bestPolicyShown) {
+			errorMessage += "\n\nThe best policy found before then is still shown.";
+		}
+
 		// Otherwise an error was thrown
 		AppendToInformationText("Plan did not succeed: " + errorMessage.toStdString(), Red);
 		QMessageBox::critical(this, "MADP Tree Vis", errorMessage);
 	}
+
+	bestPolicyShown = false;
 }
 
 
@@ -157,6 +255,8 @@ void MainWindow::PreviousPlan(std::string policyFilePath, ArgumentHandlers::Argu
 
 	informationMessageBox->setWindowTitle("Loading Policy");
 	informationMessageBox->setText("The policy is currently being loaded...");
+	showBestPolicyButton->hide();
+	stopPlanningButton->hide();
 	informationMessageBox->show();
 
 	AppendToInformationText("Attempting to load policy from " + policyFilePath + " with given arguments");
@@ -213,3 +313,19 @@ void MainWindow::AppendToInformationText(const std::string& text, const textStyl
 	// Insert (at the top)
 	ui->informationTextOutput->insertHtml(toAppend);
 }
+
+
+void MainWindow::SetPlanningActions(const bool &planning, const bool &stoppable) {
+	// Another plan would replace the one running
+	ui->actionNewPlan->setEnabled(!planning);
+	ui->actionLoadSavedPolicy->setEnabled(!planning);
+	ui->actionStopPlanning->setEnabled(planning && stoppable);
+
+	// Enabled once a policy is found
+	ui->actionShowBestPolicy->setEnabled(false);
+	showBestPolicyButton->setEnabled(false);
+
+	stopPlanningButton->setEnabled(planning && stoppable);
+	showBestPolicyButton->setVisible(planning && stoppable);
+	stopPlanningButton->setVisible(planning && stoppable);
+}
@@ -6,6 +6,7 @@
 #include <QFontMetrics>
 #include <QPen>
 #include <QPainter>
+#include <QStyleOptionGraphicsItem>
 #include <QGraphicsSceneMouseEvent>
 #include <QAction>
 
@@ -14,6 +15,7 @@ QColor Node::defaultOutlineColour;
 QColor Node::defaultTextColour;
 QFontMetricsF Node::fontMetrics = QFontMetricsF(font);
 QFont Node::font;
+const QColor Node::highlightColour = QColor(255, 140, 0);
 
 
 Node::Node(const QString &text, const Index &ohi, const Index &ai) {
@@ -65,11 +67,73 @@ Index Node::GetOHIndex() const {
 }
 
 
+const QString& Node::GetText() const {
+	return nodeText;
+}
+
+
 Index Node::GetAgentIndex() const {
 	return agentIndex;
 }
 
 
+void Node::SetTimeStep(const Index &step) {
+	timeStep = step;
+}
+
+
+Index Node::GetTimeStep() const {
+	return timeStep;
+}
+
+
+void Node::SetExpandable(const bool &canExpand) {
+	expandable = canExpand;
+}
+
+
+bool Node::IsExpandable() const {
+	return expandable;
+}
+
+
+void Node::SetExpanded(const bool &isExpanded) {
+	expanded = isExpanded;
+}
+
+
+bool Node::IsExpanded() const {
+	return expanded;
+}
+
+
+void Node::SetHighlighted(const bool &isHighlighted) {
+	// Thicker outline extends the bounding rect
+	prepareGeometryChange();
+	highlighted = isHighlighted;
+	update();
+}
+
+
+bool Node::IsHighlighted() const {
+	return highlighted;
+}
+
+
+QSizeF Node::GetSizeForText(const QString &text) {
+	// 1 margin for bounding, as in boundingRect()
+	const int margin = 1;
+	return OutlineRectForText(text).adjusted(-margin, -margin, +margin, +margin).size();
+}
+
+
+void Node::RefreshStyle() {
+	// Size depends on the font so the geometry may have changed
+	prepareGeometryChange();
+	update();
+}
+
+
 int Node::GetWidth() {
 	return boundingRect().width();
 }
@@ -99,8 +163,13 @@ void Node::SetOutlineColour(const QColor &newColour) {
 
 
 QRectF Node::OutlineRect() const {
+	return OutlineRectForText(nodeText);
+}
+
+
+QRectF Node::OutlineRectForText(const QString &text) {
 	// Get rect based on text
-	QRectF rect = fontMetrics.boundingRect(nodeText);
+	QRectF rect = fontMetrics.boundingRect(text);
 
 	// Add padding and centre
 	rect.adjust(-padding, -padding, +padding, +padding);
@@ -110,8 +179,8 @@ QRectF Node::OutlineRect() const {
 
 
 QRectF Node::boundingRect() const {
-	// 1 margin for bounding
-	const int margin = 1;
+	// 1 margin for bounding, half the outline sits outside the rect
+	const int margin = highlighted ? highlightWidth/2 : 1;
 	return OutlineRect().adjusted(-margin, -margin, +margin, +margin);
 }
 
@@ -126,17 +195,70 @@ QPainterPath Node::shape() const {
 }
 
 
-void Node::paint(QPainter* painter, const QStyleOptionGraphicsItem*, QWidget*) {
+void Node::paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget*) {
+	// Defaults are read here so changing them restyles existing nodes
+	QColor outline = highlighted ? highlightColour
+								 : (outlineColour.isValid() ? outlineColour : defaultOutlineColour);
+	QColor fill = fillColour.isValid() ? fillColour : defaultFillColour;
+	qreal outlineWidth = highlighted ? highlightWidth : 2;
+
+	const qreal levelOfDetail = option->levelOfDetailFromTransform(painter->worldTransform());
+
+	if(levelOfDetail < labelLevelOfDetail) {
+		QRectF rect = OutlineRect();
+
+		// A dot, highlighted nodes keep their colour so they can still be found
+		if(levelOfDetail < dotLevelOfDetail) {
+			painter->fillRect(rect, highlighted ? highlightColour : fill);
+			return;
+		}
+
+		// Text is unreadable this far out, laying it out is most of the cost
+		painter->setPen(QPen(outline, outlineWidth));
+		painter->setBrush(fill);
+		painter->drawRoundRect(rect, roundness, roundness);
+		return;
+	}
+
+	Paint(painter, nodeText, outline, fill,
+		  textColour.isValid() ? textColour : defaultTextColour,
+		  outlineWidth);
+}
+
+
+void Node::PaintDefault(QPainter* painter, const QString &text) {
+	Paint(painter, text, defaultOutlineColour, defaultFillColour, defaultTextColour);
+}
+
+
+void Node::Paint(QPainter* painter, const QString &text,
+				 const QColor &outline, const QColor &fill, const QColor &textCol,
+				 const qreal &outlineWidth) {
 	// Set pen to outline colour, brush to fill
-	painter->setPen(QPen(outlineColour, 2));
-	painter->setBrush(fillColour);
+	painter->setPen(QPen(outline, outlineWidth));
+	painter->setBrush(fill);
 
-	QRectF rect = OutlineRect();
+	QRectF rect = OutlineRectForText(text);
 	painter->drawRoundRect(rect, roundness, roundness);
 
 	painter->setFont(font);
 
 	// Change pen colour then paint text
-	painter->setPen(textColour);
-	painter->drawText(rect, Qt::AlignCenter, nodeText);
+	painter->setPen(textCol);
+	painter->drawText(rect, Qt::AlignCenter, text);
+}
+
+
+QColor Node::GetDefaultFillColour() {
+	return defaultFillColour;
+}
+
+
+QColor Node::GetDefaultOutlineColour() {
+	return defaultOutlineColour;
+}
+
+
+QColor Node::GetDefaultTextColour() {
+	return defaultTextColour;
 }
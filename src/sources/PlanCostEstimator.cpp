@@ -0,0 +1,408 @@
+#include "PlanCostEstimator.h"
+
+// TreeVis
+#include "Planner.h"
+#include "GeneralUtils.h"
+
+// MADP
+#include "gmaatype.h"
+#include "qheur.h"
+
+// Qt
+#include <QStringList>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+constexpr double PlanCostEstimator::historyBytes;
+constexpr double PlanCostEstimator::sparseBeliefFill;
+constexpr double PlanCostEstimator::operationsPerSecond;
+constexpr double PlanCostEstimator::warnMemoryFraction;
+constexpr double PlanCostEstimator::warnSeconds;
+constexpr double PlanCostEstimator::jespIterations;
+
+namespace {
+	///
+	/// \brief Adds two numbers given as base 10 logarithms without
+	/// leaving the logarithms, so neither overflows
+	/// \param a The logarithm of the first number
+	/// \param b The logarithm of the second number
+	/// \return The logarithm of the sum
+	///
+	double AddLog10(const double &a, const double &b) {
+		double larger = std::max(a, b);
+		double smaller = std::min(a, b);
+
+		if(std::isinf(larger) || smaller == -std::numeric_limits<double>::infinity()) {
+			return larger;
+		}
+
+		return larger + std::log10(1 + std::pow(10, smaller - larger));
+	}
+
+	///
+	/// \brief Reads a count from the arguments, treating 0 as once
+	/// \param count The count
+	/// \return The count, at least 1
+	///
+	double AtLeastOne(const double &count) {
+		return std::max(1.0, count);
+	}
+
+	///
+	/// \brief Gets a readable count
+	/// \param count The count
+	/// \return The count in full when small, otherwise its power of ten
+	///
+	QString FormatCount(const double &count) {
+		if(std::isinf(count)) {
+			return "more than 10^308";
+		}
+
+		if(count < 1e9) {
+			return QString::number(count, 'f', 0);
+		}
+
+		return QString("about 10^%1").arg(std::floor(std::log10(count)));
+	}
+}
+
+
+PlanCostEstimator::PlanCostEstimator(const DecPOMDPDiscreteInterface &decpomdp) {
+	nrAgents = decpomdp.GetNrAgents();
+	nrStates = decpomdp.GetNrStates();
+	nrJointActions = 1;
+	nrJointObservations = 1;
+
+	for(Index i=0; i<nrAgents; ++i) {
+		nrActions.push_back(decpomdp.GetNrActions(i));
+		nrObservations.push_back(decpomdp.GetNrObservations(i));
+
+		nrJointActions *= nrActions.back();
+		nrJointObservations *= nrObservations.back();
+	}
+}
+
+
+PlanCostEstimator::~PlanCostEstimator() {
+	//std::cout << "~PlanCostEstimator()" << std::endl;
+}
+
+
+double PlanCostEstimator::CountHistories(const double &branching, const Index &horizon) {
+	double count = 0;
+	double length = 1;
+
+	for(Index t=0; t<horizon; ++t) {
+		count += length;
+		length *= branching;
+	}
+
+	return count;
+}
+
+
+double PlanCostEstimator::GetLog10BayesianGameOperations(const ArgumentHandlers::Arguments &args,
+														 const Index &horizon) const {
+	double total = -std::numeric_limits<double>::infinity();
+
+	// A Bayesian game for each stage, its types the histories of that length
+	for(Index t=0; t<horizon; ++t) {
+		double log10JointTypes = t * std::log10(nrJointObservations);
+		double log10Policies = 0;
+		double typeActions = 0;
+
+		for(Index i=0; i<nrAgents; ++i) {
+			double types = std::pow(nrObservations[i], (double) t);
+			log10Policies += types * std::log10(nrActions[i]);
+			typeActions += types * nrActions[i];
+		}
+
+		double stage;
+
+		switch(args.bgsolver) {
+
+			case BGIP_SolverType::BFS:
+			case BGIP_SolverType::BFSNonInc:
+			case BGIP_SolverType::BnB:
+				// Exact solvers may visit every policy of the game
+				stage = log10Policies + log10JointTypes;
+				break;
+
+			case BGIP_SolverType::AM:
+				stage = std::log10(AtLeastOne(args.nrAMRestarts) * typeActions) + log10JointTypes;
+				break;
+
+			case BGIP_SolverType::CE:
+				stage = std::log10(AtLeastOne(args.nrCERestarts) * AtLeastOne(args.nrCEIterations) *
+								   AtLeastOne(args.nrCESamples)) + log10JointTypes;
+				break;
+
+			case BGIP_SolverType::MaxPlus:
+			case BGIP_SolverType::CGBG_MaxPlus:
+				stage = std::log10(AtLeastOne(args.maxplus_nrRestarts) * AtLeastOne(args.maxplus_maxiter) *
+								   typeActions) + log10JointTypes;
+				break;
+
+			default:
+				stage = log10JointTypes;
+				break;
+		}
+
+		total = AddLog10(total, stage);
+	}
+
+	return total;
+}
+
+
+PlanCostEstimator::Estimate PlanCostEstimator::GetEstimate(const PlannerManager::PlannerType &type,
+														   const ArgumentHandlers::Arguments &args) const {
+	Estimate estimate;
+	estimate.horizon = args.horizon;
+
+	Index horizon = args.horizon;
+	PlanningUnitMADPDiscreteParameters params = PlannerManager::CreatePlanner(type)->GetParameters(args);
+
+	// Histories of each agent
+	double individualHistories = 0;
+
+	for(Index i=0; i<nrAgents; ++i) {
+		double observationHistories = CountHistories(nrObservations[i], horizon);
+		estimate.observationHistories.push_back(observationHistories);
+		estimate.log10JointPolicies += observationHistories * std::log10(nrActions[i]);
+
+		if(params.GetComputeIndividualObservationHistories()) {
+			individualHistories += observationHistories;
+		}
+
+		if(params.GetComputeIndividualActionObservationHistories()) {
+			individualHistories += CountHistories(nrActions[i] * nrObservations[i], horizon);
+		}
+
+		if(params.GetComputeIndividualActionHistories()) {
+			individualHistories += CountHistories(nrActions[i], horizon);
+		}
+	}
+
+	// Joint histories also hold the index of each agent's history
+	estimate.jointObservationHistories = CountHistories(nrJointObservations, horizon);
+	estimate.jointActionObservationHistories = CountHistories(nrJointActions * nrJointObservations, horizon);
+
+	double jointHistories = 0;
+
+	if(params.GetComputeJointObservationHistories()) {
+		jointHistories += estimate.jointObservationHistories;
+	}
+
+	if(params.GetComputeJointActionObservationHistories()) {
+		jointHistories += estimate.jointActionObservationHistories;
+	}
+
+	if(params.GetComputeJointActionHistories()) {
+		jointHistories += CountHistories(nrJointActions, horizon);
+	}
+
+	estimate.planningUnitBytes = individualHistories * historyBytes +
+								 jointHistories * (historyBytes + 8 * nrAgents);
+
+	// A belief over the states for every joint action observation history
+	if(params.GetComputeJointBeliefs()) {
+		double beliefBytes = args.sparse ? 12 * nrStates * sparseBeliefFill : 8 * nrStates;
+		estimate.planningUnitBytes += estimate.jointActionObservationHistories * (32 + beliefBytes);
+	}
+
+	// Flat transition, observation and reward models
+	if(args.cache_flat_models) {
+		estimate.planningUnitBytes += 8 * nrStates * nrJointActions * (nrStates + nrJointObservations + 1);
+	}
+
+	// Evaluating a joint policy visits every joint history and pair of states
+	double log10Evaluation = std::log10(estimate.jointObservationHistories) + 2 * std::log10(nrStates);
+	double log10Restarts = std::log10(AtLeastOne(args.nrRestarts));
+
+	switch(type) {
+
+		case PlannerManager::BFS:
+			estimate.log10Operations = estimate.log10JointPolicies + log10Evaluation;
+			break;
+
+		case PlannerManager::GMAA: {
+			// The Q heuristic, QMDP only needs the states
+			double log10Heuristic = (args.qheur == qheur::eQMDP) ?
+										std::log10(horizon * nrStates * nrStates * nrJointActions) :
+										std::log10(estimate.jointActionObservationHistories * nrStates * nrJointActions);
+
+			// Optimal GMAA* may expand every partial joint policy, the others keep k per stage
+			double log10Search = (args.gmaa == GMAAtype::MAAstar || args.gmaa == GMAAtype::MAAstarClassic) ?
+									 estimate.log10JointPolicies + std::log10(estimate.jointObservationHistories) :
+									 std::log10(AtLeastOne(args.k)) + GetLog10BayesianGameOperations(args, horizon);
+
+			estimate.log10Operations = AddLog10(log10Heuristic, log10Search);
+			break;
+		}
+
+		case PlannerManager::JESP: {
+			// Best responses for one agent at a time until no agent improves
+			double log10BestResponse = 0;
+
+			for(Index i=0; i<nrAgents; ++i) {
+				double agentCost = (args.jesp == JESPtype::JESPExhaustive) ?
+									   estimate.observationHistories[i] * std::log10(nrActions[i]) + log10Evaluation :
+									   log10Evaluation + std::log10(nrActions[i]);
+
+				log10BestResponse = i == 0 ? agentCost : AddLog10(log10BestResponse, agentCost);
+			}
+
+			estimate.log10Operations = std::log10(jespIterations) + log10BestResponse;
+			break;
+		}
+
+		case PlannerManager::DICEPS:
+			estimate.log10Operations = std::log10(AtLeastOne(args.nrCERestarts) * AtLeastOne(args.nrCEIterations) *
+												  AtLeastOne(args.nrCESamples)) + log10Evaluation;
+			break;
+	}
+
+	estimate.log10Operations += log10Restarts;
+	estimate.seconds = std::pow(10, estimate.log10Operations) / operationsPerSecond;
+
+	// Judged against the machine, memory is a hard limit and time is not
+	estimate.availableBytes = MemoryUtils::GetAvailableMemory();
+
+	if(estimate.availableBytes > 0 && !(estimate.planningUnitBytes <= estimate.availableBytes)) {
+		estimate.result = Block;
+	} else if((estimate.availableBytes > 0 && estimate.planningUnitBytes > warnMemoryFraction * estimate.availableBytes) ||
+			  !(estimate.seconds <= warnSeconds)) {
+		estimate.result = Warn;
+	}
+
+	return estimate;
+}
+
+
+QString PlanCostEstimator::GetSuggestion(const PlannerManager::PlannerType &type,
+										 const ArgumentHandlers::Arguments &args) const {
+	QStringList suggestions;
+	ArgumentHandlers::Arguments changed = args;
+
+	// Options of the same plan
+	if(!args.sparse && PlannerManager::CreatePlanner(type)->GetParameters(args).GetComputeJointBeliefs()) {
+		changed.sparse = true;
+
+		if(GetEstimate(type, changed).result == Fits) {
+			suggestions << "Turning on sparse joint beliefs should fit.";
+		}
+
+		changed.sparse = false;
+	}
+
+	if(args.cache_flat_models) {
+		changed.cache_flat_models = false;
+
+		if(GetEstimate(type, changed).result == Fits) {
+			suggestions << "Turning off caching flat models should fit.";
+		}
+
+		changed.cache_flat_models = true;
+	}
+
+	// The longest horizon that fits
+	for(Index horizon=args.horizon; horizon-- > 1;) {
+		changed.horizon = horizon;
+
+		if(GetEstimate(type, changed).result == Fits) {
+			suggestions << QString("A horizon of %1 or less should fit.").arg(horizon);
+			break;
+		}
+	}
+
+	// Cheaper planners at the same horizon, with their usual options
+	ArgumentHandlers::Arguments gmaaArgs = args;
+	gmaaArgs.gmaa = GMAAtype::FSPC;
+	gmaaArgs.k = 1;
+	gmaaArgs.bgsolver = BGIP_SolverType::AM;
+	gmaaArgs.qheur = qheur::eQMDP;
+
+	ArgumentHandlers::Arguments jespArgs = args;
+	jespArgs.jesp = JESPtype::JESPDP;
+
+	if(!(type == PlannerManager::GMAA && args.gmaa == GMAAtype::FSPC) &&
+	   GetEstimate(PlannerManager::GMAA, gmaaArgs).result == Fits) {
+		suggestions << "GMAA* with FSPC, alternating maximisation and QMDP should fit.";
+	}
+
+	if(!(type == PlannerManager::JESP && args.jesp == JESPtype::JESPDP) &&
+	   GetEstimate(PlannerManager::JESP, jespArgs).result == Fits) {
+		suggestions << "JESP with dynamic programming should fit.";
+	}
+
+	if(type != PlannerManager::DICEPS && GetEstimate(PlannerManager::DICEPS, args).result == Fits) {
+		suggestions << "DICEPS should fit.";
+	}
+
+	return suggestions.join("\n");
+}
+
+
+QString PlanCostEstimator::Describe(const Estimate &estimate) {
+	QStringList histories;
+
+	for(const double &count : estimate.observationHistories) {
+		histories << FormatCount(count);
+	}
+
+	QStringList lines;
+	lines << QString("Horizon: %1").arg(estimate.horizon);
+	lines << "Observation histories of each agent: " + histories.join(", ");
+	lines << "Joint observation histories: " + FormatCount(estimate.jointObservationHistories);
+	lines << "Joint action observation histories: " + FormatCount(estimate.jointActionObservationHistories);
+	lines << "Joint policies: " + FormatCount(std::pow(10, estimate.log10JointPolicies));
+
+	if(estimate.availableBytes > 0) {
+		lines << "Planning unit memory: " + FormatBytes(estimate.planningUnitBytes) +
+				 " of " + FormatBytes(estimate.availableBytes) + " available";
+	} else {
+		lines << "Planning unit memory: " + FormatBytes(estimate.planningUnitBytes);
+	}
+
+	lines << "Running time: roughly " + FormatSeconds(estimate.seconds);
+
+	return lines.join("\n");
+}
+
+
+QString PlanCostEstimator::FormatBytes(const double &bytes) {
+	if(std::isinf(bytes) || bytes > 1e18) {
+		return "more than an exabyte";
+	}
+
+	QStringList units = QStringList() << "bytes" << "KB" << "MB" << "GB" << "TB" << "PB";
+	double size = bytes;
+	int unit = 0;
+
+	while(size >= 1024 && unit < units.size() - 1) {
+		size /= 1024;
+		++unit;
+	}
+
+	return QString("%1 %2").arg(size, 0, 'f', unit == 0 ? 0 : 1).arg(units[unit]);
+}
+
+
+QString PlanCostEstimator::FormatSeconds(const double &seconds) {
+	if(seconds < 1) {
+		return "under a second";
+	} else if(seconds < 60) {
+		return QString("%1 seconds").arg(seconds, 0, 'f', 0);
+	} else if(seconds < 3600) {
+		return QString("%1 minutes").arg(seconds / 60, 0, 'f', 0);
+	} else if(seconds < 86400) {
+		return QString("%1 hours").arg(seconds / 3600, 0, 'f', 0);
+	} else if(seconds < 3.2e9) {
+		return QString("%1 days").arg(seconds / 86400, 0, 'f', 0);
+	}
+
+	return "more than a century";
+}
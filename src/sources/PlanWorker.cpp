@@ -0,0 +1,615 @@
+#include "PlanWorker.h"
+#include "GeneralUtils.h"
+#include "TraceRecorder.h"
+
+// Qt
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QSharedMemory>
+
+#include <csignal>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <streambuf>
+#include <type_traits>
+
+int PlanWorker::workersStarted = 0;
+
+namespace {
+	///
+	/// \brief Sends each line written to it to the parent as a progress
+	/// message, so what the planners print reaches the window
+	///
+	class ProgressBuffer : public std::streambuf {
+
+		public:
+			ProgressBuffer(std::ostream &protocolStream) : protocol(protocolStream) {}
+
+		protected:
+			int overflow(int c) {
+				if(c == '\n') {
+					protocol << "progress " << line << std::endl;
+					line.clear();
+				} else if(c != EOF) {
+					line += static_cast<char>(c);
+				}
+
+				return c;
+			}
+
+		private:
+			/// Where the messages for the parent are written
+			std::ostream &protocol;
+
+			/// The line being written
+			std::string line;
+	};
+
+	///
+	/// \brief Sends the spans this worker recorded to the parent, before
+	/// the result so the parent has them once the worker has finished
+	/// \param protocol Where to write the messages for the parent
+	///
+	void SendTrace(std::ostream &protocol) {
+		if(TraceRecorder::IsEnabled()) {
+			TraceRecorder::WriteEvents(protocol, "trace ");
+		}
+	}
+
+	/// The manager planning in this worker, nullptr until it plans
+	PlannerManager* stoppingManager = nullptr;
+
+	///
+	/// \brief Asks the plan to stop when the parent terminates the worker
+	/// \param signalNumber The signal, SIGTERM
+	///
+	void StopOnTerminate(int signalNumber) {
+		Q_UNUSED(signalNumber);
+
+		if(stoppingManager) {
+			stoppingManager->StopPlanning();
+		}
+	}
+}
+
+
+PlanWorker::PlanWorker(QObject* parent) : QObject(parent) {
+
+}
+
+
+PlanWorker::~PlanWorker() {
+	//std::cout << "~PlanWorker()" << std::endl;
+
+	// Nothing is reported once the worker is gone
+	if(process) {
+		process->disconnect(this);
+		process->kill();
+		process->waitForFinished();
+	}
+}
+
+
+bool PlanWorker::IsRequested(int argc, char** argv) {
+	for(int i=1; i<argc; ++i) {
+		if(strcmp(argv[i], "--plan-worker") == 0) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
+template <typename T>
+void PlanWorker::StreamField(QDataStream &stream, T &field, const bool &reading) {
+	typedef typename std::conditional<std::is_floating_point<T>::value, double, qint64>::type Wire;
+
+	if(reading) {
+		Wire value;
+		stream >> value;
+		field = static_cast<T>(value);
+	} else {
+		stream << static_cast<Wire>(field);
+	}
+}
+
+
+void PlanWorker::StreamArguments(QDataStream &stream,
+								 qint32 &type,
+								 ArgumentHandlers::Arguments &args,
+								 QString &problemFile,
+								 const bool &reading) {
+	if(reading) {
+		stream >> type >> problemFile;
+	} else {
+		stream << type << problemFile;
+	}
+
+	// Problem
+	StreamField(stream, args.problem_type, reading);
+	StreamField(stream, args.horizon, reading);
+	StreamField(stream, args.discount, reading);
+	StreamField(stream, args.cache_flat_models, reading);
+	StreamField(stream, args.sparse, reading);
+	StreamField(stream, args.nrAgents, reading);
+	StreamField(stream, args.nrHouses, reading);
+	StreamField(stream, args.nrFLs, reading);
+	StreamField(stream, args.extinguishProb, reading);
+	StreamField(stream, args.islandConf, reading);
+	StreamField(stream, args.alohaVariation, reading);
+	StreamField(stream, args.maxBacklog, reading);
+
+	// Planners
+	StreamField(stream, args.nrRestarts, reading);
+	StreamField(stream, args.verbose, reading);
+	StreamField(stream, args.testMode, reading);
+	StreamField(stream, args.jesp, reading);
+	StreamField(stream, args.gmaa, reading);
+	StreamField(stream, args.k, reading);
+	StreamField(stream, args.GMAAdeadline, reading);
+	StreamField(stream, args.qheur, reading);
+	StreamField(stream, args.QHybridHorizonLastTimeSteps, reading);
+	StreamField(stream, args.QHybridFirstTS, reading);
+	StreamField(stream, args.QHybridLastTS, reading);
+	StreamField(stream, args.TreeIPpruneAfterCrossSum, reading);
+	StreamField(stream, args.TreeIPpruneAfterUnion, reading);
+	StreamField(stream, args.TreeIPuseVectorCache, reading);
+	StreamField(stream, args.acceleratedPruningThreshold, reading);
+	StreamField(stream, args.requireQcache, reading);
+	StreamField(stream, args.useQcache, reading);
+	StreamField(stream, args.useBGclustering, reading);
+	StreamField(stream, args.BGClusterAlgorithm, reading);
+	StreamField(stream, args.thresholdJB, reading);
+	StreamField(stream, args.thresholdPjaoh, reading);
+
+	// Bayesian game solvers
+	StreamField(stream, args.bgsolver, reading);
+	StreamField(stream, args.exactBGs, reading);
+	StreamField(stream, args.nrAMRestarts, reading);
+	StreamField(stream, args.BnB_keepAll, reading);
+	StreamField(stream, args.BnBJointTypeOrdering, reading);
+	StreamField(stream, args.BnB_consistentCompleteInformationHeur, reading);
+	StreamField(stream, args.CE_alpha, reading);
+	StreamField(stream, args.CE_use_hard_threshold, reading);
+	StreamField(stream, args.nrCEIterations, reading);
+	StreamField(stream, args.nrCERestarts, reading);
+	StreamField(stream, args.nrCESamples, reading);
+	StreamField(stream, args.nrCESamplesForUpdate, reading);
+	StreamField(stream, args.nrCEEvaluationRuns, reading);
+	StreamField(stream, args.maxplus_damping, reading);
+	StreamField(stream, args.maxplus_maxiter, reading);
+	StreamField(stream, args.maxplus_nrRestarts, reading);
+	StreamField(stream, args.maxplus_verbose, reading);
+
+	// The only argument that is text
+	if(reading) {
+		QString updateType;
+		stream >> updateType;
+		args.maxplus_updateT = updateType.toStdString();
+	} else {
+		stream << QString::fromStdString(args.maxplus_updateT);
+	}
+}
+
+
+void PlanWorker::Start(const PlannerManager::PlannerType &type,
+					   const ArgumentHandlers::Arguments &args,
+					   const int &memoryBudgetMB) {
+	ArgumentHandlers::Arguments argsCopy = args;
+	QString problemFile = args.problem_type == ProblemType::PARSE ? QString(args.dpf) : QString();
+	qint32 plannerType = type;
+
+	QByteArray encoded;
+	QDataStream stream(&encoded, QIODevice::WriteOnly);
+	StreamArguments(stream, plannerType, argsCopy, problemFile, false);
+
+	sharedMemoryKey = QString("MADP-TreeVis-plan-%1-%2").arg(QCoreApplication::applicationPid()).arg(++workersStarted);
+	memoryBudget = memoryBudgetMB;
+	horizon = args.horizon;
+
+	process = new QProcess(this);
+
+	// What the planners print to the error stream is left on the terminal
+	process->setProcessChannelMode(QProcess::ForwardedErrorChannel);
+
+	connect(process, &QProcess::readyReadStandardOutput, this, &PlanWorker::ReadOutput);
+	connect(process, static_cast<void (QProcess::*)(int, QProcess::ExitStatus)>(&QProcess::finished),
+			this, &PlanWorker::ProcessFinished);
+	connect(process, &QProcess::errorOccurred, this, &PlanWorker::ProcessError);
+
+	QStringList workerArguments;
+	workerArguments << "--plan-worker"
+					<< "--key" << sharedMemoryKey
+					<< "--arguments" << QString::fromLatin1(encoded.toBase64())
+					<< "--memory-budget" << QString::number(memoryBudget);
+
+	// The planner phases are recorded by the child, and sent back with the result
+	if(TraceRecorder::IsEnabled()) {
+		workerArguments << "--trace";
+	}
+
+	process->start(QCoreApplication::applicationFilePath(), workerArguments);
+}
+
+
+void PlanWorker::Cancel() {
+	if(process && process->state() != QProcess::NotRunning) {
+		failure = "Planning was cancelled";
+		process->kill();
+	}
+}
+
+
+void PlanWorker::Stop() {
+	if(!process || process->state() == QProcess::NotRunning) {
+		return;
+	}
+
+	if(!bestPolicies.empty()) {
+		// The best so far becomes the plan, the run in progress is not waited for
+		stopped = true;
+		process->kill();
+	} else {
+		// Nothing to keep yet, the child stops once the run in progress has found a policy
+		process->terminate();
+	}
+}
+
+
+void PlanWorker::ReadOutput() {
+	while(process->canReadLine()) {
+		QString line = QString::fromUtf8(process->readLine()).trimmed();
+
+		if(line.startsWith("progress ")) {
+			emit Progress(line.mid(9));
+		} else if(line.startsWith("trace ")) {
+			TraceRecorder::AddProcessEvent(process->processId(), "Planning Process", line.mid(6));
+		} else if(line.startsWith("best ")) {
+			if(ReadBestPolicy(line.mid(5))) {
+				emit BestPolicy(bestValue);
+			}
+		} else if(line.startsWith("failed ")) {
+			failure = line.mid(7);
+		} else if(line.startsWith("policy")) {
+			policyRead = ReadPolicy();
+
+			// The child holds the shared memory until told it has been copied
+			process->write("done\n");
+			process->closeWriteChannel();
+		}
+	}
+}
+
+
+bool PlanWorker::ReadPolicy() {
+	QSharedMemory sharedMemory(sharedMemoryKey);
+
+	if(!sharedMemory.attach(QSharedMemory::ReadOnly)) {
+		failure = "Could not read the policy from the planning process: " + sharedMemory.errorString();
+		return false;
+	}
+
+	sharedMemory.lock();
+	QByteArray data(static_cast<const char*>(sharedMemory.constData()), sharedMemory.size());
+	sharedMemory.unlock();
+	sharedMemory.detach();
+
+	QDataStream stream(data);
+	quint32 sharedHorizon, nrAgents;
+	stream >> sharedHorizon >> nrAgents >> expectedReward;
+
+	horizon = sharedHorizon;
+	policies = std::vector<std::vector<Index>>(nrAgents);
+
+	for(std::vector<Index> &policy : policies) {
+		quint32 nrObservationHistories;
+		stream >> nrObservationHistories;
+
+		policy.resize(nrObservationHistories);
+	}
+
+	for(std::vector<Index> &policy : policies) {
+		for(Index &actionIndex : policy) {
+			quint32 index;
+			stream >> index;
+			actionIndex = index;
+		}
+	}
+
+	if(stream.status() != QDataStream::Ok) {
+		failure = "The policy from the planning process was incomplete";
+		return false;
+	}
+
+	return true;
+}
+
+
+bool PlanWorker::ReadBestPolicy(const QString &line) {
+	QStringList fields = line.split(' ', QString::SkipEmptyParts);
+
+	if(fields.size() < 2) {
+		return false;
+	}
+
+	double sentValue = fields[0].toDouble();
+	int nrAgents = fields[1].toInt();
+	int next = 2;
+
+	if(nrAgents <= 0 || fields.size() < next + nrAgents) {
+		return false;
+	}
+
+	std::vector<std::vector<Index>> sentPolicies(nrAgents);
+
+	for(std::vector<Index> &policy : sentPolicies) {
+		policy.resize(fields[next++].toUInt());
+	}
+
+	for(std::vector<Index> &policy : sentPolicies) {
+		for(Index &actionIndex : policy) {
+			if(next >= fields.size()) {
+				return false;
+			}
+
+			actionIndex = fields[next++].toUInt();
+		}
+	}
+
+	bestPolicies = sentPolicies;
+	bestValue = sentValue;
+	return true;
+}
+
+
+void PlanWorker::ProcessFinished(int exitCode, QProcess::ExitStatus exitStatus) {
+	if(policyRead) {
+		emit Finished(true);
+	} else if(stopped) {
+		// Killed once a policy was found, which is kept
+		policies = bestPolicies;
+		expectedReward = bestValue;
+		emit Finished(true);
+	} else if(!failure.isEmpty()) {
+		emit Finished(false, failure);
+	} else if(exitStatus == QProcess::CrashExit) {
+		emit Finished(false, "The planning process crashed or was killed, it may have run out of memory" + BudgetNote());
+	} else {
+		emit Finished(false, QString("The planning process exited with code %1").arg(exitCode) + BudgetNote());
+	}
+}
+
+
+void PlanWorker::ProcessError(QProcess::ProcessError error) {
+	// Other errors are followed by the process finishing
+	if(error == QProcess::FailedToStart) {
+		emit Finished(false, "Could not start the planning process: " + process->errorString());
+	}
+}
+
+
+Index PlanWorker::GetHorizon() const {
+	return horizon;
+}
+
+
+double PlanWorker::GetExpectedReward() const {
+	return expectedReward;
+}
+
+
+const std::vector<std::vector<Index>>& PlanWorker::GetPolicies() const {
+	return policies;
+}
+
+
+const std::vector<std::vector<Index>>& PlanWorker::GetBestPolicies() const {
+	return bestPolicies;
+}
+
+
+int PlanWorker::RunFromCommandLine(const QStringList &arguments) {
+	QCommandLineParser parser;
+	parser.setApplicationDescription("Plans for another MADP Tree Vis process, not meant to be run by hand");
+	parser.addHelpOption();
+
+	parser.addOption(QCommandLineOption("plan-worker", "Plan for another process."));
+	parser.addOption(QCommandLineOption("key", "Key of the shared memory to write the policy to.", "key"));
+	parser.addOption(QCommandLineOption("arguments", "The planner and arguments, encoded.", "base64"));
+	parser.addOption(QCommandLineOption("memory-budget", "Megabytes the planner may allocate, 0 for no limit.", "MB", "0"));
+	parser.addOption(QCommandLineOption("trace", "Record spans and send them with the result."));
+
+	parser.process(arguments);
+
+	TraceRecorder::SetEnabled(parser.isSet("trace"));
+
+	// Messages for the parent go to the real output, everything the planners print becomes progress
+	std::ostream protocol(std::cout.rdbuf());
+	ProgressBuffer progressBuffer(protocol);
+	std::streambuf* plannerOutput = std::cout.rdbuf(&progressBuffer);
+
+	qint32 type;
+	ArgumentHandlers::Arguments args;
+	QString problemFile;
+
+	QByteArray encoded = QByteArray::fromBase64(parser.value("arguments").toLatin1());
+	QDataStream stream(encoded);
+	StreamArguments(stream, type, args, problemFile, true);
+
+	bool budgetValid;
+	int memoryBudgetMB = parser.value("memory-budget").toInt(&budgetValid);
+
+	int exitCode = 1;
+
+	if(stream.status() != QDataStream::Ok || parser.value("key").isEmpty() || !budgetValid || memoryBudgetMB < 0) {
+		protocol << "failed The planning process was given bad arguments" << std::endl;
+	} else {
+		// Allocations past the budget fail as bad_alloc, rather than the machine swapping
+		if(memoryBudgetMB > 0 && !MemoryUtils::LimitFurtherMemory(static_cast<size_t>(memoryBudgetMB) * 1024 * 1024)) {
+			protocol << "progress Could not limit the memory of the planning process, planning without a budget" << std::endl;
+		}
+
+		exitCode = PlanAndShare(static_cast<PlannerManager::PlannerType>(type), args, problemFile,
+								parser.value("key"), memoryBudgetMB, protocol);
+
+		// The manager has gone
+		std::signal(SIGTERM, SIG_DFL);
+		stoppingManager = nullptr;
+	}
+
+	std::cout.rdbuf(plannerOutput);
+	return exitCode;
+}
+
+
+int PlanWorker::PlanAndShare(const PlannerManager::PlannerType &type,
+							 ArgumentHandlers::Arguments args,
+							 const QString &problemFile,
+							 const QString &sharedMemoryKey,
+							 const int &memoryBudgetMB,
+							 std::ostream &protocol) {
+	PlannerManager manager;
+	QString planFailure;
+
+	QObject::connect(&manager, &PlannerManager::PlanEnded, [&planFailure](bool success, QString message) {
+		if(!success) {
+			planFailure = message.isEmpty() ? QString("The planner failed") : message;
+		}
+	});
+
+	// Each better policy goes to the parent straight away, on one line
+	QObject::connect(&manager, &PlannerManager::BestPolicyFound, [&manager, &protocol](double value) {
+		std::vector<std::vector<Index>> sentPolicies;
+		double sentValue;
+
+		if(!manager.GetBestPolicy(sentPolicies, sentValue)) {
+			return;
+		}
+
+		protocol << "best " << std::setprecision(17) << value << " " << sentPolicies.size();
+
+		for(const std::vector<Index> &policy : sentPolicies) {
+			protocol << " " << policy.size();
+		}
+
+		for(const std::vector<Index> &policy : sentPolicies) {
+			for(const Index &actionIndex : policy) {
+				protocol << " " << actionIndex;
+			}
+		}
+
+		protocol << std::endl;
+	});
+
+	// Terminating the worker asks it to stop between runs, keeping the best policy
+	stoppingManager = &manager;
+	std::signal(SIGTERM, StopOnTerminate);
+
+	while(true) {
+		planFailure.clear();
+		bool outOfMemory = false;
+
+		// The manager deletes the path once planned, as the wizard's is
+		if(args.problem_type == ProblemType::PARSE) {
+			std::string path = problemFile.toStdString();
+			args.dpf = new char[path.length()+1];
+			strcpy(args.dpf, path.c_str());
+		}
+
+		try {
+			manager.Plan(type, args);
+			outOfMemory = manager.RanOutOfMemory();
+		} catch(std::bad_alloc&) {
+			// Thrown while setting the policies, after the planner itself
+			planFailure = "Ran out of memory while planning";
+			outOfMemory = true;
+		} catch(...) {
+			// Some planners throw other than E
+			planFailure = "The planner threw an exception";
+		}
+
+		if(planFailure.isEmpty()) {
+			break;
+		}
+
+		QString reduction = outOfMemory ? ReduceMemory(type, args) : QString();
+
+		if(reduction.isEmpty()) {
+			if(outOfMemory && memoryBudgetMB > 0) {
+				planFailure = QString("The plan did not fit in the memory budget of %1 MB: %2").arg(memoryBudgetMB).arg(planFailure);
+			}
+
+			SendTrace(protocol);
+			protocol << "failed " << planFailure.simplified().toStdString() << std::endl;
+			return 2;
+		}
+
+		protocol << "progress Ran out of memory, retrying " << reduction.toStdString() << std::endl;
+	}
+
+	PlanningUnitDecPOMDPDiscrete* pUnit = manager.GetPlanningUnit();
+
+	// A planner that ran several times may have ended on a worse run than its best
+	double expectedValue = pUnit->GetExpectedReward();
+	std::vector<std::vector<Index>> bestRunPolicies;
+	manager.GetBestPolicy(bestRunPolicies, expectedValue);
+
+	QByteArray data;
+	QDataStream stream(&data, QIODevice::WriteOnly);
+	stream << (quint32) pUnit->GetHorizon() << (quint32) pUnit->GetNrAgents() << expectedValue;
+
+	for(Index i=0; i<pUnit->GetNrAgents(); ++i) {
+		stream << (quint32) pUnit->GetNrObservationHistories(i);
+	}
+
+	for(Index i=0; i<pUnit->GetNrAgents(); ++i) {
+		for(Index ohIndex=0; ohIndex<pUnit->GetNrObservationHistories(i); ++ohIndex) {
+			stream << (quint32) manager.GetActionIndex(i, ohIndex);
+		}
+	}
+
+	QSharedMemory sharedMemory(sharedMemoryKey);
+
+	if(!sharedMemory.create(data.size())) {
+		SendTrace(protocol);
+		protocol << "failed Could not share the policy: " << sharedMemory.errorString().toStdString() << std::endl;
+		return 2;
+	}
+
+	sharedMemory.lock();
+	memcpy(sharedMemory.data(), data.constData(), data.size());
+	sharedMemory.unlock();
+
+	SendTrace(protocol);
+	protocol << "policy " << data.size() << std::endl;
+
+	// The shared memory goes when this process detaches, so wait until it
+	// has been copied, or the parent has gone and closed the pipe
+	std::string reply;
+	std::getline(std::cin, reply);
+
+	return 0;
+}
+
+
+QString PlanWorker::ReduceMemory(const PlannerManager::PlannerType &type, ArgumentHandlers::Arguments &args) {
+	// Sparse beliefs only help a planner that keeps joint beliefs
+	if(!args.sparse && PlannerManager::CreatePlanner(type)->GetParameters(args).GetComputeJointBeliefs()) {
+		args.sparse = true;
+		return "with sparse joint beliefs";
+	}
+
+	if(args.cache_flat_models) {
+		args.cache_flat_models = false;
+		return "without caching flat models";
+	}
+
+	return QString();
+}
+
+
+QString PlanWorker::BudgetNote() const {
+	return memoryBudget > 0 ? QString(", the memory budget was %1 MB").arg(memoryBudget) : QString();
+}
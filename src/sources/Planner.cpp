@@ -0,0 +1,32 @@
+#include "Planner.h"
+
+// MADP
+#include "PolicyPureVector.h"
+
+
+void Planner::OfferPolicy(PlanningUnitDecPOMDPDiscrete* unit, JointPolicyPureVector &jointPolicy, const double &value) {
+	if(policyOffered && value <= bestValue) {
+		return;
+	}
+
+	policyOffered = true;
+	bestValue = value;
+
+	if(!bestPolicyListener) {
+		return;
+	}
+
+	// Copied as indexes, the run after this one may replace the policy
+	std::vector<PolicyPureVector*> individualPolicies = jointPolicy.GetIndividualPolicies();
+	std::vector<std::vector<Index>> policies(unit->GetNrAgents());
+
+	for(Index agentIndex=0; agentIndex<unit->GetNrAgents(); ++agentIndex) {
+		policies[agentIndex].reserve(unit->GetNrObservationHistories(agentIndex));
+
+		for(Index ohIndex=0; ohIndex<unit->GetNrObservationHistories(agentIndex); ++ohIndex) {
+			policies[agentIndex].push_back(individualPolicies[agentIndex]->GetActionIndex(ohIndex));
+		}
+	}
+
+	bestPolicyListener(policies, value);
+}
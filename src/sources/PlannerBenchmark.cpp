@@ -0,0 +1,349 @@
+#include "PlannerBenchmark.h"
+
+// TreeVis
+#include "GeneralUtils.h"
+
+// MADP
+#include "argumentUtils.h"
+
+// Qt
+#include <QCommandLineParser>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QFile>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+
+
+PlannerBenchmark::PlannerBenchmark(const unsigned int &randomSeed) {
+	seed = randomSeed;
+}
+
+
+PlannerBenchmark::~PlannerBenchmark() {
+	//std::cout << "~PlannerBenchmark()" << std::endl;
+}
+
+
+bool PlannerBenchmark::IsRequested(int argc, char** argv) {
+	for(int i=1; i<argc; ++i) {
+		if(strcmp(argv[i], "--planner") == 0) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
+int PlannerBenchmark::RunFromCommandLine(const QStringList &arguments) {
+	QCommandLineParser parser;
+	parser.setApplicationDescription("Runs the planners over the built in problems and compares them with a baseline");
+	parser.addHelpOption();
+
+	parser.addOption(QCommandLineOption("planner", "Run the planner benchmark."));
+	parser.addOption(QCommandLineOption("problems", "Problems to plan for.", "list",
+										"aloha,dectiger,firefighting,firefightingfactored,firefightinggraph"));
+	parser.addOption(QCommandLineOption("planners", "Planners to run.", "list",
+										"bfs,gmaa-bfs,gmaa-bfsnoninc,gmaa-bnb,gmaa-am,gmaa-ce,gmaa-maxplus,gmaa-random,jesp,dice"));
+	parser.addOption(QCommandLineOption("horizons", "Horizons to plan for.", "list", "2,3"));
+	parser.addOption(QCommandLineOption("seed", "Seed set before every run.", "n", "1"));
+	parser.addOption(QCommandLineOption("json", "File to write the results to as JSON.", "file"));
+	parser.addOption(QCommandLineOption("baseline", "Results of an earlier run to compare with.", "file"));
+	parser.addOption(QCommandLineOption("time-tolerance", "Fraction the overall time may grow by.", "fraction", "0.25"));
+	parser.addOption(QCommandLineOption("min-time-ms", "Growth in milliseconds ignored as noise.", "ms", "10"));
+	parser.addOption(QCommandLineOption("value-tolerance", "Fraction the value may differ by.", "fraction", "0.000001"));
+
+	parser.process(arguments);
+
+	QStringList problems = parser.value("problems").split(',', QString::SkipEmptyParts);
+	QStringList planners = parser.value("planners").split(',', QString::SkipEmptyParts);
+	std::vector<Index> horizons;
+	ArgumentHandlers::Arguments args;
+	PlannerManager::PlannerType type;
+	bool namesKnown = !problems.isEmpty() && !planners.isEmpty();
+
+	for(const QString &problem : problems) {
+		namesKnown = namesKnown && PlannerManager::GetBuiltInProblemArguments(problem, args);
+	}
+
+	for(const QString &planner : planners) {
+		namesKnown = namesKnown && GetPlannerArguments(planner, type, args);
+	}
+
+	if(!namesKnown || !CommandLineUtils::ParseNumberList(parser.value("horizons"), horizons)) {
+		std::cerr << parser.helpText().toStdString();
+		return 1;
+	}
+
+	PlannerBenchmark benchmark(parser.value("seed").toUInt());
+	benchmark.SetTolerances(parser.value("time-tolerance").toDouble(),
+							parser.value("min-time-ms").toDouble(),
+							parser.value("value-tolerance").toDouble());
+
+	// Read the baseline first so a bad file is found before planning
+	std::map<QString, QJsonObject> baseline;
+
+	if(parser.isSet("baseline")) {
+		QFile file(parser.value("baseline"));
+
+		if(!file.open(QIODevice::ReadOnly)) {
+			std::cerr << "Could not read " << parser.value("baseline").toStdString() << std::endl;
+			return 2;
+		}
+
+		for(const QJsonValue &value : QJsonDocument::fromJson(file.readAll()).object()["results"].toArray()) {
+			QJsonObject object = value.toObject();
+			baseline[ResultKey(object["problem"].toString(), object["planner"].toString(),
+							   object["horizon"].toInt())] = object;
+		}
+	}
+
+	std::vector<Result> results = benchmark.Run(problems, planners, horizons);
+	int nrRegressions = 0;
+
+	if(parser.isSet("baseline")) {
+		std::cout << std::endl << "Compared with " << parser.value("baseline").toStdString() << std::endl;
+
+		for(Result &result : results) {
+			benchmark.CompareWithBaseline(result, baseline);
+
+			if(!result.regressions.isEmpty()) {
+				++nrRegressions;
+				std::cout << "  " << ResultKey(result.problem, result.planner, result.horizon).toStdString()
+						  << ": " << result.regressions.join("; ").toStdString() << std::endl;
+			}
+		}
+
+		std::cout << nrRegressions << " of " << results.size() << " runs regressed" << std::endl;
+	}
+
+	if(parser.isSet("json")) {
+		QJsonArray resultsArray;
+
+		for(const Result &result : results) {
+			resultsArray.append(ToJson(result));
+		}
+
+		QJsonObject root;
+		root["benchmark"] = "planner";
+		root["seed"] = (double) benchmark.seed;
+		root["results"] = resultsArray;
+
+		QFile file(parser.value("json"));
+
+		if(!file.open(QIODevice::WriteOnly | QIODevice::Truncate) ||
+		   file.write(QJsonDocument(root).toJson()) == -1) {
+			std::cerr << "Could not write " << parser.value("json").toStdString() << std::endl;
+			return 2;
+		}
+	}
+
+	return nrRegressions > 0 ? 3 : 0;
+}
+
+
+bool PlannerBenchmark::GetPlannerArguments(const QString &planner,
+										   PlannerManager::PlannerType &type,
+										   ArgumentHandlers::Arguments &args) {
+	args.nrRestarts = 1;
+	args.nrCERestarts = 1;
+
+	if(planner == "bfs") {
+		type = PlannerManager::BFS;
+		return true;
+
+	} else if(planner == "jesp") {
+		type = PlannerManager::JESP;
+		args.jesp = JESPtype::JESPDP;
+		return true;
+
+	} else if(planner == "dice") {
+		type = PlannerManager::DICEPS;
+		return true;
+
+	} else if(!planner.startsWith("gmaa-")) {
+		return false;
+	}
+
+	type = PlannerManager::GMAA;
+	QString solver = planner.mid(5);
+
+	// Exact solvers are run with MAA*, the others keep only the best solution
+	args.gmaa = GMAAtype::MAAstar;
+
+	if(solver == "bfs") {
+		args.bgsolver = BGIP_SolverType::BFS;
+	} else if(solver == "bfsnoninc") {
+		args.bgsolver = BGIP_SolverType::BFSNonInc;
+	} else if(solver == "bnb") {
+		args.bgsolver = BGIP_SolverType::BnB;
+	} else {
+		args.gmaa = GMAAtype::FSPC;
+
+		if(solver == "am") {
+			args.bgsolver = BGIP_SolverType::AM;
+		} else if(solver == "ce") {
+			args.bgsolver = BGIP_SolverType::CE;
+		} else if(solver == "maxplus") {
+			args.bgsolver = BGIP_SolverType::MaxPlus;
+		} else if(solver == "random") {
+			args.bgsolver = BGIP_SolverType::Random;
+		} else {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+void PlannerBenchmark::SetTolerances(const double &timeFraction, const double &minGrowthMs, const double &valueFraction) {
+	timeTolerance = timeFraction;
+	minTimeMs = minGrowthMs;
+	valueTolerance = valueFraction;
+}
+
+
+std::vector<PlannerBenchmark::Result> PlannerBenchmark::Run(const QStringList &problems,
+															const QStringList &planners,
+															const std::vector<Index> &horizons) {
+	std::vector<Result> results;
+
+	for(const QString &problem : problems) {
+		for(const QString &planner : planners) {
+			for(const Index &horizon : horizons) {
+				results.push_back(Measure(problem, planner, horizon));
+			}
+		}
+	}
+
+	// The planners print as they go, so the table comes at the end
+	std::cout << std::endl << std::setw(22) << "problem" << std::setw(15) << "planner" << std::setw(5) << "hor"
+			  << std::setw(14) << "value" << std::setw(13) << "unit ms" << std::setw(13) << "plan ms"
+			  << std::setw(13) << "overall ms" << std::endl;
+
+	for(const Result &result : results) {
+		std::cout << std::setw(22) << result.problem.toStdString() << std::setw(15) << result.planner.toStdString()
+				  << std::setw(5) << result.horizon;
+
+		if(!result.success) {
+			std::cout << "  failed: " << result.error.toStdString() << std::endl;
+			continue;
+		}
+
+		auto phase = [&result](const std::string &name) {
+			auto found = result.phasesMs.find(name);
+			return found != result.phasesMs.end() ? found->second : 0.0;
+		};
+
+		std::cout << std::fixed << std::setprecision(4) << std::setw(14) << result.value
+				  << std::setprecision(2) << std::setw(13) << phase("PlanningUnit")
+				  << std::setw(13) << phase("Plan") << std::setw(13) << phase("Overall") << std::endl;
+	}
+
+	return results;
+}
+
+
+PlannerBenchmark::Result PlannerBenchmark::Measure(const QString &problem, const QString &planner, const Index &horizon) {
+	Result result;
+	result.problem = problem;
+	result.planner = planner;
+	result.horizon = horizon;
+
+	ArgumentHandlers::Arguments args;
+	PlannerManager::PlannerType type;
+	PlannerManager::GetBuiltInProblemArguments(problem, args);
+	GetPlannerArguments(planner, type, args);
+	args.horizon = horizon;
+
+	// The MADP planners draw from rand()
+	srand(seed);
+
+	std::unique_ptr<Planner> plannerInstance = PlannerManager::CreatePlanner(type);
+
+	try {
+		plannerInstance->Plan(args);
+		result.value = plannerInstance->GetPlanningUnit()->GetExpectedReward();
+		result.success = true;
+
+	} catch(E &e) {
+		result.error = QString::fromStdString(e.SoftPrint());
+	} catch(std::exception &e) {
+		result.error = e.what();
+	} catch(...) {
+		result.error = "Unknown exception";
+	}
+
+	result.phasesMs = plannerInstance->GetTiming().GetTotalsMs();
+	return result;
+}
+
+
+void PlannerBenchmark::CompareWithBaseline(Result &result, const std::map<QString, QJsonObject> &baseline) const {
+	auto found = baseline.find(ResultKey(result.problem, result.planner, result.horizon));
+
+	// Nothing to compare a new run with
+	if(found == baseline.end() || !found->second["success"].toBool()) {
+		return;
+	}
+
+	const QJsonObject &base = found->second;
+
+	if(!result.success) {
+		result.regressions.append("failed: " + result.error);
+		return;
+	}
+
+	double baseValue = base["value"].toDouble();
+
+	if(std::abs(result.value - baseValue) > valueTolerance * std::max(1.0, std::abs(baseValue))) {
+		result.regressions.append(QString("value %1, was %2").arg(result.value).arg(baseValue));
+	}
+
+	double baseMs = base["phasesMs"].toObject()["Overall"].toDouble();
+	auto overall = result.phasesMs.find("Overall");
+
+	if(overall != result.phasesMs.end() &&
+	   overall->second > baseMs * (1 + timeTolerance) && overall->second - baseMs > minTimeMs) {
+		result.regressions.append(QString("overall %1 ms, was %2 ms").arg(overall->second, 0, 'f', 2).arg(baseMs, 0, 'f', 2));
+	}
+}
+
+
+QString PlannerBenchmark::ResultKey(const QString &problem, const QString &planner, const Index &horizon) {
+	return QString("%1/%2/h%3").arg(problem).arg(planner).arg(horizon);
+}
+
+
+QJsonObject PlannerBenchmark::ToJson(const Result &result) {
+	QJsonObject phases;
+
+	for(const auto &phase : result.phasesMs) {
+		phases[QString::fromStdString(phase.first)] = phase.second;
+	}
+
+	QJsonObject object;
+	object["problem"] = result.problem;
+	object["planner"] = result.planner;
+	object["horizon"] = (int) result.horizon;
+	object["success"] = result.success;
+	object["value"] = result.value;
+	object["phasesMs"] = phases;
+
+	if(!result.success) {
+		object["error"] = result.error;
+	}
+
+	if(!result.regressions.isEmpty()) {
+		object["regressions"] = QJsonArray::fromStringList(result.regressions);
+	}
+
+	return object;
+}
@@ -9,8 +9,19 @@
 // Include MADP Files
 #include "NullPlanner.h"
 
+// TreeVis
+#include "TraceRecorder.h"
+#include "PlanWorker.h"
+
 // Qt files
 #include <QMessageBox>
+#include <QtConcurrent/QtConcurrentRun>
+
+PlannerManager::PlannerManager() {
+	// Queued from the planning thread, direct when planned on this one
+	connect(this, &PlannerManager::PlanRunEnded, this, &PlannerManager::RunEnded);
+}
+
 
 PlannerManager::~PlannerManager() {
 	//std::cout << "~PlannerManager" << std::endl;
@@ -31,71 +42,266 @@ PlanningUnitDecPOMDPDiscrete* PlannerManager::GetPlanningUnit() {
 }
 
 
+const SparseModelSupport* PlannerManager::GetModelSupport() {
+	if(!modelSupport) {
+		modelSupport = std::unique_ptr<SparseModelSupport>(new SparseModelSupport(GetPlanningUnit()->GetProblem()));
+	}
+
+	return modelSupport.get();
+}
+
+
 void PlannerManager::Plan(const PlannerType &type, const ArgumentHandlers::Arguments &args) {
+	StartPlanning(args);
+	RunPlan(type, args);
+}
+
+
+void PlannerManager::PlanInBackground(const PlannerType &type, const ArgumentHandlers::Arguments &args) {
+	StartPlanning(args);
+	QtConcurrent::run(this, &PlannerManager::RunPlan, type, args);
+}
+
+
+void PlannerManager::RunPlan(const PlannerType &type, const ArgumentHandlers::Arguments &args) {
+	TraceSpan span("PlannerManager::Plan", "planner");
 	bool successfulPlan = true;
+	bool ranOutOfMemory = false;
+	QString message;
+
+	// Its own planner, the current one is still in use until RunEnded()
+	std::unique_ptr<Planner> runPlanner = CreatePlanner(type);
+
+	// Better policies are kept as they are found, so can be used before the plan ends
+	runPlanner->SetStopFlag(&stopRequested);
+	runPlanner->SetBestPolicyListener([this](const std::vector<std::vector<Index>> &policies, double value) {
+		SetBestPolicy(policies, value);
+	});
+
+	// Plan, the policies are set once back on the thread of the manager
+	try {
+		runPlanner->Plan(args);
+
+	} catch(EOutOfMemory &e) {
+		std::cout << "Planning ran out of memory: " << e.SoftPrint() << std::endl;
+		successfulPlan = false;
+		ranOutOfMemory = true;
+		message = QString::fromStdString(e.SoftPrint());
+
+	} catch(E &e) {
+		std::cout << "An exception was thrown: " << e.SoftPrint() << std::endl;
+		successfulPlan = false;
+
+		// Failed so false and give message
+		message = QString::fromStdString(e.SoftPrint());
+
+	} catch(std::bad_alloc &e) {
+		// Not every part of MADP turns running out of memory into an E
+		std::cout << "Planning ran out of memory: " << e.what() << std::endl;
+		successfulPlan = false;
+		ranOutOfMemory = true;
+		message = "Ran out of memory while planning";
+	}
+
+	// Delete the pointer to the char* we created if needed
+	if(args.problem_type == ProblemType::PARSE) {
+		delete[] args.dpf;
+	}
+
+	// Handed over, deleted there if the plan failed
+	{
+		std::lock_guard<std::mutex> lock(bestPolicyMutex);
+		endedPlanner = std::move(runPlanner);
+	}
+
+	emit PlanRunEnded(type, successfulPlan, message, ranOutOfMemory);
+}
+
+
+void PlannerManager::RunEnded(int type, bool success, QString message, bool ranOutOfMemory) {
+	std::unique_ptr<Planner> ended;
+
+	{
+		std::lock_guard<std::mutex> lock(bestPolicyMutex);
+		ended = std::move(endedPlanner);
+
+		// The run the planner ended with is not always the best
+		liveBestPolicies = bestPolicies;
+	}
+
+	outOfMemory = ranOutOfMemory;
+
+	// The plan shown before, or the best policy so far, is kept
+	if(!success) {
+		emit PlanEnded(false, message);
+		return;
+	}
+
+	// Support refers to the problem about to be replaced
+	modelSupport.reset(nullptr);
+
+	planner = std::move(ended);
+	SetPolicies(static_cast<PlannerType>(type));
+
+	useBestPolicies = !liveBestPolicies.empty();
+	livePlan = true;
+	previousPlan = false;
+
+	// Might need to construct joint actions
+	// if this is true it will be done anyway
+	if(!planArgs.cache_flat_models) {
+
+		// Try and cast to factored
+		MultiAgentDecisionProcessDiscreteFactoredStates* factored =
+				dynamic_cast<MultiAgentDecisionProcessDiscreteFactoredStates*>(GetPlanningUnit()->GetProblem());
+
+		// If the problem is factored, we need joint actions
+		if(factored) {
+			factored->ConstructJointActions();
+			factored->ConstructJointObservations();
+		}
+	}
+
+	// Plan succeeded
+	emit PlanEnded(true);
+}
+
+
+std::unique_ptr<Planner> PlannerManager::CreatePlanner(const PlannerType &type) {
+	std::unique_ptr<Planner> created;
 
 	// Switch the planner type we were given
 	switch(type) {
 
 		case JESP:
-			planner = std::unique_ptr<Planner>(new JESPPlanner());
+			created = std::unique_ptr<Planner>(new JESPPlanner());
 			break;
 
 		case BFS:
-			planner = std::unique_ptr<Planner>(new BFSPlanner());
+			created = std::unique_ptr<Planner>(new BFSPlanner());
 			break;
 
 		case GMAA:
-			planner = std::unique_ptr<Planner>(new GMAAPlanner());
+			created = std::unique_ptr<Planner>(new GMAAPlanner());
 			break;
 
 		case DICEPS:
-			planner = std::unique_ptr<Planner>(new DICEPlanner());
+			created = std::unique_ptr<Planner>(new DICEPlanner());
 			break;
 	}
 
-	// Plan, get the planning unit, and set the policices ready to be used
-	try {
-		planner->Plan(args);
+	return created;
+}
 
-	} catch(E &e) {
-		std::cout << "An exception was thrown: " << e.SoftPrint() << std::endl;
-		successfulPlan = false;
 
-		// Failed so false and give message
-		emit PlanEnded(false, QString::fromStdString(e.SoftPrint()));
+bool PlannerManager::GetBuiltInProblemArguments(const QString &problem, ArgumentHandlers::Arguments &args) {
+	args = ArgumentHandlers::Arguments();
+
+	if(problem == "aloha") {
+		args.problem_type = ProblemType::Aloha;
+	} else if(problem == "dectiger") {
+		args.problem_type = ProblemType::DT;
+	} else if(problem == "firefighting") {
+		args.problem_type = ProblemType::FF;
+	} else if(problem == "firefightingfactored") {
+		args.problem_type = ProblemType::FFF;
+	} else if(problem == "firefightinggraph") {
+		args.problem_type = ProblemType::FFG;
+	} else {
+		return false;
 	}
 
-	// Delete the pointer to the char* we created if needed
-	if(args.problem_type == ProblemType::PARSE) {
-		delete[] args.dpf;
+	return true;
+}
+
+
+bool PlannerManager::GetBestPolicy(std::vector<std::vector<Index>> &policies, double &value) {
+	std::lock_guard<std::mutex> lock(bestPolicyMutex);
+
+	if(bestPolicies.empty()) {
+		return false;
 	}
 
-	if(successfulPlan) {
-		SetPolicies(type);
-		livePlan = true;
+	policies = bestPolicies;
+	value = bestValue;
+	return true;
+}
 
-		// Might need to construct joint actions
-		// if this is true it will be done anyway
-		if(!args.cache_flat_models) {
 
-			// Try and cast to factored
-			MultiAgentDecisionProcessDiscreteFactoredStates* factored =
-					dynamic_cast<MultiAgentDecisionProcessDiscreteFactoredStates*>(GetPlanningUnit()->GetProblem());
+bool PlannerManager::UseBestPolicy(QString &message) {
+	TraceSpan span("PlannerManager::UseBestPolicy", "policy");
 
-			// If the problem is factored, we need joint actions
-			if(factored) {
-				factored->ConstructJointActions();
-				factored->ConstructJointObservations();
-			}
+	std::vector<std::vector<Index>> policies;
+	double value;
+
+	if(!GetBestPolicy(policies, value)) {
+		message = "No policy has been found yet";
+		return false;
+	}
+
+	// The planner's problem is in use on the planning thread, so it is read in again once for each plan
+	if(!planProblemLoaded) {
+		ArgumentHandlers::Arguments args = planArgs;
+
+		if(args.problem_type == ProblemType::PARSE) {
+			args.dpf = &planProblemFile[0];
 		}
 
-		// Plan succeeded
-		emit PlanEnded(true);
-	} else {
-		// Can't be used so reset
-		planner.reset(nullptr);
+		try {
+			CreateNullPlanner(args, planArgs.horizon);
+		} catch(E &e) {
+			message = QString::fromStdString(e.SoftPrint());
+			return false;
+		}
+
+		planProblemLoaded = true;
 	}
+
+	// Used as a previous plan is until the plan ends
+	previousPolicies = policies;
+	previousPlan = true;
+	livePlan = false;
+
+	return true;
+}
+
+
+void PlannerManager::StopPlanning() {
+	stopRequested = true;
+
+	if(worker) {
+		worker->Stop();
+	}
+}
+
+
+void PlannerManager::StartPlanning(const ArgumentHandlers::Arguments &args) {
+	planArgs = args;
+	planArgs.dpf = nullptr;
+	planProblemFile = args.problem_type == ProblemType::PARSE ? std::string(args.dpf) : std::string();
+	planProblemLoaded = false;
+	stopRequested = false;
+
+	std::lock_guard<std::mutex> lock(bestPolicyMutex);
+	bestPolicies.clear();
+	bestValue = 0;
+}
+
+
+void PlannerManager::SetBestPolicy(const std::vector<std::vector<Index>> &policies, const double &value) {
+	{
+		std::lock_guard<std::mutex> lock(bestPolicyMutex);
+		bestPolicies = policies;
+		bestValue = value;
+	}
+
+	std::cout << "Best policy so far, value = " << value << std::endl;
+	emit BestPolicyFound(value);
+}
+
+
+bool PlannerManager::RanOutOfMemory() const {
+	return outOfMemory;
 }
 
 
@@ -105,6 +311,10 @@ bool PlannerManager::HasPlanned() {
 
 
 void PlannerManager::PreviousPlan(std::string policyFilePath, ArgumentHandlers::Arguments args) {
+	TraceSpan span("PlannerManager::PreviousPlan", "policy");
+
+	// Support refers to the problem about to be replaced
+	modelSupport.reset(nullptr);
 
 	// If a 'live' plan has taken place
 	// we have to reset the planner as we don't reassign here
@@ -134,15 +344,65 @@ void PlannerManager::PreviousPlan(std::string policyFilePath, ArgumentHandlers::
 	// then read the number of agents
 	input >> identifier >> tmp >> numAgents;
 
+	CreateNullPlanner(args, horizon);
+
+	// Delete the pointer to the char* we created if needed
+	if(args.problem_type == ProblemType::PARSE) {
+		delete[] args.dpf;
+	}
+
+	// Create a vector the correct size, bool for error occuring
+	std::vector<Index> numObservationHistories(numAgents);
+	bool successful = (numAgents == nullPlannerUnit->GetNrAgents());
+
+	// Read in the number of observation histories for each agent
+	// from the policy file given
+	for(Index i=0; i<numAgents && successful; ++i) {
+		input >> identifier >> tmp >> numObservationHistories[i];
+
+		// Ensure at least somewhat correct
+		successful = numObservationHistories[i] == nullPlannerUnit->GetNrObservationHistories(i);
+	}
+
+	// If successful so far continue to parse
+	if(successful) {
+		successful = ReadPolicyIndexes(input, numObservationHistories, previousPolicies);
+	}
+
+	// Simple error handling
+	if(!successful) {
+		emit PreviousPlanEnded(false, "Something went wrong trying to load the policy. "
+									  "Possible bad policy file, are you sure problem & horizon "
+									  "were correct and file is in the correct format?");
+	} else {
+		emit PreviousPlanEnded(true);
+	}
+
+	previousPlan = true;
+	livePlan = false;
+}
+
+
+void PlannerManager::CreateNullPlanner(const ArgumentHandlers::Arguments &args, const Index &horizon) {
+
+	// Support refers to the problem about to be replaced
+	modelSupport.reset(nullptr);
+
 	// Get the decpomdp from the given args
-	decpomdp = std::unique_ptr<DecPOMDPDiscreteInterface>(
-				ArgumentUtils::GetDecPOMDPDiscreteInterfaceFromArgs(args));
+	{
+		TraceSpan problemSpan("Problem", "policy");
+		decpomdp = std::unique_ptr<DecPOMDPDiscreteInterface>(
+					ArgumentUtils::GetDecPOMDPDiscreteInterfaceFromArgs(args));
+	}
 
 	// Don't compute anything
 	PlanningUnitMADPDiscreteParameters params;
 	params.SetComputeAll(false);
 
-	nullPlannerUnit = std::unique_ptr<NullPlanner>(new NullPlanner(horizon, decpomdp.get(), &params));
+	{
+		TraceSpan planningUnitSpan("PlanningUnit", "policy");
+		nullPlannerUnit = std::unique_ptr<NullPlanner>(new NullPlanner(horizon, decpomdp.get(), &params));
+	}
 
 	// Try and cast to factored
 	MultiAgentDecisionProcessDiscreteFactoredStates* factored =
@@ -153,71 +413,132 @@ void PlannerManager::PreviousPlan(std::string policyFilePath, ArgumentHandlers::
 		factored->ConstructJointActions();
 		factored->ConstructJointObservations();
 	}
+}
 
-	// Delete the pointer to the char* we created if needed
-	if(args.problem_type == ProblemType::PARSE) {
-		delete[] args.dpf;
-	}
 
-	// Create a vector the correct size, bool for error occuring
-	std::vector<Index> numObservationHistories(numAgents);
-	bool successful = (numAgents == nullPlannerUnit->GetNrAgents());
+void PlannerManager::PlanInWorker(const PlannerType &type,
+								  const ArgumentHandlers::Arguments &args,
+								  const int &memoryBudgetMB) {
 
-	// Read in the number of observation histories for each agent
-	// from the policy file given
-	for(Index i=0; i<numAgents && successful; ++i) {
-		input >> identifier >> tmp >> numObservationHistories[i];
+	// Support refers to the problem about to be replaced
+	modelSupport.reset(nullptr);
 
-		// Ensure at least somewhat correct
-		successful = numObservationHistories[i] == nullPlannerUnit->GetNrObservationHistories(i);
+	// Only the latest plan is wanted
+	if(worker) {
+		delete worker;
 	}
 
-	// If successful so far continue to parse
-	if(successful) {
+	worker = new PlanWorker(this);
+	connect(worker, &PlanWorker::Progress, this, &PlannerManager::PlanProgress);
+	connect(worker, &PlanWorker::BestPolicy, this, &PlannerManager::WorkerBestPolicy);
+	connect(worker, &PlanWorker::Finished, this, &PlannerManager::WorkerFinished);
 
-		// Clear previous policices if given, reserve as best performing
-		//previousPolicies.clear();
-		previousPolicies = std::vector<std::vector<Index>>(numAgents);
+	worker->Start(type, args, memoryBudgetMB);
 
-		// To read into
-		Index actionIndex;
+	// Kept to read in the problem again for the best policy and once planned
+	StartPlanning(args);
 
-		// Get the number for each agent index
-		for(Index agentIndex=0; agentIndex<numAgents && successful; ++agentIndex) {
+	// The child process has copied the path, delete the char* we created as Plan() does
+	if(args.problem_type == ProblemType::PARSE) {
+		delete[] args.dpf;
+	}
+}
 
-			previousPolicies[agentIndex] = std::vector<Index>();
-			previousPolicies[agentIndex].reserve(numObservationHistories[agentIndex]);
 
-			Index policyIndex = 0;
+void PlannerManager::WorkerFinished(bool success, QString message) {
+	TraceSpan span("PlannerManager::WorkerFinished", "planner");
 
-			// Read in indexes
-			do {
+	// Deleted once it has finished emitting
+	PlanWorker* finishedWorker = worker;
+	worker = nullptr;
+	finishedWorker->deleteLater();
 
-				// Try read
-				if(input >> actionIndex) {
-					// Set if possible
-					previousPolicies[agentIndex].push_back(actionIndex);
+	if(!success) {
+		emit PlanEnded(false, message);
+		return;
+	}
 
-				} else {
-					// Otherwise the policy is incorrect so an error has occurred
-					successful = false;
-				}
+	// Nothing planned here, the policy is used as a previous plan is
+	if(livePlan) {
+		planner.reset(nullptr);
+	}
+
+	livePlan = false;
+	previousPlan = false;
+
+	ArgumentHandlers::Arguments args = planArgs;
+
+	if(args.problem_type == ProblemType::PARSE) {
+		args.dpf = &planProblemFile[0];
+	}
 
-			} while(++policyIndex < numObservationHistories[agentIndex] && successful);
+	// Already read in if a best policy was used while planning
+	if(!planProblemLoaded) {
+		try {
+			CreateNullPlanner(args, finishedWorker->GetHorizon());
+		} catch(E &e) {
+			emit PlanEnded(false, QString::fromStdString(e.SoftPrint()));
+			return;
 		}
+
+		planProblemLoaded = true;
+	}
+
+	const std::vector<std::vector<Index>> &policies = finishedWorker->GetPolicies();
+	bool successful = (policies.size() == nullPlannerUnit->GetNrAgents());
+
+	for(Index i=0; i<policies.size() && successful; ++i) {
+		successful = policies[i].size() == nullPlannerUnit->GetNrObservationHistories(i);
 	}
 
-	// Simple error handling
 	if(!successful) {
-		emit PreviousPlanEnded(false, "Something went wrong trying to load the policy. "
-									  "Possible bad policy file, are you sure problem & horizon "
-									  "were correct and file is in the correct format?");
-	} else {
-		emit PreviousPlanEnded(true);
+		emit PlanEnded(false, "The policy from the planning process does not fit the problem");
+		return;
 	}
 
+	std::cout << "Value = " << finishedWorker->GetExpectedReward() << std::endl;
+
+	previousPolicies = policies;
 	previousPlan = true;
-	livePlan = false;
+	emit PlanEnded(true);
+}
+
+
+void PlannerManager::WorkerBestPolicy(double value) {
+	if(worker) {
+		SetBestPolicy(worker->GetBestPolicies(), value);
+	}
+}
+
+
+bool PlannerManager::ReadPolicyIndexes(std::istream &input,
+									   const std::vector<Index> &numObservationHistories,
+									   std::vector<std::vector<Index>> &policies) {
+	TraceSpan span("PlannerManager::ReadPolicyIndexes", "policy");
+
+	// Clear previous policices if given, reserve as best performing
+	policies = std::vector<std::vector<Index>>(numObservationHistories.size());
+
+	// To read into
+	Index actionIndex;
+
+	// Get the number for each agent index
+	for(Index agentIndex=0; agentIndex<numObservationHistories.size(); ++agentIndex) {
+		policies[agentIndex].reserve(numObservationHistories[agentIndex]);
+
+		// Read in indexes
+		for(Index policyIndex=0; policyIndex<numObservationHistories[agentIndex]; ++policyIndex) {
+
+			// The policy is incorrect if an index can't be read
+			if(!(input >> actionIndex)) {
+				return false;
+			}
+
+			policies[agentIndex].push_back(actionIndex);
+		}
+	}
+
+	return true;
 }
 
 
@@ -244,30 +565,42 @@ void PlannerManager::SetPolicies(const PlannerType &type) {
 
 Index PlannerManager::GetJointActionIndex(Index johIndex) {
 	// If live plan use the policy
-	if(livePlan) {
+	if(livePlan && useBestPolicies) {
+		return GetJointActionIndex(planner->GetPlanningUnit(), liveBestPolicies, johIndex);
+
+	} else if(livePlan) {
 		return jointPolicy->GetJointActionIndex(johIndex);
 
 	} else {
 		// Otherwise compute JA based on individual policies
-		std::vector<Index> individualObservationHistoryIndexes =
-				nullPlannerUnit->JointToIndividualObservationHistoryIndices(johIndex);
+		return GetJointActionIndex(nullPlannerUnit.get(), previousPolicies, johIndex);
+	}
+}
 
-		std::vector<Index> individualActions(nullPlannerUnit->GetNrAgents());
 
-		// Get individual actions for each IOH
-		for(Index i=0; i<nullPlannerUnit->GetNrAgents(); ++i) {
-			individualActions[i] = previousPolicies[i][individualObservationHistoryIndexes[i]];
-		}
+Index PlannerManager::GetJointActionIndex(PlanningUnitDecPOMDPDiscrete* unit,
+										  const std::vector<std::vector<Index>> &policies,
+										  Index johIndex) {
+	std::vector<Index> individualObservationHistoryIndexes =
+			unit->JointToIndividualObservationHistoryIndices(johIndex);
+
+	std::vector<Index> individualActions(unit->GetNrAgents());
 
-		// Return the JA from the individual ones
-		return nullPlannerUnit->IndividualToJointActionIndices(individualActions);
+	// Get individual actions for each IOH
+	for(Index i=0; i<unit->GetNrAgents(); ++i) {
+		individualActions[i] = policies[i][individualObservationHistoryIndexes[i]];
 	}
+
+	// Return the JA from the individual ones
+	return unit->IndividualToJointActionIndices(individualActions);
 }
 
 
 Index PlannerManager::GetActionIndex(Index agentIndex, Index ohIndex) {
 	// If live plan use the policy
-	if(livePlan) {
+	if(livePlan && useBestPolicies) {
+		return liveBestPolicies[agentIndex][ohIndex];
+	} else if(livePlan) {
 		return individualPolicies[agentIndex]->GetActionIndex(ohIndex);
 	} else {
 
@@ -275,3 +608,27 @@ Index PlannerManager::GetActionIndex(Index agentIndex, Index ohIndex) {
 		return previousPolicies[agentIndex][ohIndex];
 	}
 }
+
+
+AgentPolicy PlannerManager::GetAgentPolicy(Index agentIndex) {
+	PlanningUnitDecPOMDPDiscrete* pUnit = GetPlanningUnit();
+
+	AgentPolicy policy;
+	policy.agentIndex = agentIndex;
+	policy.horizon = pUnit->GetHorizon();
+
+	// Names are copied so the planning unit is not needed to draw
+	for(Index i=0; i<pUnit->GetNrActions(agentIndex); ++i) {
+		policy.actionNames.push_back(QString::fromStdString(pUnit->GetAction(agentIndex, i)->GetName()));
+	}
+
+	for(Index i=0; i<pUnit->GetNrObservations(agentIndex); ++i) {
+		policy.observationNames.push_back(QString::fromStdString(pUnit->GetObservation(agentIndex, i)->GetName()));
+	}
+
+	policy.GetActionIndex = [this, agentIndex](Index ohIndex) {
+		return GetActionIndex(agentIndex, ohIndex);
+	};
+
+	return policy;
+}
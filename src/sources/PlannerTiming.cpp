@@ -0,0 +1,39 @@
+#include "PlannerTiming.h"
+
+// TreeVis
+#include "TraceRecorder.h"
+
+
+PlannerTiming::~PlannerTiming() {
+	//std::cout << "~PlannerTiming()" << std::endl;
+}
+
+
+void PlannerTiming::Start(const std::string &id) {
+	Timing::Start(id);
+	startsUs[id] = TraceRecorder::NowUs();
+}
+
+
+void PlannerTiming::Stop(const std::string &id) {
+	Timing::Stop(id);
+
+	// Ignore phases that were never started
+	auto start = startsUs.find(id);
+
+	if(start != startsUs.end()) {
+		qint64 durationUs = TraceRecorder::NowUs() - start->second;
+		totalsMs[id] += durationUs / 1e3;
+
+		if(TraceRecorder::IsEnabled()) {
+			TraceRecorder::Record(TraceRecorder::Intern(id), "planner", start->second, durationUs);
+		}
+
+		startsUs.erase(start);
+	}
+}
+
+
+const std::map<std::string, double>& PlannerTiming::GetTotalsMs() const {
+	return totalsMs;
+}
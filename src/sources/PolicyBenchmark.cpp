@@ -0,0 +1,351 @@
+#include "PolicyBenchmark.h"
+
+// TreeVis
+#include "SyntheticGenerator.h"
+#include "GeneralUtils.h"
+
+// MADP
+#include "argumentUtils.h"
+
+// Qt
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QTemporaryDir>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QFile>
+#include <QFileInfo>
+
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+
+
+PolicyBenchmark::PolicyBenchmark(const int &lookupCount, const unsigned int &randomSeed) {
+	lookups = lookupCount;
+	seed = randomSeed;
+}
+
+
+PolicyBenchmark::~PolicyBenchmark() {
+	//std::cout << "~PolicyBenchmark()" << std::endl;
+}
+
+
+bool PolicyBenchmark::IsRequested(int argc, char** argv) {
+	for(int i=1; i<argc; ++i) {
+		if(strcmp(argv[i], "--policy") == 0) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
+int PolicyBenchmark::RunFromCommandLine(const QStringList &arguments) {
+	QCommandLineParser parser;
+	parser.setApplicationDescription("Measures reading in policies and looking up their actions");
+	parser.addHelpOption();
+
+	parser.addOption(QCommandLineOption("policy", "Run the policy benchmark."));
+	parser.addOption(QCommandLineOption("problems", "Built in problems to measure.", "list", "dectiger,firefighting"));
+	parser.addOption(QCommandLineOption("horizons", "Horizons of the generated policy files.", "list", "4,8,12,14"));
+	parser.addOption(QCommandLineOption("live-horizons", "Horizons planned live with JESP.", "list", "2,3,4"));
+	parser.addOption(QCommandLineOption("lookups", "Lookups timed for each policy.", "n", "1000000"));
+	parser.addOption(QCommandLineOption("seed", "Seed for the generated policies and lookups.", "n", "1"));
+	parser.addOption(QCommandLineOption("json", "File to write the results to as JSON.", "file"));
+
+	parser.process(arguments);
+
+	QStringList problems = parser.value("problems").split(',', QString::SkipEmptyParts);
+	std::vector<Index> horizons;
+	std::vector<Index> liveHorizons;
+	int lookupCount = parser.value("lookups").toInt();
+	ArgumentHandlers::Arguments args;
+	bool problemsKnown = !problems.isEmpty();
+
+	for(const QString &problem : problems) {
+		problemsKnown = problemsKnown && PlannerManager::GetBuiltInProblemArguments(problem, args);
+	}
+
+	if(!problemsKnown ||
+	   !CommandLineUtils::ParseNumberList(parser.value("horizons"), horizons) ||
+	   !CommandLineUtils::ParseNumberList(parser.value("live-horizons"), liveHorizons) || lookupCount < 1) {
+		std::cerr << parser.helpText().toStdString();
+		return 1;
+	}
+
+	PolicyBenchmark benchmark(lookupCount, parser.value("seed").toUInt());
+	std::vector<Result> results = benchmark.Run(problems, horizons, liveHorizons);
+
+	if(parser.isSet("json")) {
+		QJsonArray resultsArray;
+
+		for(const Result &result : results) {
+			resultsArray.append(ToJson(result));
+		}
+
+		QJsonObject root;
+		root["benchmark"] = "policy";
+		root["lookups"] = lookupCount;
+		root["seed"] = (double) benchmark.seed;
+		root["results"] = resultsArray;
+
+		QFile file(parser.value("json"));
+
+		if(!file.open(QIODevice::WriteOnly | QIODevice::Truncate) ||
+		   file.write(QJsonDocument(root).toJson()) == -1) {
+			std::cerr << "Could not write " << parser.value("json").toStdString() << std::endl;
+			return 2;
+		}
+	}
+
+	return 0;
+}
+
+
+std::vector<PolicyBenchmark::Result> PolicyBenchmark::Run(const QStringList &problems,
+														  const std::vector<Index> &horizons,
+														  const std::vector<Index> &liveHorizons) {
+	std::vector<Result> results;
+
+	std::cout << std::setw(14) << "problem" << std::setw(6) << "kind" << std::setw(5) << "hor"
+			  << std::setw(10) << "OHs" << std::setw(14) << "JOHs" << std::setw(12) << "file KB"
+			  << std::setw(11) << "load ms" << std::setw(11) << "parse ms" << std::setw(10) << "MB/s"
+			  << std::setw(11) << "action ns" << std::setw(10) << "joint ns" << std::endl;
+
+	auto print = [](const Result &result) {
+		std::cout << std::fixed << std::setprecision(2)
+				  << std::setw(14) << result.problem.toStdString()
+				  << std::setw(6) << (result.live ? "live" : "file") << std::setw(5) << result.horizon
+				  << std::setw(10) << result.nrObservationHistories
+				  << std::setw(14) << std::setprecision(0) << result.nrJointObservationHistories
+				  << std::setw(12) << std::setprecision(2) << result.fileBytes / 1024.0
+				  << std::setw(11) << result.loadMs << std::setw(11) << result.parseMs
+				  << std::setw(10) << result.parseMBPerSecond
+				  << std::setw(11) << result.actionLookupNs << std::setw(10) << result.jointActionLookupNs
+				  << std::endl;
+	};
+
+	for(const QString &problem : problems) {
+		for(const Index &horizon : horizons) {
+			Result result;
+
+			if(MeasurePreviousPlan(problem, horizon, result)) {
+				results.push_back(result);
+				print(result);
+			} else {
+				std::cout << std::setw(14) << problem.toStdString() << std::setw(6) << "file"
+						  << std::setw(5) << horizon << "  failed" << std::endl;
+			}
+		}
+
+		for(const Index &horizon : liveHorizons) {
+			Result result;
+
+			if(MeasureLivePlan(problem, horizon, result)) {
+				results.push_back(result);
+				print(result);
+			} else {
+				std::cout << std::setw(14) << problem.toStdString() << std::setw(6) << "live"
+						  << std::setw(5) << horizon << "  failed" << std::endl;
+			}
+		}
+	}
+
+	return results;
+}
+
+
+bool PolicyBenchmark::MeasurePreviousPlan(const QString &problem, const Index &horizon, Result &result) {
+	result.problem = problem;
+	result.live = false;
+	result.horizon = horizon;
+
+	ArgumentHandlers::Arguments args;
+	PlannerManager::GetBuiltInProblemArguments(problem, args);
+	args.horizon = horizon;
+
+	// The counts the file has to match, from the problem itself
+	std::vector<Index> nrObservations;
+	std::vector<Index> numObservationHistories;
+	std::vector<Index> numActions;
+
+	try {
+		std::unique_ptr<DecPOMDPDiscreteInterface> decpomdp(
+					ArgumentUtils::GetDecPOMDPDiscreteInterfaceFromArgs(args));
+
+		for(Index i=0; i<decpomdp->GetNrAgents(); ++i) {
+			nrObservations.push_back(decpomdp->GetNrObservations(i));
+			numActions.push_back(decpomdp->GetNrActions(i));
+		}
+	} catch(E &e) {
+		std::cout << "An exception was thrown: " << e.SoftPrint() << std::endl;
+		return false;
+	}
+
+	// Too many to hold in memory or to index
+	if(!SyntheticGenerator::CountObservationHistories(nrObservations, horizon, numObservationHistories)) {
+		return false;
+	}
+
+	QTemporaryDir dir;
+	QString filePath = dir.path() + "/policy.txt";
+	SyntheticGenerator generator(seed + horizon);
+	qint64 headerBytes = generator.WritePolicyFile(filePath, horizon, numObservationHistories, numActions);
+
+	if(!dir.isValid() || headerBytes < 0) {
+		return false;
+	}
+
+	result.fileBytes = QFileInfo(filePath).size();
+
+	// Everything the application does to read in a policy
+	PlannerManager manager;
+	bool loaded = false;
+
+	QObject::connect(&manager, &PlannerManager::PreviousPlanEnded, [&loaded](bool success, QString) {
+		loaded = success;
+	});
+
+	QElapsedTimer timer;
+	timer.start();
+
+	try {
+		manager.PreviousPlan(filePath.toStdString(), args);
+	} catch(E &e) {
+		std::cout << "An exception was thrown: " << e.SoftPrint() << std::endl;
+		return false;
+	}
+
+	result.loadMs = timer.nsecsElapsed() / 1e6;
+
+	if(!loaded) {
+		return false;
+	}
+
+	// Just the action indexes, without creating the problem
+	std::ifstream input(filePath.toStdString());
+	input.seekg(headerBytes);
+	std::vector<std::vector<Index>> policies;
+
+	timer.start();
+	bool parsed = PlannerManager::ReadPolicyIndexes(input, numObservationHistories, policies);
+	qint64 parseNs = timer.nsecsElapsed();
+
+	if(!parsed) {
+		return false;
+	}
+
+	result.parseMs = parseNs / 1e6;
+	result.parseMBPerSecond = parseNs > 0 ?
+				((result.fileBytes - headerBytes) / (1024.0*1024.0)) / (parseNs / 1e9) : 0;
+
+	MeasureLookups(manager, result);
+	return true;
+}
+
+
+bool PolicyBenchmark::MeasureLivePlan(const QString &problem, const Index &horizon, Result &result) {
+	result.problem = problem;
+	result.live = true;
+	result.horizon = horizon;
+
+	ArgumentHandlers::Arguments args;
+	PlannerManager::GetBuiltInProblemArguments(problem, args);
+	args.horizon = horizon;
+	args.jesp = JESPtype::JESPDP;
+	args.nrRestarts = 1;
+
+	PlannerManager manager;
+	bool planned = false;
+
+	QObject::connect(&manager, &PlannerManager::PlanEnded, [&planned](bool success, QString) {
+		planned = success;
+	});
+
+	QElapsedTimer timer;
+	timer.start();
+	manager.Plan(PlannerManager::JESP, args);
+	result.loadMs = timer.nsecsElapsed() / 1e6;
+
+	if(!planned) {
+		return false;
+	}
+
+	MeasureLookups(manager, result);
+	return true;
+}
+
+
+void PolicyBenchmark::MeasureLookups(PlannerManager &manager, Result &result) {
+	PlanningUnitDecPOMDPDiscrete* pUnit = manager.GetPlanningUnit();
+	Index nrAgents = pUnit->GetNrAgents();
+
+	// Joint histories are the product of the individual ones
+	result.nrObservationHistories = pUnit->GetNrObservationHistories(0);
+	result.nrJointObservationHistories = 1;
+
+	for(Index i=0; i<nrAgents; ++i) {
+		result.nrJointObservationHistories *= pUnit->GetNrObservationHistories(i);
+	}
+
+	// Indexes chosen before timing so only the lookups are measured
+	std::mt19937 generator(seed);
+	std::vector<Index> agents(lookups);
+	std::vector<Index> histories(lookups);
+
+	for(int i=0; i<lookups; ++i) {
+		agents[i] = generator() % nrAgents;
+		histories[i] = generator() % pUnit->GetNrObservationHistories(agents[i]);
+	}
+
+	QElapsedTimer timer;
+	Index checksum = 0;
+
+	timer.start();
+
+	for(int i=0; i<lookups; ++i) {
+		checksum += manager.GetActionIndex(agents[i], histories[i]);
+	}
+
+	result.actionLookupNs = (double) timer.nsecsElapsed() / lookups;
+
+	// Joint indexes past the largest Index can't be looked up
+	if(result.nrJointObservationHistories <= std::numeric_limits<Index>::max()) {
+		for(int i=0; i<lookups; ++i) {
+			histories[i] = generator() % (Index) result.nrJointObservationHistories;
+		}
+
+		timer.start();
+
+		for(int i=0; i<lookups; ++i) {
+			checksum += manager.GetJointActionIndex(histories[i]);
+		}
+
+		result.jointActionLookupNs = (double) timer.nsecsElapsed() / lookups;
+	}
+
+	lookupChecksum = checksum;
+}
+
+
+QJsonObject PolicyBenchmark::ToJson(const Result &result) {
+	QJsonObject object;
+	object["problem"] = result.problem;
+	object["live"] = result.live;
+	object["horizon"] = (int) result.horizon;
+	object["nrObservationHistories"] = (double) result.nrObservationHistories;
+	object["nrJointObservationHistories"] = result.nrJointObservationHistories;
+	object["fileBytes"] = (double) result.fileBytes;
+	object["loadMs"] = result.loadMs;
+	object["parseMs"] = result.parseMs;
+	object["parseMBPerSecond"] = result.parseMBPerSecond;
+	object["actionLookupNs"] = result.actionLookupNs;
+	object["jointActionLookupNs"] = result.jointActionLookupNs;
+	return object;
+}
@@ -0,0 +1,181 @@
+#include "PolicyGraph.h"
+
+// TreeVis
+#include "TreeLayout.h"
+#include "Node.h"
+#include "Edge.h"
+
+// Qt
+#include <QFontMetricsF>
+#include <QStringList>
+
+#include <map>
+#include <algorithm>
+
+
+PolicyGraph::PolicyGraph(const AgentPolicy &agentPolicy) {
+	policy = agentPolicy;
+	levels = std::vector<std::vector<GraphNode>>(policy.horizon);
+
+	// Only the index arithmetic of the layout is needed
+	TreeLayout layout(policy.GetNrObservations(), policy.horizon, 0, 0);
+	size_t nrObservations = policy.GetNrObservations();
+
+	// Graph node of each tree node on the level below the current one
+	std::vector<Index> idsBelow;
+
+	for(int depth=(int) policy.horizon-1; depth>=0; --depth) {
+		Index firstOHIndex = layout.GetFirstOHIndexAtDepth(depth);
+		Index nrNodes = layout.GetNrNodesAtDepth(depth);
+		bool lastLevel = (depth == (int) policy.horizon-1);
+
+		// Key is the action followed by the graph node of each child
+		std::map<std::vector<Index>, Index> uniqueSubtrees;
+		std::vector<Index> ids(nrNodes);
+
+		for(Index position=0; position<nrNodes; ++position) {
+			std::vector<Index> key;
+			key.reserve(nrObservations+1);
+			key.push_back(policy.GetActionIndex(firstOHIndex + position));
+
+			// Children of the node are next to each other on the level below
+			if(!lastLevel) {
+				for(Index obvsIndex=0; obvsIndex<nrObservations; ++obvsIndex) {
+					key.push_back(idsBelow[(position*nrObservations) + obvsIndex]);
+				}
+			}
+
+			std::map<std::vector<Index>, Index>::iterator it = uniqueSubtrees.find(key);
+
+			// First time the subtree has been seen, create a new graph node
+			if(it == uniqueSubtrees.end()) {
+				GraphNode node;
+				node.actionIndex = key[0];
+				node.representativeOHIndex = firstOHIndex + position;
+				node.children = std::vector<Index>(key.begin()+1, key.end());
+
+				it = uniqueSubtrees.insert(std::make_pair(key, levels[depth].size())).first;
+				levels[depth].push_back(node);
+			}
+
+			ids[position] = it->second;
+		}
+
+		idsBelow.swap(ids);
+	}
+}
+
+
+PolicyGraph::~PolicyGraph() {
+	//std::cout << "~PolicyGraph()" << std::endl;
+}
+
+
+size_t PolicyGraph::GetNrNodes() const {
+	size_t total = 0;
+
+	for(const std::vector<GraphNode> &level : levels) {
+		total += level.size();
+	}
+
+	return total;
+}
+
+
+void PolicyGraph::AddToScene(TreeVisGraphicsScene* scene, const qreal &nodePadding) const {
+	if(levels.empty()) {
+		return;
+	}
+
+	// Order each level by when it is reached from the level above,
+	// keeping children close to their parents and reducing crossings
+	std::vector<std::vector<Index>> displayOrder(levels.size());
+	displayOrder[0].push_back(0);
+
+	for(Index depth=0; depth+1<levels.size(); ++depth) {
+		std::vector<bool> added(levels[depth+1].size(), false);
+
+		for(Index id : displayOrder[depth]) {
+			for(Index child : levels[depth][id].children) {
+				if(!added[child]) {
+					added[child] = true;
+					displayOrder[depth+1].push_back(child);
+				}
+			}
+		}
+	}
+
+	// Merge observations leading to the same child into a single labelled edge
+	std::vector<std::vector<std::vector<std::pair<Index, QString>>>> edgeLabels(levels.size());
+	qreal longestLabel = 0;
+	QFontMetricsF fontMetrics = QFontMetricsF(Edge::GetFont());
+
+	for(Index depth=0; depth<levels.size(); ++depth) {
+		edgeLabels[depth] = std::vector<std::vector<std::pair<Index, QString>>>(levels[depth].size());
+
+		for(Index id=0; id<levels[depth].size(); ++id) {
+			const std::vector<Index> &children = levels[depth][id].children;
+			std::vector<std::pair<Index, QString>> &labels = edgeLabels[depth][id];
+
+			for(Index obvsIndex=0; obvsIndex<children.size(); ++obvsIndex) {
+				std::vector<std::pair<Index, QString>>::iterator it =
+						std::find_if(labels.begin(), labels.end(),
+									 [&](const std::pair<Index, QString> &label) {
+										return label.first == children[obvsIndex];
+									 });
+
+				if(it == labels.end()) {
+					labels.push_back(std::make_pair(children[obvsIndex], policy.observationNames[obvsIndex]));
+				} else {
+					it->second += ", " + policy.observationNames[obvsIndex];
+				}
+			}
+
+			for(const std::pair<Index, QString> &label : labels) {
+				longestLabel = std::max(longestLabel, fontMetrics.boundingRect(label.second).width());
+			}
+		}
+	}
+
+	// Size of a slot on a level from the widest action
+	qreal slotWidth = 0;
+	qreal nodeHeight = 0;
+
+	for(const QString &actionName : policy.actionNames) {
+		QSizeF size = Node::GetSizeForText(actionName);
+		slotWidth = std::max(slotWidth, size.width());
+		nodeHeight = std::max(nodeHeight, size.height());
+	}
+
+	slotWidth += nodePadding;
+	qreal levelSeparation = std::max((qreal) 100, longestLabel + nodeHeight + 10);
+
+	// Create the nodes centred on x = 0
+	std::vector<std::vector<Node*>> nodes(levels.size());
+
+	for(Index depth=0; depth<levels.size(); ++depth) {
+		nodes[depth] = std::vector<Node*>(levels[depth].size());
+		qreal levelWidth = displayOrder[depth].size() * slotWidth;
+
+		for(Index i=0; i<displayOrder[depth].size(); ++i) {
+			const GraphNode &graphNode = levels[depth][displayOrder[depth][i]];
+
+			Node* node = new Node(policy.actionNames[graphNode.actionIndex],
+								  graphNode.representativeOHIndex,
+								  policy.agentIndex);
+
+			node->setPos((i + 0.5)*slotWidth - levelWidth/2, depth*levelSeparation);
+			scene->AddNode(node, depth);
+			nodes[depth][displayOrder[depth][i]] = node;
+		}
+	}
+
+	// Edges once all nodes are positioned
+	for(Index depth=0; depth+1<levels.size(); ++depth) {
+		for(Index id=0; id<levels[depth].size(); ++id) {
+			for(const std::pair<Index, QString> &label : edgeLabels[depth][id]) {
+				scene->AddEdge(new Edge(nodes[depth][id], nodes[depth+1][label.first], label.second));
+			}
+		}
+	}
+}
@@ -1,8 +1,10 @@
 #include "PolicyVisualiserView.h"
 
 // TreeVis files
-#include "NumSortTreeWidgetItem.h"
+#include "JointObservationModel.h"
 #include "JointObservationSelectionDialog.h"
+#include "TreeVisGraphicsScene.h"
+#include "TraceRecorder.h"
 
 
 PolicyVisualiserView::PolicyVisualiserView(PlannerManager* man, QWidget* parent) : QWidget(parent) {
@@ -166,6 +168,36 @@ void PolicyVisualiserView::SetupUI(QWidget* parent) {
 	parentVerticalLayout->addWidget(initialStateOptionsGroupBox);
 	parentVerticalLayout->addWidget(visualisationEndWidget);
 
+	// Belief tracking, off until checked as it is only needed on request
+	beliefGroupBox = new QGroupBox("Track Belief over States", controlInterfaceParent);
+	beliefGroupBox->setCheckable(true);
+	beliefGroupBox->setChecked(false);
+	QGridLayout* beliefLayout = new QGridLayout(beliefGroupBox);
+
+	beliefLayout->addWidget(new QLabel("Top States:", beliefGroupBox), 0, 0);
+	beliefTopStatesSpinBox = new QSpinBox(beliefGroupBox);
+	beliefTopStatesSpinBox->setRange(1, 100);
+	beliefTopStatesSpinBox->setValue(10);
+	beliefLayout->addWidget(beliefTopStatesSpinBox, 0, 1);
+
+	beliefLayout->addWidget(new QLabel("States in Belief:", beliefGroupBox), 1, 0);
+	beliefSupportLabel = new QLabel("----", beliefGroupBox);
+	beliefLayout->addWidget(beliefSupportLabel, 1, 1);
+
+	beliefTreeWidget = new QTreeWidget(beliefGroupBox);
+	beliefTreeWidget->setHeaderLabels(QStringList() << "State" << "Probability");
+	beliefTreeWidget->setRootIsDecorated(false);
+	beliefTreeWidget->setUniformRowHeights(true);
+	beliefLayout->addWidget(beliefTreeWidget, 2, 0, 1, 2);
+
+	connect(beliefGroupBox, &QGroupBox::toggled, this, &PolicyVisualiserView::BeliefTrackingToggled);
+	connect(beliefTopStatesSpinBox, static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged),
+			this, &PolicyVisualiserView::UpdateBeliefView);
+
+	beliefGroupBox->setSizePolicy(full);
+	beliefGroupBox->hide();
+	parentVerticalLayout->addWidget(beliefGroupBox);
+
 	// Restart button
 	restartVisualisationButton = new QPushButton("Restart Visualisation", visualisationControlWidget);
 	parentVerticalLayout->addWidget(restartVisualisationButton);
@@ -179,7 +211,7 @@ void PolicyVisualiserView::SetupUI(QWidget* parent) {
 	parentVerticalLayout->addWidget(waitingForPlanLabel);
 
 	// Initally null as we need to wait for an end of a plan
-	endProbabilityTreeWidget = nullptr;
+	endProbabilityTreeView = nullptr;
 
 	// Add the control parent widget to the splitter
 	splitter->addWidget(controlInterfaceParent);
@@ -196,128 +228,86 @@ void PolicyVisualiserView::SetupUI(QWidget* parent) {
 
 
 void PolicyVisualiserView::ChangeEdgeColourProbability(bool checked) {
+	TreeVisGraphicsScene* scene = qobject_cast<TreeVisGraphicsScene*>(graphicsView->scene());
 
-	// Get all items in the scene
-	QList<QGraphicsItem*> items = graphicsView->scene()->items();
-
-	for(QGraphicsItem* item : items) {
-		Edge* edge = qgraphicsitem_cast<Edge*>(item);
-
-		// If we got an edge
-		if(edge) {
+	// Only the edges, not every item in the scene
+	if(scene) {
+		for(Edge* edge : scene->GetEdges()) {
 			edge->ChangeColourToMatchProbability(!checked);
 		}
 	}
 }
 
 
-double PolicyVisualiserView::GetIndidividualObservationProbability(
-											const Index &agentIndex,
-											const Index &observationIndex,
-											const Index &jointActionIndex,
-											const Index &stateIndex,
-											const Index &succStateIndex) {
-	double toReturn = 0.0;
-
-	// Get num observations vector
-	std::vector<size_t> numObservations =
-			pManager->GetPlanningUnit()->GetNrObservations();
-
-	// Get possible combinations
-	std::vector<std::vector<Index>> combinations = GetCombinations(numObservations, agentIndex, observationIndex);
+void PolicyVisualiserView::BeliefTrackingToggled(bool checked) {
+	// Contents are hidden by the group box when unchecked
+	if(!checked || !beliefTracker) {
+		beliefTreeWidget->clear();
+		beliefSupportLabel->setText("----");
+		return;
+	}
 
-	for(std::vector<Index> vect : combinations) {
-		// Get joint observation index for this vector
-		Index jointObservationIndex = pManager->GetPlanningUnit()->IndividualToJointObservationIndices(vect);
+	// Catch up with the steps already supplied
+	beliefTracker->Reset();
 
-		// Add probability
-		toReturn += pManager->GetPlanningUnit()->GetProblem()->
-				GetObservationProbability(stateIndex, jointActionIndex, succStateIndex, jointObservationIndex);
+	for(const std::pair<Index, Index> &step : currentVisualisation.jointActionObservations) {
+		beliefTracker->Update(step.first, step.second);
 	}
 
-	return toReturn;
+	UpdateBeliefView();
 }
 
 
-std::vector<std::vector<Index>> PolicyVisualiserView::GetCombinations(
-									const std::vector<size_t> &observationNumbers,
-									const int &agentIndex,
-									const int &observationIndex) {
-	int combinations = 1;
+void PolicyVisualiserView::UpdateBeliefView() {
+	TraceSpan span("PolicyVisualiserView::UpdateBeliefView", "visualiser");
 
-	// Calculate combinations
-	for(unsigned int i=0; i<observationNumbers.size(); ++i) {
-
-		// Skip agents index
-		if(i != agentIndex) {
-			combinations *= observationNumbers[i];
-		}
+	if(!beliefGroupBox->isChecked() || !beliefTracker) {
+		return;
 	}
 
-	// Combinations to return
-	std::vector<std::vector<Index>> toReturn(combinations);
-
-	// Start off with 0s
-	std::vector<Index> current(observationNumbers.size(), 0);
-
-	// Set the agent index we leave unchanged to the observation index
-	current[agentIndex] = observationIndex;
-	toReturn[0] = current;
-
-	// Current index of incrementation is last
-	int currentIndex = observationNumbers.size()-1;
+	beliefTreeWidget->clear();
+	beliefSupportLabel->setText(QString::number(beliefTracker->GetBelief().size()));
 
-	for(int j=1; j<combinations; ++j) {
+	// Only the top states are given rows, so large beliefs stay cheap to show
+	SparseModelSupport::SparseVector topStates =
+			beliefTracker->GetTopStates(beliefTopStatesSpinBox->value());
 
-		// If we can add one, do it
-		if((current[currentIndex] < observationNumbers[currentIndex]-1)
-		   && currentIndex != agentIndex) {
+	QList<QTreeWidgetItem*> items;
 
-			current[currentIndex]++;
-
-			// Add vector to set
-			toReturn[j] = current;
-		} else {
-
-			// While we don't have space to the 'left' or we're skipping due to agent index, decrement
-			while((observationNumbers[currentIndex]-1 == current[currentIndex])
-					|| (currentIndex == agentIndex)) {
-				--currentIndex;
-			}
-
-			// Reset all to right back to 0
-			for(int i=currentIndex+1; i<observationNumbers.size(); ++i) {
-				if(i != agentIndex) {
-					current[i] = 0;
-				}
-			}
-
-			// Increment current and set back to end
-			current[currentIndex]++;
-			currentIndex = observationNumbers.size()-1;
-
-			// Add vector to set
-			toReturn[j] = current;
-		}
+	for(const std::pair<Index, double> &state : topStates) {
+		items.append(new QTreeWidgetItem(QStringList() << GetStateName(state.first)
+														<< QString::number(state.second*100) + "%"));
 	}
 
-	return toReturn;
+	beliefTreeWidget->addTopLevelItems(items);
+	beliefTreeWidget->resizeColumnToContents(0);
 }
 
 
-
 std::vector<double> PolicyVisualiserView::GetIndividualObservationProbabilities() {
+	PlanningUnitDecPOMDPDiscrete* pUnit = pManager->GetPlanningUnit();
+
 	// Create vector of size
-	std::vector<double> individualObservationProbabilities(currentVisualisation.numAgents);
+	std::vector<double> individualObservationProbabilities(currentVisualisation.numAgents, 0.0);
 
-	// Get values based on data in currentVisualisation
-	for(Index i=0; i<currentVisualisation.numAgents; ++i) {
-		individualObservationProbabilities[i] = GetIndidividualObservationProbability(
-					i,
-					observationSelectionComboBoxes[i]->currentIndex(),
-					currentVisualisation.currentJAIndex,
-					currentVisualisation.currentStateIndex,
-					currentVisualisation.successorStateIndex);
+	// Each agents' probability is the sum over the joint observations that
+	// contain its selected observation, so one pass over the possible
+	// joint observations gives every agent
+	SparseModelSupport::SparseVector jointObservations =
+			pManager->GetModelSupport()->GetJointObservations(
+				currentVisualisation.currentStateIndex,
+				currentVisualisation.currentJAIndex,
+				currentVisualisation.successorStateIndex);
+
+	for(const std::pair<Index, double> &jointObservation : jointObservations) {
+		std::vector<Index> individualObservations =
+				pUnit->JointToIndividualObservationIndices(jointObservation.first);
+
+		for(Index i=0; i<currentVisualisation.numAgents; ++i) {
+			if((int) individualObservations[i] == observationSelectionComboBoxes[i]->currentIndex()) {
+				individualObservationProbabilities[i] += jointObservation.second;
+			}
+		}
 	}
 
 	return individualObservationProbabilities;
@@ -339,7 +329,7 @@ void PolicyVisualiserView::RecieveJointObservation(int joIndex) {
 void PolicyVisualiserView::ViewJointObservations() {
 	// Create dialog passing a new tree widget
 	JointObservationSelectionDialog* dialog =
-			new JointObservationSelectionDialog(GetJointObservationTreeWidget(), this);
+			new JointObservationSelectionDialog(GetJointObservationView(), this);
 
 	// Don't want multiple instances, user can just cancel
 	dialog->setModal(true);
@@ -353,54 +343,46 @@ void PolicyVisualiserView::ViewJointObservations() {
 }
 
 
-QTreeWidget* PolicyVisualiserView::GetJointObservationTreeWidget(QWidget* parent) {
-	QTreeWidget* treeWidget = new QTreeWidget(parent);
-
-	// Set headers
-	QTreeWidgetItem* treeWidgetHeader = treeWidget->headerItem();
-	treeWidgetHeader->setText(0, "Index");
-	treeWidgetHeader->setText(1, "Name");
-	treeWidgetHeader->setText(2, "Probability");
-
-	// Configure tree widget
-	treeWidget->setSortingEnabled(true);
-	treeWidget->setRootIsDecorated(false);
-	treeWidget->sortByColumn(2, Qt::DescendingOrder);
-	treeWidget->setSelectionMode(QAbstractItemView::SingleSelection);
-
+QTreeView* PolicyVisualiserView::GetJointObservationView(QWidget* parent) {
 	PlanningUnitDecPOMDPDiscrete* pUnit = pManager->GetPlanningUnit();
+	std::vector<JointObservationModel::Entry> jointObservations;
+
+	// Only the possible joint observations and their probabilities are
+	// collected here, the view formats the rows it shows
+	SparseModelSupport::SparseVector support =
+			pManager->GetModelSupport()->GetJointObservations(
+				currentVisualisation.currentStateIndex,
+				currentVisualisation.currentJAIndex,
+				currentVisualisation.successorStateIndex);
 
-	// Fill the tree widget
-	for(unsigned int i=0; i<pUnit->GetNrJointObservations(); ++i) {
+	jointObservations.reserve(support.size());
 
-		double obvsProbability = pUnit->GetProblem()->GetObservationProbability(
-					currentVisualisation.currentStateIndex,
-					currentVisualisation.currentJAIndex,
-					currentVisualisation.successorStateIndex,
-					i)*100;
+	for(const std::pair<Index, double> &jointObservation : support) {
+		jointObservations.push_back({jointObservation.first, jointObservation.second});
+	}
 
-		// Only add if possible, otherwise skip
-		if(obvsProbability > 0) {
-			QStringList list;
+	QTreeView* treeView = new QTreeView(parent);
 
-			// JO Index | Name | Probability
-			list << QString::number(i);
-			list << QString::fromStdString(pUnit->GetJointObservation(i)->SoftPrint());
-			list << QString::number(obvsProbability) + "%";
+	JointObservationModel* model = new JointObservationModel(jointObservations,
+		[pUnit](Index joIndex) {
+			return QString::fromStdString(pUnit->GetJointObservation(joIndex)->SoftPrint());
+		}, treeView);
 
-			// Create item and add
-			NumSortTreeWidgetItem* item = new NumSortTreeWidgetItem(treeWidget, list);
-			treeWidget->addTopLevelItem(item);
-		}
-	}
+	// Configure the view, rows being the same height lets it skip measuring every row
+	treeView->setModel(model);
+	treeView->setUniformRowHeights(true);
+	treeView->setSortingEnabled(true);
+	treeView->setRootIsDecorated(false);
+	treeView->sortByColumn(JointObservationModel::ProbabilityColumn, Qt::DescendingOrder);
+	treeView->setSelectionMode(QAbstractItemView::SingleSelection);
 
 	// Resize
-	treeWidget->setCurrentItem(treeWidget->topLevelItem(0));
-	treeWidget->resizeColumnToContents(0);
-	treeWidget->resizeColumnToContents(1);
-	treeWidget->resizeColumnToContents(2);
+	treeView->setCurrentIndex(model->index(0, 0));
+	treeView->resizeColumnToContents(JointObservationModel::IndexColumn);
+	treeView->resizeColumnToContents(JointObservationModel::NameColumn);
+	treeView->resizeColumnToContents(JointObservationModel::ProbabilityColumn);
 
-	return treeWidget;
+	return treeView;
 }
 
 
@@ -436,6 +418,8 @@ void PolicyVisualiserView::SaveGraphicsViewToFile() {
 
 
 void PolicyVisualiserView::SupplyObservations() {
+	TraceSpan span("PolicyVisualiserView::SupplyObservations", "visualiser");
+
 	// Get planning unit
 	PlanningUnitDecPOMDPDiscrete* pUnit = pManager->GetPlanningUnit();
 
@@ -454,6 +438,15 @@ void PolicyVisualiserView::SupplyObservations() {
 		currentVisualisation.totalProbability *= probability;
 	}
 
+	// Record the step and move the belief on with it
+	currentVisualisation.jointActionObservations.push_back(
+				std::make_pair(currentVisualisation.currentJAIndex, currentVisualisation.currentJOIndex));
+
+	if(beliefGroupBox->isChecked() && beliefTracker) {
+		beliefTracker->Update(currentVisualisation.currentJAIndex, currentVisualisation.currentJOIndex);
+		UpdateBeliefView();
+	}
+
 	// Get successor johi based on the previous johIndex and the one given by the user
 	currentVisualisation.johIndex = pUnit->GetSuccessorJOHI(currentVisualisation.johIndex,
 															currentVisualisation.currentJOIndex);
@@ -502,13 +495,13 @@ void PolicyVisualiserView::VisualisationFinished() {
 	endProbabilityLabel->setText(QString::number(currentVisualisation.totalProbability*100) + "%");	
 
 	// If previously created, mark for deletion
-	if(endProbabilityTreeWidget) {
-		endProbabilityTreeWidget->deleteLater();
+	if(endProbabilityTreeView) {
+		endProbabilityTreeView->deleteLater();
 	}
 
-	// Get new tree widget & add to layout
-	endProbabilityTreeWidget = GetJointObservationTreeWidget(visualisationEndWidget);
-	visualisationEndLayout->addWidget(endProbabilityTreeWidget, 0, 0, 1, 2);
+	// Get new view & add to layout
+	endProbabilityTreeView = GetJointObservationView(visualisationEndWidget);
+	visualisationEndLayout->addWidget(endProbabilityTreeView, 0, 0, 1, 2);
 
 	// Show the pane
 	visualisationEndWidget->show();
@@ -529,6 +522,10 @@ void PolicyVisualiserView::SetInitialState() {
 	// Show the controller, hide the initial state selection
 	visualisationControlWidget->show();
 	initialStateOptionsGroupBox->hide();
+	beliefGroupBox->show();
+
+	// Belief starts from the initial state distribution, not the chosen state
+	BeliefTrackingToggled(beliefGroupBox->isChecked());
 
 	// Set the joint action for the first time step
 	currentVisualisation.currentJAIndex = pManager->GetJointActionIndex(currentVisualisation.johIndex);
@@ -568,7 +565,10 @@ void PolicyVisualiserView::UpdateJointActionLabel() {
 
 
 void PolicyVisualiserView::AddNextNodes(const std::vector<double> &individualProbabilities) {
+	TraceSpan span("PolicyVisualiserView::AddNextNodes", "visualiser");
+
 	PlanningUnitDecPOMDPDiscrete* pUnit = pManager->GetPlanningUnit();
+	TreeVisGraphicsScene* scene = qobject_cast<TreeVisGraphicsScene*>(graphicsView->scene());
 
 	// Get individual actions based on the JA index
 	const std::vector<Index> individualActions =
@@ -581,14 +581,11 @@ void PolicyVisualiserView::AddNextNodes(const std::vector<double> &individualPro
 	for(unsigned int i=0; i<currentVisualisation.numAgents; ++i) {
 		Node* node = new Node(pUnit->GetAction(i, individualActions[i])->GetName(), individualObvsHistoryIndexes[i], i);
 
-		qreal xPos = (i*currentVisualisation.longestActionName) + (i*betweenNodesPadding);
-		qreal yPos = (currentVisualisation.timeStep-1)*currentVisualisation.heightSeparation;
-
 		// Set the position, adjust to the centre of the node on the x axis
-		node->setPos(xPos, yPos);
+		node->setPos(GetNodePosition(currentVisualisation.timeStep, i));
 
 		//node->pos().rx() -= node->boundingRect().width()/2;
-		graphicsView->scene()->addItem(node);
+		scene->AddNode(node, currentVisualisation.timeStep-1);
 		currentVisualisation.nodes[((currentVisualisation.timeStep-1)*currentVisualisation.numAgents)+i] = node;
 	}
 
@@ -606,12 +603,50 @@ void PolicyVisualiserView::AddNextNodes(const std::vector<double> &individualPro
 								  individualProbabilities[i]);
 
 			edge->ChangeColourToMatchProbability(!colourToObservationProbabilityCheckBox->isChecked());
-			graphicsView->scene()->addItem(edge);
+			scene->AddEdge(edge);
 		}
 	}
 }
 
 
+QPointF PolicyVisualiserView::GetNodePosition(const int &timeStep, const Index &agentIndex) const {
+	qreal xPos = (agentIndex*currentVisualisation.longestActionName) + (agentIndex*betweenNodesPadding);
+	qreal yPos = (timeStep-1)*currentVisualisation.heightSeparation;
+
+	return QPointF(xPos, yPos);
+}
+
+
+void PolicyVisualiserView::SettingsChanged(const bool &fontChanged) {
+	graphicsView->ApplyViewportSettings();
+
+	// No visualisation started yet
+	if(currentVisualisation.nodes.empty()) {
+		return;
+	}
+
+	if(fontChanged) {
+		SetLongestActionName();
+		SetHeightSeparation();
+
+		// Move the nodes shown so far, edges follow their nodes
+		for(Index i=0; i<currentVisualisation.nodes.size(); ++i) {
+			Node* node = currentVisualisation.nodes[i];
+
+			if(node) {
+				node->setPos(GetNodePosition((i/currentVisualisation.numAgents)+1, i%currentVisualisation.numAgents));
+			}
+		}
+	}
+
+	TreeVisGraphicsScene* scene = qobject_cast<TreeVisGraphicsScene*>(graphicsView->scene());
+
+	if(scene) {
+		scene->RefreshItemStyles(fontChanged);
+	}
+}
+
+
 void PolicyVisualiserView::SetHeightSeparation() {
 	int longest = 0;
 
@@ -693,6 +728,11 @@ void PolicyVisualiserView::PlanStarting() {
 	waitingForPlanLabel->show();
 	restartVisualisationButton->hide();
 	initialStateOptionsGroupBox->hide();
+	beliefGroupBox->hide();
+
+	// The tracker refers to the problem about to be replaced
+	beliefTracker.reset(nullptr);
+	beliefTreeWidget->clear();
 
 	// Fix alignment
 	parentVerticalLayout->setAlignment(Qt::AlignCenter);
@@ -712,6 +752,8 @@ void PolicyVisualiserView::PlanStarting() {
 
 
 void PolicyVisualiserView::PlanFinished() {
+	TraceSpan span("PolicyVisualiserView::PlanFinished", "visualiser");
+
 	PlanningUnitDecPOMDPDiscrete* pUnit = pManager->GetPlanningUnit();
 
 	// New instance of data for default values
@@ -725,6 +767,9 @@ void PolicyVisualiserView::PlanFinished() {
 	currentVisualisation.numAgents = pUnit->GetNrAgents();
 	currentVisualisation.nodes = std::vector<Node*>(currentVisualisation.horizon*currentVisualisation.numAgents);
 
+	beliefTracker = std::unique_ptr<BeliefTracker>(new BeliefTracker(pUnit->GetProblem(),
+																	 pManager->GetModelSupport()));
+
 	// Fix alignment
 	parentVerticalLayout->setAlignment(Qt::AlignCenter|Qt::AlignTop);
 	waitingForPlanLabel->hide();
@@ -782,17 +827,18 @@ void PolicyVisualiserView::PlanFinished() {
 
 
 void PolicyVisualiserView::UpdateCurrentStateLabel() {
-	QString newLabel;
+	// Set the label
+	currentStateLabel->setText(GetStateName(currentVisualisation.currentStateIndex));
+}
+
 
-	// If states named, set it to the name, otherwise the index
+QString PolicyVisualiserView::GetStateName(const Index &stateIndex) const {
+	// If states named, use the name, otherwise the index
 	if(currentVisualisation.statesNamed) {
-		newLabel = QString::fromStdString(pManager->GetPlanningUnit()->GetState(currentVisualisation.currentStateIndex)->GetName());
-	} else {
-		newLabel = "State " + QString::number(currentVisualisation.currentStateIndex);
+		return QString::fromStdString(pManager->GetPlanningUnit()->GetState(stateIndex)->GetName());
 	}
 
-	// Set the label
-	currentStateLabel->setText(newLabel);
+	return "State " + QString::number(stateIndex);
 }
 
 
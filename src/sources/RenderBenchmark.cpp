@@ -0,0 +1,262 @@
+#include "RenderBenchmark.h"
+
+// TreeVis
+#include "FullTreeBuilder.h"
+#include "TreeVisGraphicsScene.h"
+#include "SettingsDialog.h"
+#include "GeneralUtils.h"
+#include "Node.h"
+#include "Edge.h"
+
+// Qt
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QImage>
+#include <QPainter>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QFile>
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+
+
+RenderBenchmark::RenderBenchmark(const int &repeatCount, const double &maxNodeCount) {
+	repeats = repeatCount;
+	maxNodes = maxNodeCount;
+}
+
+
+RenderBenchmark::~RenderBenchmark() {
+	//std::cout << "~RenderBenchmark()" << std::endl;
+}
+
+
+int RenderBenchmark::RunFromCommandLine(const QStringList &arguments) {
+	QCommandLineParser parser;
+	parser.setApplicationDescription("Measures building and rendering full trees of synthetic policies");
+	parser.addHelpOption();
+
+	parser.addOption(QCommandLineOption("observations", "Numbers of observations to measure.", "list", "2,3,5"));
+	parser.addOption(QCommandLineOption("horizons", "Horizons to measure.", "list", "3,5,7,9"));
+	parser.addOption(QCommandLineOption("label-lengths", "Lengths of the action and observation names.", "list", "4,16"));
+	parser.addOption(QCommandLineOption("max-nodes", "Skip trees with more nodes than this.", "n", "200000"));
+	parser.addOption(QCommandLineOption("repeats", "Times each tree is measured, the best is kept.", "n", "3"));
+	parser.addOption(QCommandLineOption("json", "File to write the results to as JSON.", "file"));
+
+	parser.process(arguments);
+
+	std::vector<Index> observationCounts;
+	std::vector<Index> horizons;
+	std::vector<int> labelLengths;
+	int repeatCount = parser.value("repeats").toInt();
+
+	if(!CommandLineUtils::ParseNumberList(parser.value("observations"), observationCounts) ||
+	   !CommandLineUtils::ParseNumberList(parser.value("horizons"), horizons) ||
+	   !CommandLineUtils::ParseNumberList(parser.value("label-lengths"), labelLengths) || repeatCount < 1) {
+		std::cerr << parser.helpText().toStdString();
+		return 1;
+	}
+
+	// Colours as in the application, fonts fixed so results can be compared between machines
+	SettingsDialog::ApplySavedSettings();
+	QFont font = QFont("Helvetica", 12);
+	Node::SetFont(font);
+	Edge::SetFont(font);
+
+	RenderBenchmark benchmark(repeatCount, parser.value("max-nodes").toDouble());
+	std::vector<Result> results = benchmark.Run(observationCounts, horizons, labelLengths);
+
+	if(parser.isSet("json")) {
+		QJsonArray resultsArray;
+
+		for(const Result &result : results) {
+			resultsArray.append(ToJson(result));
+		}
+
+		QJsonObject root;
+		root["benchmark"] = "render";
+		root["repeats"] = repeatCount;
+		root["frameWidth"] = benchmark.frameWidth;
+		root["frameHeight"] = benchmark.frameHeight;
+		root["results"] = resultsArray;
+
+		QFile file(parser.value("json"));
+
+		if(!file.open(QIODevice::WriteOnly | QIODevice::Truncate) ||
+		   file.write(QJsonDocument(root).toJson()) == -1) {
+			std::cerr << "Could not write " << parser.value("json").toStdString() << std::endl;
+			return 2;
+		}
+	}
+
+	return 0;
+}
+
+
+std::vector<RenderBenchmark::Result> RenderBenchmark::Run(const std::vector<Index> &observationCounts,
+														  const std::vector<Index> &horizons,
+														  const std::vector<int> &labelLengths) {
+	std::vector<Result> results;
+
+	std::cout << std::setw(5) << "obs" << std::setw(5) << "hor" << std::setw(6) << "label"
+			  << std::setw(10) << "nodes" << std::setw(10) << "items"
+			  << std::setw(11) << "build ms" << std::setw(11) << "edges ms"
+			  << std::setw(11) << "fit ms" << std::setw(11) << "detail ms"
+			  << std::setw(10) << "peak MB" << std::endl;
+
+	for(const Index &nrObservations : observationCounts) {
+		for(const Index &horizon : horizons) {
+
+			// Sum of nrObservations^depth over the levels
+			double nrNodes = 0;
+
+			for(Index depth=0; depth<horizon; ++depth) {
+				nrNodes += std::pow((double) nrObservations, (double) depth);
+			}
+
+			if(nrNodes > maxNodes) {
+				std::cout << std::setw(5) << nrObservations << std::setw(5) << horizon
+						  << "  skipped, " << nrNodes << " nodes" << std::endl;
+				continue;
+			}
+
+			for(const int &labelLength : labelLengths) {
+				Result result = Measure(nrObservations, horizon, labelLength);
+				results.push_back(result);
+
+				std::cout << std::fixed << std::setprecision(2)
+						  << std::setw(5) << result.nrObservations << std::setw(5) << result.horizon
+						  << std::setw(6) << result.labelLength
+						  << std::setw(10) << result.nrNodes << std::setw(10) << result.nrItems
+						  << std::setw(11) << result.buildMs << std::setw(11) << result.updateEdgesMs
+						  << std::setw(11) << result.fitFrameMs << std::setw(11) << result.detailFrameMs
+						  << std::setw(10) << result.peakMemoryMB << std::endl;
+			}
+		}
+	}
+
+	return results;
+}
+
+
+RenderBenchmark::Result RenderBenchmark::Measure(const Index &nrObservations,
+												 const Index &horizon,
+												 const int &labelLength) {
+	Result result;
+	result.nrObservations = nrObservations;
+	result.horizon = horizon;
+	result.labelLength = labelLength;
+
+	AgentPolicy policy = CreateSyntheticPolicy(nrObservations, horizon, labelLength);
+
+	QImage frame(frameWidth, frameHeight, QImage::Format_ARGB32_Premultiplied);
+	QElapsedTimer timer;
+
+	for(int repeat=0; repeat<repeats; ++repeat) {
+		size_t memoryBefore = MemoryUtils::GetResidentMemory();
+		MemoryUtils::ResetPeakResidentMemory();
+
+		// Declared first so it outlives the builder that refers to it
+		TreeVisGraphicsScene scene;
+
+		timer.start();
+		FullTreeBuilder builder(policy, &scene, paddingBetweenNodes);
+		builder.Build(horizon);
+		double buildMs = timer.nsecsElapsed() / 1e6;
+
+		timer.start();
+
+		for(Edge* edge : scene.GetEdges()) {
+			edge->UpdatePosition();
+		}
+
+		double updateEdgesMs = timer.nsecsElapsed() / 1e6;
+
+		// Whole tree in one frame, as zoomed all the way out
+		frame.fill(Qt::white);
+		QPainter painter(&frame);
+		painter.setRenderHint(QPainter::Antialiasing);
+
+		timer.start();
+		scene.render(&painter, QRectF(frame.rect()), scene.itemsBoundingRect(), Qt::KeepAspectRatio);
+		double fitFrameMs = timer.nsecsElapsed() / 1e6;
+
+		// A frame at full size from the root, as when the tree is first shown
+		QPointF root = scene.GetNode(policy.agentIndex, 0)->pos();
+		QRectF detail = QRectF(root.x() - frameWidth/2, root.y() - frameHeight/4, frameWidth, frameHeight);
+		painter.fillRect(frame.rect(), Qt::white);
+
+		timer.start();
+		scene.render(&painter, QRectF(frame.rect()), detail);
+		double detailFrameMs = timer.nsecsElapsed() / 1e6;
+
+		painter.end();
+
+		size_t peak = MemoryUtils::GetPeakResidentMemory();
+		double peakMemoryMB = peak > memoryBefore ? (peak - memoryBefore) / (1024.0*1024.0) : 0;
+
+		// Best of the repeats, the others are noise from the rest of the system
+		if(repeat == 0) {
+			result.nrNodes = scene.GetNodes().size();
+			result.nrEdges = scene.GetEdges().size();
+			result.nrItems = scene.items().size();
+			result.buildMs = buildMs;
+			result.updateEdgesMs = updateEdgesMs;
+			result.fitFrameMs = fitFrameMs;
+			result.detailFrameMs = detailFrameMs;
+			result.peakMemoryMB = peakMemoryMB;
+		} else {
+			result.buildMs = std::min(result.buildMs, buildMs);
+			result.updateEdgesMs = std::min(result.updateEdgesMs, updateEdgesMs);
+			result.fitFrameMs = std::min(result.fitFrameMs, fitFrameMs);
+			result.detailFrameMs = std::min(result.detailFrameMs, detailFrameMs);
+			result.peakMemoryMB = std::max(result.peakMemoryMB, peakMemoryMB);
+		}
+	}
+
+	return result;
+}
+
+
+AgentPolicy RenderBenchmark::CreateSyntheticPolicy(const Index &nrObservations,
+												   const Index &horizon,
+												   const int &labelLength) {
+	AgentPolicy policy;
+	policy.horizon = horizon;
+
+	// Names padded to the length so the label length is all that changes
+	for(Index i=0; i<3; ++i) {
+		policy.actionNames.push_back(QString("a%1").arg(i).leftJustified(labelLength, 'x'));
+	}
+
+	for(Index i=0; i<nrObservations; ++i) {
+		policy.observationNames.push_back(QString("o%1").arg(i).leftJustified(labelLength, 'x'));
+	}
+
+	// Knuth multiplicative hash spreads the actions over the tree
+	policy.GetActionIndex = [](Index ohIndex) {
+		return (Index) ((ohIndex * 2654435761u) >> 16) % 3;
+	};
+
+	return policy;
+}
+
+
+QJsonObject RenderBenchmark::ToJson(const Result &result) {
+	QJsonObject object;
+	object["nrObservations"] = (int) result.nrObservations;
+	object["horizon"] = (int) result.horizon;
+	object["labelLength"] = result.labelLength;
+	object["nrNodes"] = result.nrNodes;
+	object["nrEdges"] = result.nrEdges;
+	object["nrItems"] = result.nrItems;
+	object["buildMs"] = result.buildMs;
+	object["updateEdgesMs"] = result.updateEdgesMs;
+	object["fitFrameMs"] = result.fitFrameMs;
+	object["detailFrameMs"] = result.detailFrameMs;
+	object["peakMemoryMB"] = result.peakMemoryMB;
+	return object;
+}
@@ -2,6 +2,7 @@
 
 // TreeVis
 #include "GeneralUtils.h"
+#include "TreeVisGraphicsView.h"
 
 // Qt
 #include <QHBoxLayout>
@@ -91,6 +92,35 @@ SettingsDialog::SettingsDialog(QWidget* parent) : QDialog(parent) {
 			this, &SettingsDialog::UpdateFont);
 
 
+	// Rendering options, order must match TreeVisGraphicsView::viewportType
+	viewportComboBox = new QComboBox(controlWrap);
+	viewportComboBox->addItem("Raster");
+	viewportComboBox->addItem("OpenGL");
+	viewportComboBox->addItem("OpenGL (Software)");
+	viewportComboBox->setToolTip("OpenGL draws through the graphics card, Software uses "
+								 "the Mesa software renderer and needs a restart");
+
+	adaptiveAntialiasingCheckBox = new QCheckBox(controlWrap);
+	adaptiveAntialiasingCheckBox->setToolTip("Keeps dragging and zooming smooth on large trees");
+
+	frameStatisticsCheckBox = new QCheckBox(controlWrap);
+	frameStatisticsCheckBox->setToolTip("Shows paint times, items and memory over the views, "
+										"right click the overlay to export them");
+
+	separateProcessCheckBox = new QCheckBox(controlWrap);
+	separateProcessCheckBox->setToolTip("A planner that crashes or runs out of memory then only fails the plan");
+
+	memoryBudgetSpinBox = new QSpinBox(controlWrap);
+	memoryBudgetSpinBox->setRange(0, 1048576); // Up to 1 TB
+	memoryBudgetSpinBox->setSingleStep(256);
+	memoryBudgetSpinBox->setSuffix(" MB");
+	memoryBudgetSpinBox->setSpecialValueText("No limit");
+	memoryBudgetSpinBox->setToolTip("Memory a plan may use before it is retried with sparse beliefs, "
+									"then without cached models, then stopped. Only when planning in a separate process");
+
+	// The budget is enforced on the child process only
+	connect(separateProcessCheckBox, &QCheckBox::toggled, memoryBudgetSpinBox, &QSpinBox::setEnabled);
+
 	// Add all to form layout
 	formLayout->addRow("Node Fill Colour:", nodeFillColourComboBox);
 	formLayout->addRow("Node Outline Colour:", nodeOutlineColourComboBox);
@@ -102,6 +132,12 @@ SettingsDialog::SettingsDialog(QWidget* parent) : QDialog(parent) {
 	formLayout->addRow("Font:", fontComboBox);
 	formLayout->addRow("Font Size:", fontSizeSpinBox);
 
+	formLayout->addRow("Viewport:", viewportComboBox);
+	formLayout->addRow("No Antialiasing While Moving:", adaptiveAntialiasingCheckBox);
+	formLayout->addRow("Show Frame Statistics:", frameStatisticsCheckBox);
+	formLayout->addRow("Plan in Separate Process:", separateProcessCheckBox);
+	formLayout->addRow("Plan Memory Budget:", memoryBudgetSpinBox);
+
 
 	// Button box for dialog
 	buttonBox = new QDialogButtonBox(this);
@@ -131,6 +167,14 @@ SettingsDialog::SettingsDialog(QWidget* parent) : QDialog(parent) {
 void SettingsDialog::LoadSettings() {
 	QSettings settings;
 
+	// Rendering options are newer than the rest, so have their own defaults
+	viewportComboBox->setCurrentIndex(settings.value("view/viewport", TreeVisGraphicsView::RasterViewport).toInt());
+	adaptiveAntialiasingCheckBox->setChecked(settings.value("view/adaptiveAntialiasing", true).toBool());
+	frameStatisticsCheckBox->setChecked(settings.value("view/frameStatistics", false).toBool());
+	separateProcessCheckBox->setChecked(settings.value("planning/separateProcess", true).toBool());
+	memoryBudgetSpinBox->setValue(settings.value("planning/memoryBudgetMB", 0).toInt());
+	memoryBudgetSpinBox->setEnabled(separateProcessCheckBox->isChecked());
+
 	// If no settings set, use hard coded default values
 	if(!settings.contains("node/fillColour")) {
 		nodeFillColourComboBox->setCurrentIndex(1); // White
@@ -236,6 +280,12 @@ void SettingsDialog::Accept() {
 	settings.setValue("font/size", fontSizeSpinBox->value());
 	settings.setValue("font/font", fontComboBox->currentFont());
 
+	settings.setValue("view/viewport", viewportComboBox->currentIndex());
+	settings.setValue("view/adaptiveAntialiasing", adaptiveAntialiasingCheckBox->isChecked());
+	settings.setValue("view/frameStatistics", frameStatisticsCheckBox->isChecked());
+	settings.setValue("planning/separateProcess", separateProcessCheckBox->isChecked());
+	settings.setValue("planning/memoryBudgetMB", memoryBudgetSpinBox->value());
+
 
 	// Set current values for this instance of the application
 	// (otherwise restart required)
@@ -256,12 +306,56 @@ void SettingsDialog::Accept() {
 	Node::SetFont(font);
 	Edge::SetFont(font);
 
+	// Views pick these up when told the settings changed
+	TreeVisGraphicsView::SetViewportType(
+				static_cast<TreeVisGraphicsView::viewportType>(viewportComboBox->currentIndex()));
+	TreeVisGraphicsView::SetAdaptiveAntialiasing(adaptiveAntialiasingCheckBox->isChecked());
+	TreeVisGraphicsView::SetShowFrameStatistics(frameStatisticsCheckBox->isChecked());
+
 	// Commit to file
 	settings.sync();
 	QDialog::accept();
 }
 
 
+void SettingsDialog::ApplySavedSettings() {
+	QSettings settings;
+
+	// If settings have been created
+	if(settings.contains("node/fillColour")) {
+		Node::SetDefaultFillColour(settings.value("node/fillColour").value<QColor>());
+		Node::SetDefaultOutlineColour(settings.value("node/outlineColour").value<QColor>());
+		Node::SetDefaultTextColour(settings.value("node/textColour").value<QColor>());
+
+		Edge::SetDefaultColour(settings.value("edge/colour").value<QColor>());
+		Edge::SetDefaultTextColour(settings.value("edge/textColour").value<QColor>());
+
+		QFont font = settings.value("font/font").value<QFont>();
+		font.setPointSize(settings.value("font/size").toInt());
+
+		Node::SetFont(font);
+		Edge::SetFont(font);
+	} else {
+		// Otherwise use hard coded defaults
+		Node::SetDefaultFillColour(QColor("white"));
+		Node::SetDefaultOutlineColour(QColor("black"));
+		Node::SetDefaultTextColour(QColor("black"));
+
+		Edge::SetDefaultColour(QColor("black"));
+		Edge::SetDefaultTextColour(QColor("black"));
+
+		QFont font = QFont("Helvetica", 12);
+		Node::SetFont(font);
+		Edge::SetFont(font);
+	}
+
+	TreeVisGraphicsView::SetViewportType(static_cast<TreeVisGraphicsView::viewportType>(
+				settings.value("view/viewport", TreeVisGraphicsView::RasterViewport).toInt()));
+	TreeVisGraphicsView::SetAdaptiveAntialiasing(settings.value("view/adaptiveAntialiasing", true).toBool());
+	TreeVisGraphicsView::SetShowFrameStatistics(settings.value("view/frameStatistics", false).toBool());
+}
+
+
 void SettingsDialog::Reject() {
 	QDialog::reject();
 }
@@ -293,9 +387,9 @@ void SettingsDialog::UpdateFont() {
 	edge->SetEdgeColour(selectedEdgeColour);
 
 	// Set the position of node two to allow enough room
-	// for the text + padding of 30. Child bounding rect will give us
-	// label width as the edge will be 0 (nodes are both at (0,0))
-	nodeTwo->setPos(nodeOne->boundingRect().width() + edge->childrenBoundingRect().width() + 30, 0);
+	// for the text + padding of 30. Label is measured in the new font
+	edge->UpdatePosition();
+	nodeTwo->setPos(nodeOne->boundingRect().width() + edge->GetLabelSize().width() + 30, 0);
 
 	// Add items
 	graphicsView->scene()->addItem(nodeOne);
@@ -0,0 +1,97 @@
+#include "SparseModelSupport.h"
+
+
+SparseModelSupport::SparseModelSupport(const DecPOMDPDiscreteInterface* decpomdp) {
+	problem = decpomdp;
+
+	// Factored problems may not have flat models, leave as dense if so
+	try {
+		transitionModel = dynamic_cast<const TransitionModelMappingSparse*>(problem->GetTransitionModelDiscretePtr());
+		observationModel = dynamic_cast<const ObservationModelMappingSparse*>(problem->GetObservationModelDiscretePtr());
+	} catch(E &e) {
+		transitionModel = nullptr;
+		observationModel = nullptr;
+	}
+}
+
+
+SparseModelSupport::~SparseModelSupport() {
+	//std::cout << "~SparseModelSupport()" << std::endl;
+}
+
+
+SparseModelSupport::SparseVector SparseModelSupport::GetSuccessorStates(const Index &stateIndex,
+																		const Index &jointActionIndex) const {
+	// Matrix of the joint action is indexed [s][s']
+	if(transitionModel) {
+		return GetRow(transitionModel->GetMatrixPtr(jointActionIndex), stateIndex);
+	}
+
+	SparseVector support;
+
+	for(Index succStateIndex=0; succStateIndex<problem->GetNrStates(); ++succStateIndex) {
+		double probability = problem->GetTransitionProbability(stateIndex, jointActionIndex, succStateIndex);
+
+		if(probability > 0) {
+			support.push_back(std::make_pair(succStateIndex, probability));
+		}
+	}
+
+	return support;
+}
+
+
+SparseModelSupport::SparseVector SparseModelSupport::GetJointObservations(const Index &stateIndex,
+																		  const Index &jointActionIndex,
+																		  const Index &succStateIndex) const {
+	// Matrix of the joint action is indexed [s'][jo], the state
+	// the action was taken in does not affect these models
+	if(observationModel) {
+		return GetRow(observationModel->GetMatrixPtr(jointActionIndex), succStateIndex);
+	}
+
+	SparseVector support;
+
+	for(Index joIndex=0; joIndex<problem->GetNrJointObservations(); ++joIndex) {
+		double probability = problem->GetObservationProbability(stateIndex, jointActionIndex,
+																succStateIndex, joIndex);
+
+		if(probability > 0) {
+			support.push_back(std::make_pair(joIndex, probability));
+		}
+	}
+
+	return support;
+}
+
+
+bool SparseModelSupport::IsTransitionModelSparse() const {
+	return transitionModel != nullptr;
+}
+
+
+bool SparseModelSupport::IsObservationModelSparse() const {
+	return observationModel != nullptr;
+}
+
+
+SparseModelSupport::SparseVector SparseModelSupport::GetRow(const SparseMatrix* matrix, const Index &row) {
+	SparseVector support;
+
+	// Only the stored elements of the row are visited
+	SparseMatrix::const_iterator1 rowIterator = matrix->find1(0, row, 0);
+
+	if(rowIterator == matrix->end1() || rowIterator.index1() != row) {
+		return support;
+	}
+
+	for(SparseMatrix::const_iterator2 it = rowIterator.begin(); it != rowIterator.end(); ++it) {
+
+		// Explicitly stored zeros are not part of the support
+		if(*it > 0) {
+			support.push_back(std::make_pair((Index) it.index2(), *it));
+		}
+	}
+
+	return support;
+}
@@ -3,6 +3,7 @@
 // TreeVis files
 #include "PlannerManager.h"
 #include "MainWindow.h"
+#include "PlanCostEstimator.h"
 
 // MADP Files
 #include "argumentUtils.h"
@@ -18,6 +19,8 @@
 #include <QLineEdit>
 #include <QPushButton>
 #include <QScrollArea>
+#include <QMessageBox>
+#include <QApplication>
 
 StartPlanWizard::StartPlanWizard(QWidget* parent) : QWizard(parent) {
 
@@ -33,9 +36,8 @@ StartPlanWizard::StartPlanWizard(QWidget* parent) : QWizard(parent) {
 
 	setButtonText(QWizard::FinishButton, "Plan");
 
-	// Connect finish button to our method
-	connect(button(QWizard::FinishButton), &QAbstractButton::clicked,
-			this, &StartPlanWizard::FinishButtonClicked);
+	// Connect finish to our method, once the last page has been validated
+	connect(this, &QDialog::accepted, this, &StartPlanWizard::FinishButtonClicked);
 
 	setMinimumSize(900, 500);
 
@@ -53,6 +55,14 @@ StartPlanWizard::~StartPlanWizard() {
 void StartPlanWizard::FinishButtonClicked() {
 	// Get planner type and our args to send
 	PlannerManager::PlannerType type = GetPlannerType();
+	ArgumentHandlers::Arguments args = GetArguments(type);
+
+	// Start Plan on Main Window giving the args and planner type
+	emit StartPlan(type, args);
+}
+
+
+ArgumentHandlers::Arguments StartPlanWizard::GetArguments(const PlannerManager::PlannerType &type) {
 	ArgumentHandlers::Arguments args;
 
 	// Set problem based options
@@ -76,8 +86,84 @@ void StartPlanWizard::FinishButtonClicked() {
 			break;
 	}
 
-	// Start Plan on Main Window giving the args and planner type
-	emit StartPlan(type, args);
+	return args;
+}
+
+
+bool StartPlanWizard::validateCurrentPage() {
+	if(!QWizard::validateCurrentPage()) {
+		return false;
+	}
+
+	// Only the last page starts the plan
+	if(currentId() != GeneralProblemOptions) {
+		return true;
+	}
+
+	return ConfirmPlanCost();
+}
+
+
+bool StartPlanWizard::ConfirmPlanCost() {
+	PlannerManager::PlannerType type = GetPlannerType();
+	ArgumentHandlers::Arguments args = GetArguments(type);
+
+	std::unique_ptr<DecPOMDPDiscreteInterface> decpomdp;
+
+	// Reading a large problem file can take a moment
+	QApplication::setOverrideCursor(Qt::WaitCursor);
+
+	try {
+		decpomdp = std::unique_ptr<DecPOMDPDiscreteInterface>(
+					ArgumentUtils::GetDecPOMDPDiscreteInterfaceFromArgs(args));
+	} catch(E &e) {
+		// The planner reports a problem that cannot be read
+		std::cout << "Could not estimate the plan: " << e.SoftPrint() << std::endl;
+	}
+
+	QApplication::restoreOverrideCursor();
+
+	PlanCostEstimator::Estimate estimate;
+	QString suggestion;
+
+	if(decpomdp) {
+		PlanCostEstimator estimator(*decpomdp);
+		estimate = estimator.GetEstimate(type, args);
+
+		if(estimate.result != PlanCostEstimator::Fits) {
+			suggestion = estimator.GetSuggestion(type, args);
+		}
+	}
+
+	// Delete the pointer to the char* we created if needed
+	if(args.problem_type == ProblemType::PARSE) {
+		delete[] args.dpf;
+	}
+
+	if(!decpomdp || estimate.result == PlanCostEstimator::Fits) {
+		return true;
+	}
+
+	QString details = PlanCostEstimator::Describe(estimate);
+
+	if(!suggestion.isEmpty()) {
+		details += "\n\n" + suggestion;
+	}
+
+	if(estimate.result == PlanCostEstimator::Block) {
+		QMessageBox::critical(this, "Plan Will Not Fit",
+							  "This plan needs more memory than the machine has available, "
+							  "change the options to plan.\n\n" + details);
+		return false;
+	}
+
+	QMessageBox::StandardButton answer =
+			QMessageBox::warning(this, "Plan May Not Finish",
+								 "This plan may use most of the memory available or take a long time.\n\n" +
+								 details + "\n\nPlan anyway?",
+								 QMessageBox::Yes | QMessageBox::No, QMessageBox::No);
+
+	return answer == QMessageBox::Yes;
 }
 
 
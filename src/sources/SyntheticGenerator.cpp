@@ -0,0 +1,305 @@
+#include "SyntheticGenerator.h"
+
+// TreeVis
+#include "PlannerManager.h"
+#include "GeneralUtils.h"
+
+// MADP
+#include "argumentUtils.h"
+
+// Qt
+#include <QCommandLineParser>
+#include <QFileInfo>
+
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+
+
+SyntheticGenerator::SyntheticGenerator(const unsigned int &randomSeed) : generator(randomSeed) {
+
+}
+
+
+SyntheticGenerator::~SyntheticGenerator() {
+	//std::cout << "~SyntheticGenerator()" << std::endl;
+}
+
+
+bool SyntheticGenerator::IsRequested(int argc, char** argv) {
+	for(int i=1; i<argc; ++i) {
+		if(strcmp(argv[i], "--generate") == 0) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
+int SyntheticGenerator::RunFromCommandLine(const QStringList &arguments) {
+	QCommandLineParser parser;
+	parser.setApplicationDescription("Generates random policies, and synthetic problems for them, to try large trees");
+	parser.addHelpOption();
+
+	parser.addOption(QCommandLineOption("generate", "Generate without showing a window."));
+	parser.addOption(QCommandLineOption("horizon", "Horizon of the policy.", "h"));
+	parser.addOption(QCommandLineOption("problem", "A .dpomdp file or built in problem to write a policy for, "
+													"instead of generating a problem.", "problem"));
+	parser.addOption(QCommandLineOption("agents", "Agents of the generated problem.", "n", "2"));
+	parser.addOption(QCommandLineOption("states", "States of the generated problem.", "n", "2"));
+	parser.addOption(QCommandLineOption("actions", "Actions of every agent, or of each agent in turn.", "list", "3"));
+	parser.addOption(QCommandLineOption("observations", "Observations of every agent, or of each agent in turn.", "list", "2"));
+	parser.addOption(QCommandLineOption("problem-out", "Where to write the generated problem.", "file", "synthetic.dpomdp"));
+	parser.addOption(QCommandLineOption("policy-out", "Where to write the policy.", "file", "synthetic_policy.txt"));
+	parser.addOption(QCommandLineOption("seed", "Seed for everything generated.", "n", "1"));
+
+	parser.process(arguments);
+
+	Index horizon = parser.value("horizon").toUInt();
+
+	if(horizon == 0) {
+		std::cerr << parser.helpText().toStdString();
+		return 1;
+	}
+
+	SyntheticGenerator syntheticGenerator(parser.value("seed").toUInt());
+	std::vector<Index> nrActions;
+	std::vector<Index> nrObservations;
+
+	if(parser.isSet("problem")) {
+		ArgumentHandlers::Arguments args;
+		std::string problemPath = parser.value("problem").toStdString();
+
+		// A file is parsed, the path only has to live while the problem is read
+		if(!PlannerManager::GetBuiltInProblemArguments(parser.value("problem"), args)) {
+			if(!QFileInfo(parser.value("problem")).isFile()) {
+				std::cerr << "No problem " << problemPath << std::endl;
+				return 1;
+			}
+
+			args.problem_type = ProblemType::PARSE;
+			args.dpf = &problemPath[0];
+		}
+
+		try {
+			std::unique_ptr<DecPOMDPDiscreteInterface> decpomdp(
+						ArgumentUtils::GetDecPOMDPDiscreteInterfaceFromArgs(args));
+
+			for(Index i=0; i<decpomdp->GetNrAgents(); ++i) {
+				nrActions.push_back(decpomdp->GetNrActions(i));
+				nrObservations.push_back(decpomdp->GetNrObservations(i));
+			}
+		} catch(E &e) {
+			std::cerr << "Could not read the problem: " << e.SoftPrint() << std::endl;
+			return 1;
+		}
+	} else {
+		Index nrAgents = parser.value("agents").toUInt();
+		Index nrStates = parser.value("states").toUInt();
+
+		if(nrAgents == 0 || nrStates == 0 ||
+		   !CommandLineUtils::ParseNumberList(parser.value("actions"), nrActions) ||
+		   !CommandLineUtils::ParseNumberList(parser.value("observations"), nrObservations)) {
+			std::cerr << parser.helpText().toStdString();
+			return 1;
+		}
+
+		// One count is used for every agent
+		if(nrActions.size() == 1) {
+			nrActions.resize(nrAgents, nrActions[0]);
+		}
+
+		if(nrObservations.size() == 1) {
+			nrObservations.resize(nrAgents, nrObservations[0]);
+		}
+
+		if(nrActions.size() != nrAgents || nrObservations.size() != nrAgents) {
+			std::cerr << "Give one count for all agents, or one for each agent" << std::endl;
+			return 1;
+		}
+
+		if(!syntheticGenerator.WriteProblemFile(parser.value("problem-out"), nrStates, nrActions, nrObservations)) {
+			std::cerr << "Could not write " << parser.value("problem-out").toStdString() << std::endl;
+			return 2;
+		}
+
+		std::cout << "Wrote " << parser.value("problem-out").toStdString() << std::endl;
+	}
+
+	std::vector<Index> numObservationHistories;
+
+	if(!CountObservationHistories(nrObservations, horizon, numObservationHistories)) {
+		std::cerr << "Too many observation histories to index at horizon " << horizon << std::endl;
+		return 1;
+	}
+
+	if(syntheticGenerator.WritePolicyFile(parser.value("policy-out"), horizon, numObservationHistories, nrActions) < 0) {
+		std::cerr << "Could not write " << parser.value("policy-out").toStdString() << std::endl;
+		return 2;
+	}
+
+	std::cout << "Wrote " << parser.value("policy-out").toStdString() << ", observation histories:";
+
+	for(const Index &count : numObservationHistories) {
+		std::cout << " " << count;
+	}
+
+	std::cout << std::endl;
+	return 0;
+}
+
+
+bool SyntheticGenerator::CountObservationHistories(const std::vector<Index> &nrObservations,
+												   const Index &horizon,
+												   std::vector<Index> &numObservationHistories) {
+	numObservationHistories.clear();
+
+	for(const Index &observations : nrObservations) {
+		double count = 0;
+
+		for(Index t=0; t<horizon; ++t) {
+			count += std::pow((double) observations, (double) t);
+		}
+
+		if(count > std::numeric_limits<Index>::max()) {
+			return false;
+		}
+
+		numObservationHistories.push_back((Index) count);
+	}
+
+	return true;
+}
+
+
+bool SyntheticGenerator::WriteProblemFile(const QString &filePath,
+										  const Index &nrStates,
+										  const std::vector<Index> &nrActions,
+										  const std::vector<Index> &nrObservations) {
+	std::ofstream output(filePath.toStdString());
+
+	if(!output.is_open()) {
+		return false;
+	}
+
+	// Enough digits that every distribution sums to one when read back
+	output << std::setprecision(17);
+
+	output << "# Synthetic problem, every transition, observation and reward is random\n";
+	output << "agents: " << nrActions.size() << "\n";
+	output << "discount: 1\n";
+	output << "values: reward\n";
+	output << "states: " << nrStates << "\n";
+	output << "start:\n";
+	output << "uniform\n";
+	output << "actions:\n";
+
+	for(const Index &actions : nrActions) {
+		output << actions << "\n";
+	}
+
+	output << "observations:\n";
+
+	Index nrJointObservations = 1;
+
+	for(const Index &observations : nrObservations) {
+		output << observations << "\n";
+		nrJointObservations *= observations;
+	}
+
+	std::uniform_real_distribution<double> rewards(-10, 10);
+
+	// Every joint action, counting through the individual actions
+	std::vector<Index> jointAction(nrActions.size(), 0);
+	bool moreJointActions = true;
+
+	while(moreJointActions) {
+		std::string actions;
+
+		for(const Index &action : jointAction) {
+			actions += std::to_string(action) + " ";
+		}
+
+		for(Index s=0; s<nrStates; ++s) {
+			output << "T: " << actions << ": " << s << " :\n";
+			WriteDistribution(output, nrStates);
+		}
+
+		for(Index s=0; s<nrStates; ++s) {
+			output << "O: " << actions << ": " << s << " :\n";
+			WriteDistribution(output, nrJointObservations);
+		}
+
+		for(Index s=0; s<nrStates; ++s) {
+			output << "R: " << actions << ": " << s << " : * : * : " << rewards(generator) << "\n";
+		}
+
+		// Next joint action, the last agent changing fastest
+		moreJointActions = false;
+
+		for(Index i=jointAction.size(); i-- > 0 && !moreJointActions;) {
+			if(++jointAction[i] < nrActions[i]) {
+				moreJointActions = true;
+			} else {
+				jointAction[i] = 0;
+			}
+		}
+	}
+
+	output.close();
+	return !output.fail();
+}
+
+
+void SyntheticGenerator::WriteDistribution(std::ostream &output, const Index &size) {
+	std::uniform_real_distribution<double> weights(0.01, 1);
+	std::vector<double> probabilities(size);
+	double total = 0;
+
+	for(double &probability : probabilities) {
+		probability = weights(generator);
+		total += probability;
+	}
+
+	for(Index i=0; i<size; ++i) {
+		output << probabilities[i] / total << (i+1 < size ? " " : "\n");
+	}
+}
+
+
+qint64 SyntheticGenerator::WritePolicyFile(const QString &filePath,
+										   const Index &horizon,
+										   const std::vector<Index> &numObservationHistories,
+										   const std::vector<Index> &numActions) {
+	std::ofstream output(filePath.toStdString());
+
+	if(!output.is_open()) {
+		return -1;
+	}
+
+	// Header read by PlannerManager::PreviousPlan()
+	output << "Horizon = " << horizon << "\n";
+	output << "Agents = " << numObservationHistories.size() << "\n";
+
+	for(Index i=0; i<numObservationHistories.size(); ++i) {
+		output << "Agent" << i << " = " << numObservationHistories[i] << "\n";
+	}
+
+	qint64 headerBytes = output.tellp();
+
+	// One action index per observation history, an agent per line
+	for(Index i=0; i<numObservationHistories.size(); ++i) {
+		for(Index ohIndex=0; ohIndex<numObservationHistories[i]; ++ohIndex) {
+			output << generator() % numActions[i] << ' ';
+		}
+
+		output << "\n";
+	}
+
+	output.close();
+	return output.fail() ? -1 : headerBytes;
+}
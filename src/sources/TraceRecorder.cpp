@@ -0,0 +1,253 @@
+#include "TraceRecorder.h"
+
+// Qt
+#include <QCoreApplication>
+#include <QThread>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QJsonDocument>
+#include <QFile>
+
+#include <chrono>
+#include <set>
+
+std::atomic<bool> TraceRecorder::enabled(false);
+std::mutex TraceRecorder::registryMutex;
+std::vector<std::unique_ptr<TraceRecorder::ThreadBuffer>> TraceRecorder::buffers;
+std::vector<TraceRecorder::ProcessEvent> TraceRecorder::processEvents;
+size_t TraceRecorder::nextProcessEvent = 0;
+const size_t TraceRecorder::bufferSize;
+
+namespace {
+	/// Names kept by Intern(), never freed while spans may point at them
+	std::set<std::string> internedNames;
+
+	/// Time zero of the trace
+	const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+}
+
+
+void TraceRecorder::SetEnabled(const bool &enable) {
+	enabled.store(enable, std::memory_order_relaxed);
+}
+
+
+bool TraceRecorder::IsEnabled() {
+	return enabled.load(std::memory_order_relaxed);
+}
+
+
+qint64 TraceRecorder::NowUs() {
+	return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - epoch).count();
+}
+
+
+qint64 TraceRecorder::EpochUs() {
+	return std::chrono::duration_cast<std::chrono::microseconds>(epoch.time_since_epoch()).count();
+}
+
+
+TraceRecorder::ThreadBuffer* TraceRecorder::GetThreadBuffer() {
+	thread_local ThreadBuffer* threadBuffer = nullptr;
+
+	if(!threadBuffer) {
+		std::unique_ptr<ThreadBuffer> buffer(new ThreadBuffer());
+		buffer->events.resize(bufferSize);
+
+		// Pooled threads are all named alike, the id tells them apart
+		bool mainThread = QCoreApplication::instance() &&
+						  QThread::currentThread() == QCoreApplication::instance()->thread();
+
+		std::lock_guard<std::mutex> lock(registryMutex);
+		buffer->threadId = buffers.size() + 1;
+		buffer->threadName = mainThread ? QString("Main") : QString("Worker %1").arg(buffer->threadId);
+
+		threadBuffer = buffer.get();
+		buffers.push_back(std::move(buffer));
+	}
+
+	return threadBuffer;
+}
+
+
+void TraceRecorder::Record(const char* name, const char* category, const qint64 &startUs, const qint64 &durationUs) {
+	if(!IsEnabled()) {
+		return;
+	}
+
+	ThreadBuffer* buffer = GetThreadBuffer();
+	std::lock_guard<std::mutex> lock(buffer->mutex);
+
+	Event &event = buffer->events[buffer->next];
+	event.name = name;
+	event.category = category;
+	event.startUs = startUs;
+	event.durationUs = durationUs;
+
+	buffer->next = (buffer->next + 1) % bufferSize;
+	++buffer->recorded;
+}
+
+
+const char* TraceRecorder::Intern(const std::string &name) {
+	std::lock_guard<std::mutex> lock(registryMutex);
+	return internedNames.insert(name).first->c_str();
+}
+
+
+void TraceRecorder::Clear() {
+	std::lock_guard<std::mutex> lock(registryMutex);
+
+	for(std::unique_ptr<ThreadBuffer> &buffer : buffers) {
+		std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+		buffer->next = 0;
+		buffer->recorded = 0;
+	}
+
+	processEvents.clear();
+	nextProcessEvent = 0;
+}
+
+
+void TraceRecorder::WriteEvents(std::ostream &output, const std::string &prefix) {
+	std::lock_guard<std::mutex> lock(registryMutex);
+
+	for(std::unique_ptr<ThreadBuffer> &buffer : buffers) {
+		std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+
+		size_t count = std::min(buffer->recorded, bufferSize);
+		size_t first = buffer->recorded > bufferSize ? buffer->next : 0;
+
+		// Starts on the steady clock rather than this recorder's, the name last as it can have spaces
+		for(size_t i=0; i<count; ++i) {
+			const Event &event = buffer->events[(first + i) % bufferSize];
+
+			output << prefix << event.startUs + EpochUs() << " " << event.durationUs << " "
+				   << buffer->threadId << " " << event.category << " " << event.name << "\n";
+		}
+	}
+
+	output.flush();
+}
+
+
+bool TraceRecorder::AddProcessEvent(const qint64 &processId, const QString &processName, const QString &line) {
+	bool startValid, durationValid, threadValid;
+
+	ProcessEvent event;
+	event.processId = processId;
+	event.processName = processName;
+	event.startUs = line.section(' ', 0, 0).toLongLong(&startValid) - EpochUs();
+	event.durationUs = line.section(' ', 1, 1).toLongLong(&durationValid);
+	event.threadId = line.section(' ', 2, 2).toInt(&threadValid);
+	event.category = line.section(' ', 3, 3);
+	event.name = line.section(' ', 4);
+
+	if(!startValid || !durationValid || !threadValid || event.name.isEmpty()) {
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(registryMutex);
+
+	// Grown as spans arrive rather than up front, then the oldest is overwritten
+	if(processEvents.size() < bufferSize) {
+		processEvents.push_back(event);
+	} else {
+		processEvents[nextProcessEvent] = event;
+	}
+
+	nextProcessEvent = (nextProcessEvent + 1) % bufferSize;
+	return true;
+}
+
+
+bool TraceRecorder::WriteChromeTrace(const QString &filePath) {
+	QJsonArray traceEvents;
+	qint64 processId = QCoreApplication::applicationPid();
+
+	{
+		std::lock_guard<std::mutex> lock(registryMutex);
+
+		for(std::unique_ptr<ThreadBuffer> &buffer : buffers) {
+			std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+
+			QJsonObject threadName;
+			threadName["name"] = "thread_name";
+			threadName["ph"] = "M";
+			threadName["pid"] = processId;
+			threadName["tid"] = buffer->threadId;
+			threadName["args"] = QJsonObject{{"name", buffer->threadName}};
+			traceEvents.append(threadName);
+
+			// Oldest first, once full the oldest is the next to be overwritten
+			size_t count = std::min(buffer->recorded, bufferSize);
+			size_t first = buffer->recorded > bufferSize ? buffer->next : 0;
+
+			for(size_t i=0; i<count; ++i) {
+				const Event &event = buffer->events[(first + i) % bufferSize];
+
+				QJsonObject object;
+				object["name"] = event.name;
+				object["cat"] = event.category;
+				object["ph"] = "X";
+				object["ts"] = event.startUs;
+				object["dur"] = event.durationUs;
+				object["pid"] = processId;
+				object["tid"] = buffer->threadId;
+				traceEvents.append(object);
+			}
+		}
+
+		// Other processes are shown apart by their own process id
+		std::set<qint64> namedProcesses;
+
+		// Oldest first, once full the oldest is the next to be overwritten
+		size_t firstProcessEvent = processEvents.size() < bufferSize ? 0 : nextProcessEvent;
+
+		for(size_t i=0; i<processEvents.size(); ++i) {
+			const ProcessEvent &event = processEvents[(firstProcessEvent + i) % bufferSize];
+
+			if(namedProcesses.insert(event.processId).second) {
+				QJsonObject processName;
+				processName["name"] = "process_name";
+				processName["ph"] = "M";
+				processName["pid"] = event.processId;
+				processName["args"] = QJsonObject{{"name", event.processName}};
+				traceEvents.append(processName);
+			}
+
+			QJsonObject object;
+			object["name"] = event.name;
+			object["cat"] = event.category;
+			object["ph"] = "X";
+			object["ts"] = event.startUs;
+			object["dur"] = event.durationUs;
+			object["pid"] = event.processId;
+			object["tid"] = event.threadId;
+			traceEvents.append(object);
+		}
+	}
+
+	QJsonObject root;
+	root["traceEvents"] = traceEvents;
+	root["displayTimeUnit"] = "ms";
+
+	QFile file(filePath);
+
+	return file.open(QIODevice::WriteOnly | QIODevice::Truncate) &&
+		   file.write(QJsonDocument(root).toJson(QJsonDocument::Compact)) != -1;
+}
+
+
+TraceSpan::TraceSpan(const char* spanName, const char* spanCategory) {
+	name = spanName;
+	category = spanCategory;
+	startUs = TraceRecorder::IsEnabled() ? TraceRecorder::NowUs() : -1;
+}
+
+
+TraceSpan::~TraceSpan() {
+	if(startUs >= 0) {
+		TraceRecorder::Record(name, category, startUs, TraceRecorder::NowUs() - startUs);
+	}
+}
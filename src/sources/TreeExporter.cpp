@@ -0,0 +1,291 @@
+#include "TreeExporter.h"
+
+// TreeVis
+#include "FullTreeBuilder.h"
+#include "Node.h"
+#include "Edge.h"
+
+// Qt
+#include <QFile>
+#include <QFileInfo>
+#include <QTextStream>
+#include <QPdfWriter>
+#include <QImage>
+#include <QFontMetricsF>
+#include <QtMath>
+
+#include <algorithm>
+#include <cmath>
+
+/// Resolution the PDF is drawn at, matching the screen so text fits the nodes
+const int pdfResolution = 96;
+
+
+TreeExporter::TreeExporter(const AgentPolicy &agentPolicy, const qreal &nodePadding) {
+	policy = agentPolicy;
+	layout = FullTreeBuilder::CreateLayout(policy, nodePadding);
+}
+
+
+TreeExporter::~TreeExporter() {
+	//std::cout << "~TreeExporter()" << std::endl;
+}
+
+
+QRectF TreeExporter::GetTreeRect() const {
+	return layout->GetSceneRect();
+}
+
+
+bool TreeExporter::GetPositionsInRange(const Index &depth, const qreal &left, const qreal &right,
+									   Index &first, Index &last) const {
+	// Inverse of TreeLayout::GetPosition() for x
+	qreal width = layout->GetSubtreeWidth(depth);
+	qreal offset = layout->GetSubtreeWidth(0)/2;
+	qreal lastOnLevel = layout->GetNrNodesAtDepth(depth) - 1;
+
+	qreal firstPosition = std::max((qreal) 0, std::floor((left + offset)/width - 0.5));
+	qreal lastPosition = std::min(lastOnLevel, std::ceil((right + offset)/width - 0.5));
+
+	if(lastPosition < firstPosition) {
+		return false;
+	}
+
+	first = (Index) firstPosition;
+	last = (Index) lastPosition;
+	return true;
+}
+
+
+void TreeExporter::ForEachItemInRegion(const QRectF &region,
+									   const std::function<void(const QPointF&, const QPointF&, const QString&)> &edgeFunction,
+									   const std::function<void(const QPointF&, const QString&)> &nodeFunction) const {
+	// Labels and node halves can reach up to a level outside of where they are positioned
+	qreal levelSeparation = layout->GetLevelSeparation();
+	QRectF expanded = region.adjusted(-levelSeparation, -levelSeparation, levelSeparation, levelSeparation);
+
+	Index first;
+	Index last;
+
+	for(Index depth=0; depth<layout->GetHorizon(); ++depth) {
+		qreal y = depth * levelSeparation;
+
+		// Edges to the level below. An edge can be at most half of
+		// its parents subtree away from the child horizontally
+		if(depth+1 < layout->GetHorizon() && y <= expanded.bottom() && y + levelSeparation >= expanded.top()) {
+			qreal reach = layout->GetSubtreeWidth(depth)/2;
+
+			if(GetPositionsInRange(depth+1, expanded.left() - reach, expanded.right() + reach, first, last)) {
+				Index firstOHIndex = layout->GetFirstOHIndexAtDepth(depth+1);
+
+				for(Index position=first; position<=last; ++position) {
+					Index ohIndex = firstOHIndex + position;
+
+					edgeFunction(layout->GetPosition(layout->GetParentOHIndex(ohIndex)),
+								 layout->GetPosition(ohIndex),
+								 policy.observationNames[layout->GetLastObservationIndex(ohIndex)]);
+				}
+			}
+		}
+
+		// Nodes on this level
+		if(y >= expanded.top() && y <= expanded.bottom() &&
+				GetPositionsInRange(depth, expanded.left(), expanded.right(), first, last)) {
+			Index firstOHIndex = layout->GetFirstOHIndexAtDepth(depth);
+
+			for(Index position=first; position<=last; ++position) {
+				Index ohIndex = firstOHIndex + position;
+				nodeFunction(layout->GetPosition(ohIndex), policy.GetActionName(ohIndex));
+			}
+		}
+	}
+}
+
+
+void TreeExporter::PaintRegion(QPainter* painter, const QRectF &region) const {
+	painter->setRenderHint(QPainter::Antialiasing);
+
+	ForEachItemInRegion(region,
+		[&](const QPointF &from, const QPointF &to, const QString &label) {
+			PaintEdge(painter, from, to, label);
+		},
+		[&](const QPointF &centre, const QString &action) {
+			PaintNode(painter, centre, action);
+		});
+}
+
+
+void TreeExporter::PaintEdge(QPainter* painter, const QPointF &from, const QPointF &to, const QString &label) {
+	QFont edgeFont = Edge::GetFont();
+	QFontMetricsF edgeFontMetrics = QFontMetricsF(edgeFont);
+
+	painter->setPen(QPen(Edge::GetDefaultColour(), edgeThickness));
+	painter->drawLine(from, to);
+
+	// Label placed as Edge places it, relative to the start of the line
+	painter->save();
+	painter->translate(from);
+	painter->setTransform(Edge::GetLabelTransform(QLineF(QPointF(0, 0), to - from),
+							  edgeFontMetrics.boundingRect(QRectF(), Qt::TextSingleLine, label).size()),
+						  true);
+
+	painter->setFont(edgeFont);
+	painter->setPen(Edge::GetDefaultTextColour());
+	painter->drawText(QPointF(0, edgeFontMetrics.ascent()), label);
+	painter->restore();
+}
+
+
+void TreeExporter::PaintNode(QPainter* painter, const QPointF &centre, const QString &text) {
+	painter->save();
+	painter->translate(centre);
+	Node::PaintDefault(painter, text);
+	painter->restore();
+}
+
+
+bool TreeExporter::ExportToSVG(const QString &filePath) const {
+	QFile file(filePath);
+
+	if(!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+		return false;
+	}
+
+	// Coordinates get large, avoid scientific notation
+	QTextStream stream(&file);
+	stream.setCodec("UTF-8");
+	stream.setRealNumberNotation(QTextStream::FixedNotation);
+	stream.setRealNumberPrecision(3);
+
+	QRectF rect = GetTreeRect();
+	QFont nodeFont = Node::GetFont();
+	QFont edgeFont = Edge::GetFont();
+	QFontMetricsF edgeFontMetrics = QFontMetricsF(edgeFont);
+
+	stream << "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"no\"?>\n"
+		   << "<svg xmlns=\"http://www.w3.org/2000/svg\" version=\"1.1\""
+		   << " width=\"" << rect.width() << "\" height=\"" << rect.height() << "\""
+		   << " viewBox=\"" << rect.left() << " " << rect.top() << " "
+		   << rect.width() << " " << rect.height() << "\">\n"
+		   << "<title>MADP TreeVis Output</title>\n";
+
+	// Styles shared by every item so each one is only its geometry and text
+	stream << "<style>\n"
+		   << ".n rect { fill: " << Node::GetDefaultFillColour().name()
+		   << "; stroke: " << Node::GetDefaultOutlineColour().name() << "; stroke-width: 2; }\n"
+		   << ".n text { fill: " << Node::GetDefaultTextColour().name()
+		   << "; font-family: '" << nodeFont.family() << "'; font-size: " << nodeFont.pointSizeF() << "pt;"
+		   << " text-anchor: middle; dominant-baseline: central; }\n"
+		   << ".e line { stroke: " << Edge::GetDefaultColour().name() << "; stroke-width: " << edgeThickness << "; }\n"
+		   << ".e text { fill: " << Edge::GetDefaultTextColour().name()
+		   << "; font-family: '" << edgeFont.family() << "'; font-size: " << edgeFont.pointSizeF() << "pt; }\n"
+		   << "</style>\n";
+
+	ForEachItemInRegion(rect,
+		[&](const QPointF &from, const QPointF &to, const QString &label) {
+			QTransform transform = Edge::GetLabelTransform(QLineF(QPointF(0, 0), to - from),
+									   edgeFontMetrics.boundingRect(QRectF(), Qt::TextSingleLine, label).size());
+			transform *= QTransform::fromTranslate(from.x(), from.y());
+
+			stream << "<g class=\"e\"><line x1=\"" << from.x() << "\" y1=\"" << from.y()
+				   << "\" x2=\"" << to.x() << "\" y2=\"" << to.y() << "\"/>"
+				   << "<text transform=\"matrix(" << transform.m11() << " " << transform.m12() << " "
+				   << transform.m21() << " " << transform.m22() << " "
+				   << transform.dx() << " " << transform.dy() << ")\" y=\"" << edgeFontMetrics.ascent() << "\">"
+				   << label.toHtmlEscaped() << "</text></g>\n";
+		},
+		[&](const QPointF &centre, const QString &action) {
+			QRectF outline = Node::OutlineRectForText(action);
+
+			// Same rounding as QPainter::drawRoundRect()
+			qreal xRadius = outline.width()/2 * Node::roundness/100;
+			qreal yRadius = outline.height()/2 * Node::roundness/100;
+
+			stream << "<g class=\"n\" transform=\"translate(" << centre.x() << " " << centre.y() << ")\">"
+				   << "<rect x=\"" << outline.left() << "\" y=\"" << outline.top()
+				   << "\" width=\"" << outline.width() << "\" height=\"" << outline.height()
+				   << "\" rx=\"" << xRadius << "\" ry=\"" << yRadius << "\"/>"
+				   << "<text>" << action.toHtmlEscaped() << "</text></g>\n";
+		});
+
+	stream << "</svg>\n";
+	stream.flush();
+
+	return stream.status() == QTextStream::Ok;
+}
+
+
+bool TreeExporter::ExportToPDF(const QString &filePath) const {
+	QRectF rect = GetTreeRect();
+
+	// Largest page in scene units at the resolution drawn at
+	qreal pageSide = maxPDFPageSize * pdfResolution / 72;
+	int columns = qCeil(rect.width() / pageSide);
+	int rows = qCeil(rect.height() / pageSide);
+
+	QPdfWriter writer(filePath);
+	writer.setTitle("MADP TreeVis Output");
+	writer.setResolution(pdfResolution);
+	writer.setPageMargins(QMarginsF(0, 0, 0, 0));
+
+	QPainter painter;
+
+	// Each page is only drawn once it is reached, so only one is held at a time
+	for(int row=0; row<rows; ++row) {
+		for(int column=0; column<columns; ++column) {
+			QRectF page = QRectF(rect.left() + column*pageSide, rect.top() + row*pageSide,
+								 pageSide, pageSide).intersected(rect);
+
+			writer.setPageSize(QPageSize(page.size() * 72 / pdfResolution, QPageSize::Point));
+
+			if(row == 0 && column == 0) {
+				if(!painter.begin(&writer)) {
+					return false;
+				}
+			} else {
+				writer.newPage();
+			}
+
+			painter.save();
+			painter.translate(-page.topLeft());
+			PaintRegion(&painter, page);
+			painter.restore();
+		}
+	}
+
+	return painter.end();
+}
+
+
+bool TreeExporter::ExportToTiledPNG(const QString &filePath, const int &tileSize) const {
+	QRectF rect = GetTreeRect();
+	int columns = qCeil(rect.width() / tileSize);
+	int rows = qCeil(rect.height() / tileSize);
+
+	// Tiles go next to the file path given, named by their row and column
+	QFileInfo fileInfo(filePath);
+	QString tileBase = fileInfo.path() + "/" + fileInfo.completeBaseName();
+
+	for(int row=0; row<rows; ++row) {
+		for(int column=0; column<columns; ++column) {
+			QRectF tile = QRectF(rect.left() + column*tileSize, rect.top() + row*tileSize,
+								 tileSize, tileSize).intersected(rect);
+
+			QImage image(qCeil(tile.width()), qCeil(tile.height()), QImage::Format_ARGB32);
+			image.fill(Qt::white);
+
+			QPainter painter(&image);
+			painter.translate(-tile.topLeft());
+			PaintRegion(&painter, tile);
+			painter.end();
+
+			QString tilePath = tileBase + "_r" + QString::number(row) + "_c" + QString::number(column) + ".png";
+
+			if(!image.save(tilePath, "PNG")) {
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
@@ -0,0 +1,141 @@
+#include "TreeLayout.h"
+
+#include <algorithm>
+
+
+TreeLayout::TreeLayout(const size_t &nrObs, const Index &hor, const qreal &slot, const qreal &separation) {
+	nrObservations = nrObs;
+	horizon = hor;
+	slotWidth = slot;
+	levelSeparation = separation;
+
+	// One extra entry so the end of the last level is known
+	firstOHIndexAtDepth = std::vector<Index>(horizon+1, 0);
+	leavesBelowDepth = std::vector<qreal>(horizon, 1);
+
+	Index nodesOnLevel = 1;
+
+	for(Index depth=1; depth<=horizon; ++depth) {
+		firstOHIndexAtDepth[depth] = firstOHIndexAtDepth[depth-1] + nodesOnLevel;
+		nodesOnLevel *= nrObservations;
+	}
+
+	// Work up from the leaves which only have themselves below
+	for(int depth=(int) horizon-2; depth>=0; --depth) {
+		leavesBelowDepth[depth] = leavesBelowDepth[depth+1] * nrObservations;
+	}
+}
+
+
+Index TreeLayout::GetDepth(const Index &ohIndex) const {
+	// Find the first level starting after the index, the one before contains it
+	std::vector<Index>::const_iterator it =
+			std::upper_bound(firstOHIndexAtDepth.begin(), firstOHIndexAtDepth.end(), ohIndex);
+
+	return (it - firstOHIndexAtDepth.begin()) - 1;
+}
+
+
+Index TreeLayout::GetFirstOHIndexAtDepth(const Index &depth) const {
+	return firstOHIndexAtDepth[depth];
+}
+
+
+Index TreeLayout::GetNrNodesAtDepth(const Index &depth) const {
+	return firstOHIndexAtDepth[depth+1] - firstOHIndexAtDepth[depth];
+}
+
+
+Index TreeLayout::GetChildOHIndex(const Index &ohIndex, const Index &observationIndex) const {
+	return (nrObservations * ohIndex) + observationIndex + 1;
+}
+
+
+Index TreeLayout::GetParentOHIndex(const Index &ohIndex) const {
+	return (ohIndex - 1) / nrObservations;
+}
+
+
+Index TreeLayout::GetLastObservationIndex(const Index &ohIndex) const {
+	return (ohIndex - 1) % nrObservations;
+}
+
+
+Index TreeLayout::GetOHIndex(const std::vector<Index> &observationIndexes) const {
+	Index ohIndex = 0;
+
+	for(const Index &observationIndex : observationIndexes) {
+		ohIndex = GetChildOHIndex(ohIndex, observationIndex);
+	}
+
+	return ohIndex;
+}
+
+
+std::vector<Index> TreeLayout::GetObservationIndexes(Index ohIndex) const {
+	std::vector<Index> observationIndexes;
+
+	// Walk up to the root, collecting the edges in reverse
+	while(ohIndex != 0) {
+		observationIndexes.push_back(GetLastObservationIndex(ohIndex));
+		ohIndex = GetParentOHIndex(ohIndex);
+	}
+
+	std::reverse(observationIndexes.begin(), observationIndexes.end());
+	return observationIndexes;
+}
+
+
+bool TreeLayout::IsLeaf(const Index &ohIndex) const {
+	return ohIndex >= firstOHIndexAtDepth[horizon-1];
+}
+
+
+QPointF TreeLayout::GetPosition(const Index &ohIndex) const {
+	Index depth = GetDepth(ohIndex);
+
+	// Position of the node along its level
+	qreal positionOnLevel = ohIndex - firstOHIndexAtDepth[depth];
+
+	// Centre over the leaves below, shift so the root is at x = 0
+	qreal x = (positionOnLevel + 0.5) * GetSubtreeWidth(depth) - GetSubtreeWidth(0)/2;
+	qreal y = depth * levelSeparation;
+
+	return QPointF(x, y);
+}
+
+
+qreal TreeLayout::GetSubtreeWidth(const Index &depth) const {
+	return leavesBelowDepth[depth] * slotWidth;
+}
+
+
+QRectF TreeLayout::GetSceneRect() const {
+	qreal width = GetSubtreeWidth(0);
+	return QRectF(-width/2, -levelSeparation/2, width, horizon * levelSeparation);
+}
+
+
+size_t TreeLayout::GetNrObservations() const {
+	return nrObservations;
+}
+
+
+Index TreeLayout::GetHorizon() const {
+	return horizon;
+}
+
+
+Index TreeLayout::GetNrOHIndexes() const {
+	return firstOHIndexAtDepth[horizon];
+}
+
+
+qreal TreeLayout::GetSlotWidth() const {
+	return slotWidth;
+}
+
+
+qreal TreeLayout::GetLevelSeparation() const {
+	return levelSeparation;
+}
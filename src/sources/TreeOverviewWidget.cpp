@@ -0,0 +1,202 @@
+#include "TreeOverviewWidget.h"
+
+// Qt
+#include <QPainter>
+#include <QMouseEvent>
+#include <QScrollBar>
+#include <QStyle>
+
+
+TreeOverviewWidget::TreeOverviewWidget(QGraphicsView* graphicsView) : QWidget(graphicsView) {
+	view = graphicsView;
+
+	setFixedSize(overviewSize, overviewSize);
+	setCursor(Qt::PointingHandCursor);
+	hide();
+
+	// Scrolling and zooming both move the scroll bars
+	for(QScrollBar* scrollBar : {view->horizontalScrollBar(), view->verticalScrollBar()}) {
+		connect(scrollBar, &QScrollBar::valueChanged, this, [this]() { update(); });
+		connect(scrollBar, &QScrollBar::rangeChanged, this, [this]() { update(); });
+	}
+
+	view->installEventFilter(this);
+}
+
+
+TreeOverviewWidget::~TreeOverviewWidget() {
+	//std::cout << "~TreeOverviewWidget()" << std::endl;
+}
+
+
+void TreeOverviewWidget::SetTree(const TreeLayout* treeLayout, TreeVisGraphicsScene* treeScene) {
+	if(scene) {
+		disconnect(scene, nullptr, this, nullptr);
+	}
+
+	layout = treeLayout;
+	scene = treeScene;
+
+	if(!layout || !scene) {
+		layout = nullptr;
+		scene = nullptr;
+		hide();
+		return;
+	}
+
+	// Stretched to fill, wide trees would otherwise be a thin strip
+	QRectF treeRect = layout->GetSceneRect();
+
+	sceneToOverview = QTransform();
+	sceneToOverview.scale(overviewSize / treeRect.width(), overviewSize / treeRect.height());
+	sceneToOverview.translate(-treeRect.left(), -treeRect.top());
+
+	DrawTreeImage();
+	DrawBuiltImage();
+
+	connect(scene, &TreeVisGraphicsScene::NodeAdded, this, &TreeOverviewWidget::NodeAdded);
+	connect(scene, &TreeVisGraphicsScene::NodeRemoved, this, &TreeOverviewWidget::NodeRemoved);
+
+	UpdatePosition();
+	show();
+	raise();
+	update();
+}
+
+
+void TreeOverviewWidget::DrawTreeImage() {
+	treeImage = QImage(size(), QImage::Format_ARGB32_Premultiplied);
+	treeImage.fill(QColor(255, 255, 255, 220));
+
+	QPainter painter(&treeImage);
+	QColor treeColour(170, 170, 170);
+	qreal horizontalScale = sceneToOverview.m11();
+
+	for(Index depth=0; depth<layout->GetHorizon(); ++depth) {
+		qreal nodeWidth = layout->GetSubtreeWidth(depth) * horizontalScale;
+		QPointF first = sceneToOverview.map(layout->GetPosition(layout->GetFirstOHIndexAtDepth(depth)));
+
+		// More nodes than pixels, every node exists in the layout so the level is a solid band
+		if(nodeWidth < builtNodeSize) {
+			QRectF treeRect = sceneToOverview.mapRect(layout->GetSceneRect());
+			painter.fillRect(QRectF(treeRect.left(), first.y() - 1, treeRect.width(), 2), treeColour);
+			continue;
+		}
+
+		// Few enough to draw each node and the edge to its parent
+		painter.setPen(treeColour);
+
+		for(Index i=0; i<layout->GetNrNodesAtDepth(depth); ++i) {
+			Index ohIndex = layout->GetFirstOHIndexAtDepth(depth) + i;
+			QPointF position = sceneToOverview.map(layout->GetPosition(ohIndex));
+
+			if(depth > 0) {
+				painter.drawLine(position, sceneToOverview.map(layout->GetPosition(layout->GetParentOHIndex(ohIndex))));
+			}
+
+			painter.fillRect(QRectF(position.x() - 1, position.y() - 1, 2, 2), treeColour);
+		}
+	}
+
+	painter.setPen(Qt::darkGray);
+	painter.drawRect(rect().adjusted(0, 0, -1, -1));
+}
+
+
+void TreeOverviewWidget::DrawBuiltImage() {
+	builtImage = QImage(size(), QImage::Format_ARGB32_Premultiplied);
+	builtImage.fill(Qt::transparent);
+
+	QPainter painter(&builtImage);
+
+	for(const Node* node : scene->GetNodes()) {
+		DrawBuiltNode(painter, node);
+	}
+
+	builtImageDirty = false;
+}
+
+
+void TreeOverviewWidget::DrawBuiltNode(QPainter &painter, const Node* node) {
+	QPointF position = sceneToOverview.map(node->pos());
+
+	painter.fillRect(QRectF(position.x() - builtNodeSize/2.0, position.y() - builtNodeSize/2.0,
+							builtNodeSize, builtNodeSize),
+					 Node::GetDefaultOutlineColour());
+}
+
+
+void TreeOverviewWidget::NodeAdded(Node* node) {
+	// Already being drawn again from scratch
+	if(builtImageDirty) {
+		return;
+	}
+
+	QPainter painter(&builtImage);
+	DrawBuiltNode(painter, node);
+	update();
+}
+
+
+void TreeOverviewWidget::NodeRemoved() {
+	// Collapsing removes many nodes at once, draw them all once when painting
+	builtImageDirty = true;
+	update();
+}
+
+
+void TreeOverviewWidget::paintEvent(QPaintEvent*) {
+	if(!layout) {
+		return;
+	}
+
+	if(builtImageDirty) {
+		DrawBuiltImage();
+	}
+
+	QPainter painter(this);
+	painter.drawImage(0, 0, treeImage);
+	painter.drawImage(0, 0, builtImage);
+
+	// Area currently shown in the view
+	QRectF shown = sceneToOverview.mapRect(view->mapToScene(view->viewport()->rect()).boundingRect());
+	painter.setPen(QPen(Qt::red, 1));
+	painter.setBrush(Qt::NoBrush);
+	painter.drawRect(shown.intersected(QRectF(rect()).adjusted(0, 0, -1, -1)));
+}
+
+
+void TreeOverviewWidget::mousePressEvent(QMouseEvent* event) {
+	if(event->button() == Qt::LeftButton) {
+		CentreViewOn(event->pos());
+	}
+}
+
+
+void TreeOverviewWidget::mouseMoveEvent(QMouseEvent* event) {
+	if(event->buttons() & Qt::LeftButton) {
+		CentreViewOn(event->pos());
+	}
+}
+
+
+void TreeOverviewWidget::CentreViewOn(const QPoint &point) {
+	// Parts of the tree not built yet are outside the scene rect, so the view stops at the edge
+	view->centerOn(sceneToOverview.inverted().map(QPointF(point)));
+}
+
+
+bool TreeOverviewWidget::eventFilter(QObject* watched, QEvent* event) {
+	if(watched == view && event->type() == QEvent::Resize) {
+		UpdatePosition();
+	}
+
+	return false;
+}
+
+
+void TreeOverviewWidget::UpdatePosition() {
+	// Leave room for the scroll bar so the overview never covers it
+	int scrollBarWidth = view->style()->pixelMetric(QStyle::PM_ScrollBarExtent);
+	move(view->width() - overviewSize - overviewMargin - scrollBarWidth, overviewMargin);
+}
@@ -3,6 +3,7 @@
 // Qt
 #include <QGraphicsSceneContextMenuEvent>
 #include <QColorDialog>
+#include <QPainter>
 #include <iostream>
 
 // TreeVis
@@ -16,6 +17,9 @@ TreeVisGraphicsScene::TreeVisGraphicsScene(QWidget* parent) : QGraphicsScene(par
 	itemColourPickMenu = new QMenu("Change Item Colour", parent);
 	textColourPickMenu = new QMenu("Change Text Colour", parent);
 	nodeOutlineColourPickMenu = new QMenu("Change Outline Colour", parent);
+	actionRuleColourPickMenu = new QMenu("Colour All With This Action", parent);
+	depthRuleColourPickMenu = new QMenu("Colour All At This Depth", parent);
+	observationRuleColourPickMenu = new QMenu("Colour All With This Observation", parent);
 
 	// Populate menus with colours, connect to appropritate slots
 	for(int i=0; i< ColourUtils::colourList.size(); ++i) {
@@ -27,6 +31,18 @@ TreeVisGraphicsScene::TreeVisGraphicsScene(QWidget* parent) : QGraphicsScene(par
 
 		QAction* nodeOutlineColourAction = nodeOutlineColourPickMenu->addAction(ColourUtils::colourList[i]);
 		connect(nodeOutlineColourAction, &QAction::triggered, this, [this, i] {ChangeNodeOutlineColour(i);});
+
+		QAction* actionRuleAction = actionRuleColourPickMenu->addAction(ColourUtils::colourList[i]);
+		connect(actionRuleAction, &QAction::triggered,
+				this, [this, i] {AddStyleRuleForSelection(StyleRule::NodesWithAction, i);});
+
+		QAction* depthRuleAction = depthRuleColourPickMenu->addAction(ColourUtils::colourList[i]);
+		connect(depthRuleAction, &QAction::triggered,
+				this, [this, i] {AddStyleRuleForSelection(StyleRule::NodesAtDepth, i);});
+
+		QAction* observationRuleAction = observationRuleColourPickMenu->addAction(ColourUtils::colourList[i]);
+		connect(observationRuleAction, &QAction::triggered,
+				this, [this, i] {AddStyleRuleForSelection(StyleRule::EdgesWithObservation, i);});
 	}
 
 	// Create actions
@@ -34,6 +50,9 @@ TreeVisGraphicsScene::TreeVisGraphicsScene(QWidget* parent) : QGraphicsScene(par
 	changeItemTextColourAction = new QAction("Change Text Colour", this);
 	changeNodeOutlineColourAction = new QAction("Change outline colour", this);
 	viewNodeOHAction = new QAction("View Observation History", this);
+	expandNodeAction = new QAction("Expand Subtree", this);
+	collapseNodeAction = new QAction("Collapse Subtree", this);
+	clearStyleRulesAction = new QAction("Clear Colour Rules", this);
 
 	// Connect to slots
 	connect(changeItemColourAction, &QAction::triggered,
@@ -47,6 +66,15 @@ TreeVisGraphicsScene::TreeVisGraphicsScene(QWidget* parent) : QGraphicsScene(par
 
 	connect(viewNodeOHAction, &QAction::triggered,
 			this, &TreeVisGraphicsScene::ViewNodeObservationHistory);
+
+	connect(expandNodeAction, &QAction::triggered,
+			this, &TreeVisGraphicsScene::ExpandSelectedNode);
+
+	connect(collapseNodeAction, &QAction::triggered,
+			this, &TreeVisGraphicsScene::CollapseSelectedNode);
+
+	connect(clearStyleRulesAction, &QAction::triggered,
+			this, &TreeVisGraphicsScene::ClearStyleRules);
 }
 
 
@@ -55,10 +83,250 @@ TreeVisGraphicsScene::~TreeVisGraphicsScene() {
 }
 
 
+void TreeVisGraphicsScene::AddNode(Node* node, const Index &timeStep) {
+	addItem(node);
+	node->SetTimeStep(timeStep);
+
+	NodeKey key(node->GetAgentIndex(), node->GetOHIndex());
+	nodes.insert(key, node);
+	nodesAtTimeStep[timeStep].insert(node);
+	nodesForAgent[node->GetAgentIndex()].insert(node);
+
+	// Keep the highlight if the node is built again after a collapse
+	if(key == highlightedNode) {
+		node->SetHighlighted(true);
+	}
+
+	for(const StyleRule &rule : styleRules) {
+		if(rule.Matches(node)) {
+			node->SetFillColour(rule.colour);
+		}
+	}
+
+	emit NodeAdded(node);
+}
+
+
+void TreeVisGraphicsScene::AddEdge(Edge* edge) {
+	addItem(edge);
+	edges.insert(edge);
+	edge->SetLineDrawnByScene(batchEdgeLines);
+
+	Node* to = edge->GetToNode();
+	edgesTo.insert(NodeKey(to->GetAgentIndex(), to->GetOHIndex()), edge);
+
+	for(const StyleRule &rule : styleRules) {
+		if(rule.Matches(edge)) {
+			edge->SetEdgeColour(rule.colour);
+		}
+	}
+}
+
+
+Node* TreeVisGraphicsScene::GetNode(const Index &agentIndex, const Index &ohIndex) const {
+	return nodes.value(NodeKey(agentIndex, ohIndex), nullptr);
+}
+
+
+void TreeVisGraphicsScene::RemoveNode(const Index &agentIndex, const Index &ohIndex) {
+	NodeKey key(agentIndex, ohIndex);
+
+	// Edges first as they refer to the node
+	for(Edge* edge : edgesTo.values(key)) {
+		edges.remove(edge);
+		delete edge;
+	}
+
+	edgesTo.remove(key);
+
+	Node* node = nodes.take(key);
+
+	if(node) {
+		nodesAtTimeStep[node->GetTimeStep()].remove(node);
+		nodesForAgent[node->GetAgentIndex()].remove(node);
+		emit NodeRemoved(node);
+		delete node;
+	}
+}
+
+
+const QHash<TreeVisGraphicsScene::NodeKey, Node*>& TreeVisGraphicsScene::GetNodes() const {
+	return nodes;
+}
+
+
+QSet<Node*> TreeVisGraphicsScene::GetNodesAtTimeStep(const Index &timeStep) const {
+	return nodesAtTimeStep.value(timeStep);
+}
+
+
+QSet<Node*> TreeVisGraphicsScene::GetNodesForAgent(const Index &agentIndex) const {
+	return nodesForAgent.value(agentIndex);
+}
+
+
+const QSet<Edge*>& TreeVisGraphicsScene::GetEdges() const {
+	return edges;
+}
+
+
+void TreeVisGraphicsScene::HighlightNode(const Index &agentIndex, const Index &ohIndex) {
+	// Looked up again as the old node may have been collapsed away
+	Node* previous = nodes.value(highlightedNode, nullptr);
+
+	if(previous) {
+		previous->SetHighlighted(false);
+	}
+
+	highlightedNode = NodeKey(agentIndex, ohIndex);
+	Node* node = GetNode(agentIndex, ohIndex);
+
+	if(node) {
+		node->SetHighlighted(true);
+	}
+}
+
+
+void TreeVisGraphicsScene::AddStyleRule(const StyleRule &rule) {
+	// Repainting everything first means the items changed below
+	// do not each work out the area they need repainting
+	update();
+
+	ApplyStyleRule(rule, rule.colour);
+	styleRules.push_back(rule);
+}
+
+
+void TreeVisGraphicsScene::ClearStyleRules() {
+	update();
+
+	for(const StyleRule &rule : styleRules) {
+		ApplyStyleRule(rule, QColor());
+	}
+
+	styleRules.clear();
+}
+
+
+const std::vector<StyleRule>& TreeVisGraphicsScene::GetStyleRules() const {
+	return styleRules;
+}
+
+
+void TreeVisGraphicsScene::ApplyStyleRule(const StyleRule &rule, const QColor &colour) {
+	switch(rule.type) {
+		// Only the nodes on the level
+		case StyleRule::NodesAtDepth:
+			for(Node* node : nodesAtTimeStep.value(rule.depth)) {
+				node->SetFillColour(colour);
+			}
+			break;
+
+		case StyleRule::NodesWithAction:
+			for(Node* node : nodes) {
+				if(rule.Matches(node)) {
+					node->SetFillColour(colour);
+				}
+			}
+			break;
+
+		case StyleRule::EdgesWithObservation:
+			for(Edge* edge : edges) {
+				if(rule.Matches(edge)) {
+					edge->SetEdgeColour(colour);
+				}
+			}
+			break;
+	}
+}
+
+
+void TreeVisGraphicsScene::SetBatchEdgeLines(const bool &batch) {
+	if(batch == batchEdgeLines) {
+		return;
+	}
+
+	batchEdgeLines = batch;
+
+	for(Edge* edge : edges) {
+		edge->SetLineDrawnByScene(batch);
+	}
+}
+
+
+void TreeVisGraphicsScene::drawBackground(QPainter* painter, const QRectF &rect) {
+	QGraphicsScene::drawBackground(painter, rect);
+
+	if(!batchEdgeLines) {
+		return;
+	}
+
+	// One line array per colour, so one draw call each
+	QHash<QRgb, QVector<QLineF>> linesByColour;
+
+	for(QGraphicsItem* item : items(rect, Qt::IntersectsItemBoundingRect, Qt::AscendingOrder)) {
+		if(item->type() == Edge::Type) {
+			Edge* edge = static_cast<Edge*>(item);
+			linesByColour[edge->GetPen().color().rgba()].append(edge->line().translated(edge->pos()));
+		}
+	}
+
+	for(QHash<QRgb, QVector<QLineF>>::const_iterator it = linesByColour.constBegin();
+		it != linesByColour.constEnd(); ++it) {
+
+		painter->setPen(QPen(QColor::fromRgba(it.key()), edgeThickness));
+		painter->drawLines(it.value());
+	}
+}
+
+
+void TreeVisGraphicsScene::Clear() {
+	nodes.clear();
+	nodesAtTimeStep.clear();
+	nodesForAgent.clear();
+	edges.clear();
+	edgesTo.clear();
+	highlightedNode = NodeKey(-1, -1);
+	clear();
+}
+
+
+void TreeVisGraphicsScene::RefreshItemStyles(const bool &fontChanged, const bool &placeEdges) {
+	// Nodes and edge labels only change size with the font
+	if(fontChanged) {
+		if(placeEdges) {
+			for(Edge* edge : edges) {
+				edge->RefreshStyle();
+			}
+		}
+
+		for(Node* node : nodes) {
+			node->RefreshStyle();
+		}
+	}
+
+	// Nodes read the default colours when painted
+	update();
+}
+
+
 void TreeVisGraphicsScene::contextMenuEvent(QGraphicsSceneContextMenuEvent* event) {
-	// Try extract an item
-	selectedNode = qgraphicsitem_cast<Node*>(itemAt(event->scenePos(), QTransform()));
-	selectedEdge = qgraphicsitem_cast<Edge*>(itemAt(event->scenePos(), QTransform()));
+	selectedNode = nullptr;
+	selectedEdge = nullptr;
+
+	// One hit test, the top most item. Edge labels are part of the edge shape
+	QGraphicsItem* item = itemAt(event->scenePos(), QTransform());
+
+	if(item) {
+		switch(item->type()) {
+			case Node::Type:
+				selectedNode = static_cast<Node*>(item);
+				break;
+			case Edge::Type:
+				selectedEdge = static_cast<Edge*>(item);
+				break;
+		}
+	}
 
 	// Create menu, add global actions
 	QMenu menu;
@@ -70,11 +338,31 @@ void TreeVisGraphicsScene::contextMenuEvent(QGraphicsSceneContextMenuEvent* even
 		menu.addMenu(nodeOutlineColourPickMenu);
 		menu.addAction(viewNodeOHAction);
 
+		// Only offer to expand or collapse if the node has children in the policy
+		if(selectedNode->IsExpandable()) {
+			menu.addAction(selectedNode->IsExpanded() ? collapseNodeAction : expandNodeAction);
+		}
+
+		menu.addSeparator();
+		menu.addMenu(actionRuleColourPickMenu);
+		menu.addMenu(depthRuleColourPickMenu);
+
+		if(!styleRules.empty()) {
+			menu.addAction(clearStyleRulesAction);
+		}
+
 		// Display menu
 		menu.exec(event->screenPos());
 	} else if(selectedEdge) {
 
 		// Otherwise edge was selected
+		menu.addSeparator();
+		menu.addMenu(observationRuleColourPickMenu);
+
+		if(!styleRules.empty()) {
+			menu.addAction(clearStyleRulesAction);
+		}
+
 		menu.exec(event->screenPos());
 	}
 
@@ -127,3 +415,37 @@ void TreeVisGraphicsScene::ChangeNodeOutlineColour(const int &id) {
 void TreeVisGraphicsScene::ViewNodeObservationHistory() {
 	emit DisplayObservationHistoryForNode(selectedNode);
 }
+
+
+void TreeVisGraphicsScene::ExpandSelectedNode() {
+	emit ExpandNode(selectedNode);
+}
+
+
+void TreeVisGraphicsScene::CollapseSelectedNode() {
+	emit CollapseNode(selectedNode);
+}
+
+
+void TreeVisGraphicsScene::AddStyleRuleForSelection(const StyleRule::target &type, const int &id) {
+	QColor selectedColour = ColourUtils::GetColourFromID(id);
+
+	// In case of colour dialog closing
+	if(selectedColour == QColor::Invalid) {
+		return;
+	}
+
+	StyleRule rule;
+	rule.type = type;
+	rule.colour = selectedColour;
+
+	if(type == StyleRule::EdgesWithObservation) {
+		rule.text = selectedEdge->GetLabelText();
+	} else if(type == StyleRule::NodesAtDepth) {
+		rule.depth = selectedNode->GetTimeStep();
+	} else {
+		rule.text = selectedNode->GetText();
+	}
+
+	AddStyleRule(rule);
+}
@@ -10,15 +10,32 @@
 #include <QFileDialog>
 #include <QWheelEvent>
 #include <QtMath>
+#include <QOpenGLWidget>
+#include <QSurfaceFormat>
+#include <QElapsedTimer>
 #include "qgraphicsitem.h"
 
 // MADP
 #include "Observation.h"
 
+TreeVisGraphicsView::viewportType TreeVisGraphicsView::viewport = TreeVisGraphicsView::RasterViewport;
+bool TreeVisGraphicsView::adaptiveAntialiasing = true;
+bool TreeVisGraphicsView::showFrameStatistics = false;
+
+
 TreeVisGraphicsView::TreeVisGraphicsView(PlannerManager* man, QWidget* parent) : QGraphicsView(parent) {
 	pManager = man;
-	setRenderHint(QPainter::Antialiasing);
 	setDragMode(QGraphicsView::ScrollHandDrag);
+
+	interactionTimer = new QTimer(this);
+	interactionTimer->setSingleShot(true);
+	interactionTimer->setInterval(interactionSettleTime);
+	connect(interactionTimer, &QTimer::timeout, this, &TreeVisGraphicsView::InteractionFinished);
+
+	// Hidden until the settings say otherwise, they are read before any view is created
+	frameStatsOverlay = new FrameStatsOverlay(this);
+
+	ApplyViewportSettings();
 }
 
 
@@ -48,6 +65,126 @@ void TreeVisGraphicsView::Reset() {
 void TreeVisGraphicsView::ChangeScene(QGraphicsScene* newScene) {
 	resetMatrix();
 	setScene(newScene);
+	UpdateSceneEdgeBatching();
+
+	// Frames of the old scene say nothing about the new one
+	frameStatsOverlay->ClearFrames();
+}
+
+
+void TreeVisGraphicsView::ApplyViewportSettings() {
+	bool openGL = viewport != RasterViewport;
+
+	// The view deletes the old viewport when given a new one
+	if(openGL != usingOpenGL) {
+		if(openGL) {
+			QOpenGLWidget* glWidget = new QOpenGLWidget();
+
+			// Multisampling for antialiasing on the GPU
+			QSurfaceFormat format;
+			format.setSamples(4);
+			glWidget->setFormat(format);
+
+			setViewport(glWidget);
+		} else {
+			setViewport(new QWidget());
+		}
+
+		usingOpenGL = openGL;
+	}
+
+	// OpenGL viewports redraw everything each frame, tracking regions is wasted
+	setViewportUpdateMode(usingOpenGL ? QGraphicsView::FullViewportUpdate
+									  : QGraphicsView::MinimalViewportUpdate);
+
+	interactionTimer->stop();
+	setRenderHint(QPainter::Antialiasing, true);
+	UpdateSceneEdgeBatching();
+
+	// Frames drawn through the old viewport are not comparable
+	frameStatsOverlay->ClearFrames();
+	frameStatsOverlay->setVisible(showFrameStatistics);
+	frameStatsOverlay->raise();
+}
+
+
+void TreeVisGraphicsView::UpdateSceneEdgeBatching() {
+	TreeVisGraphicsScene* treeScene = qobject_cast<TreeVisGraphicsScene*>(scene());
+
+	if(treeScene) {
+		treeScene->SetBatchEdgeLines(usingOpenGL);
+	}
+}
+
+
+void TreeVisGraphicsView::SetViewportType(const viewportType &type) {
+	viewport = type;
+}
+
+
+TreeVisGraphicsView::viewportType TreeVisGraphicsView::GetViewportType() {
+	return viewport;
+}
+
+
+void TreeVisGraphicsView::SetAdaptiveAntialiasing(const bool &adaptive) {
+	adaptiveAntialiasing = adaptive;
+}
+
+
+bool TreeVisGraphicsView::GetAdaptiveAntialiasing() {
+	return adaptiveAntialiasing;
+}
+
+
+void TreeVisGraphicsView::SetShowFrameStatistics(const bool &show) {
+	showFrameStatistics = show;
+}
+
+
+bool TreeVisGraphicsView::GetShowFrameStatistics() {
+	return showFrameStatistics;
+}
+
+
+void TreeVisGraphicsView::InteractionStarted() {
+	if(!adaptiveAntialiasing) {
+		return;
+	}
+
+	if(renderHints() & QPainter::Antialiasing) {
+		setRenderHint(QPainter::Antialiasing, false);
+	}
+
+	interactionTimer->start();
+}
+
+
+void TreeVisGraphicsView::InteractionFinished() {
+	// Redraws the view smoothed now it has stopped
+	setRenderHint(QPainter::Antialiasing, true);
+}
+
+
+void TreeVisGraphicsView::scrollContentsBy(int dx, int dy) {
+	InteractionStarted();
+	QGraphicsView::scrollContentsBy(dx, dy);
+}
+
+
+void TreeVisGraphicsView::paintEvent(QPaintEvent* event) {
+	if(!frameStatsOverlay->isVisible()) {
+		QGraphicsView::paintEvent(event);
+		return;
+	}
+
+	// With OpenGL this is the time to record the frame, the GPU draws it afterwards
+	QElapsedTimer timer;
+	timer.start();
+
+	QGraphicsView::paintEvent(event);
+
+	frameStatsOverlay->AddFrame(timer.nsecsElapsed() / 1e6);
 }
 
 
@@ -97,8 +234,11 @@ void TreeVisGraphicsView::wheelEvent(QWheelEvent* event) {
 		return;
 	}
 
-	// Control key must be presed - prevent zoom with no items
-	if(scene() && scene()->items().count() > 0) {
+	// Control key must be presed - prevent zoom with no items.
+	// The scene rect grows with the items so this avoids listing them
+	if(scene() && !scene()->sceneRect().isEmpty()) {
+
+		InteractionStarted();
 
 		// If we scrolled forwards zoom in
 		if(event->delta() > 0) {